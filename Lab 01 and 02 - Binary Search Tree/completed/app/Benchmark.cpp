@@ -0,0 +1,382 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: Times lookups of computer scientists by ID in each kind of
+// pointer tree, and in the CompactTree whose nodes are linked by
+// indices, with IDs drawn uniformly and from a Zipf distribution,
+// where the k-th most popular ID is looked up in proportion to 1 / k^s.
+// Then times looking up the computer scientists by name, in a tree
+// keyed by std::string, with names parsed out of a buffer as
+// std::string_view tokens: copying each into a std::string to search
+// for, and searching for the token itself. The names are timed as
+// "last, first", most of which are short enough for a std::string to
+// hold without allocating, and as "Prof. first last, PhD", none of
+// which are. Then times rebuilding the plain tree, by inserting every ID
+// again and by reading it back from a serialized copy in memory. Last,
+// times purging a tenth of the IDs, a contiguous range, from each, and
+// merging in a delta of new and existing IDs.
+//
+// The records of csList.txt are reused to fill out as many IDs as asked
+// for, so that the tree is deep enough for the shape to matter.
+//
+// Usage: bst_bench [number of IDs] [number of lookups] [Zipf exponent s]
+//
+// Without an exponent, s = 1, 1.25 and 1.5 are each timed. The larger s
+// is, the more the lookups go to the few most popular IDs, and the more
+// the splay tree gains from keeping those near the root.
+///
+
+#include "AVLTree.h"
+#include "BSTree.h"
+#include "CompactTree.h"
+#include "ComputerScientist.h"
+#include "SplayTree.h"
+#include "Treap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Loads the computer scientists from a file of lines of the form
+ * ID,first name,last name,speciality
+ */
+std::vector<std::unique_ptr<ComputerScientist>>
+load(const std::string& filename)
+{
+    std::vector<std::unique_ptr<ComputerScientist>> list;
+    std::ifstream file(filename);
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::stringstream ss(line);
+        std::string id;
+        std::string first;
+        std::string last;
+        std::string speciality;
+        std::getline(ss, id, ',');
+        std::getline(ss, first, ',');
+        std::getline(ss, last, ',');
+        std::getline(ss, speciality, ',');
+        list.push_back(std::make_unique<ComputerScientist>(
+            first, last, speciality, std::stoi(id)));
+    }
+    return list;
+}
+
+/*
+ * Returns numQueries IDs from 1 to numIds, the k-th most popular of them
+ * drawn with probability proportional to 1 / k^exponent. Which IDs are
+ * popular is chosen at random.
+ */
+std::vector<int> zipfQueries(int numIds, int numQueries, double exponent,
+                             std::mt19937& rng)
+{
+    std::vector<double> cumulative(numIds);
+    double total = 0;
+    for (int k = 0; k < numIds; k++)
+    {
+        total += 1.0 / std::pow(k + 1, exponent);
+        cumulative[k] = total;
+    }
+
+    std::vector<int> byPopularity(numIds);
+    std::iota(byPopularity.begin(), byPopularity.end(), 1);
+    std::shuffle(byPopularity.begin(), byPopularity.end(), rng);
+
+    std::uniform_real_distribution<double> dist(0, total);
+    std::vector<int> queries(numQueries);
+    for (int& query : queries)
+    {
+        auto k = std::lower_bound(cumulative.begin(), cumulative.end(),
+                                  dist(rng)) -
+                 cumulative.begin();
+        query = byPopularity[std::min<long>(k, numIds - 1)];
+    }
+    return queries;
+}
+
+/*
+ * Calls purge() once and prints how long it took.
+ */
+template <typename Purge>
+void timePurge(const std::string& name, Purge purge)
+{
+    auto start = std::chrono::steady_clock::now();
+    purge();
+    auto stop = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = stop - start;
+
+    std::cout << "  " << std::left << std::setw(20) << name << std::right
+              << std::setw(8) << std::fixed << std::setprecision(1)
+              << elapsed.count() << " ms\n";
+}
+
+/*
+ * Calls lookup(query) for every query, and prints the average time per
+ * lookup along with the number found (which also keeps the lookups from
+ * being optimized away).
+ */
+template <typename Query, typename Lookup>
+void timeLookups(const std::string& name,
+                 const std::vector<Query>& queries, Lookup lookup)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    long found = 0;
+    for (const Query& query : queries)
+    {
+        found += lookup(query);
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> elapsed = stop - start;
+
+    std::cout << "  " << std::left << std::setw(20) << name << std::right
+              << std::setw(8) << std::fixed << std::setprecision(1)
+              << elapsed.count() / queries.size() << " ns/lookup  ("
+              << found << " found)\n";
+}
+
+/*
+ * Fills a tree keyed by std::string with the name makeName(cs) of every
+ * computer scientist, and times numQueries lookups of random names taken
+ * as std::string_view tokens of one text buffer: copying each into a
+ * std::string, and searching for the token itself
+ */
+template <typename MakeName>
+void timeNames(const std::string& title,
+               const std::vector<std::unique_ptr<ComputerScientist>>& list,
+               MakeName makeName, int numQueries, std::mt19937& rng)
+{
+    // The list is sorted by name, so it is inserted in random order
+    std::vector<ComputerScientist*> byName;
+    for (const auto& cs : list)
+    {
+        byName.push_back(cs.get());
+    }
+    std::shuffle(byName.begin(), byName.end(), rng);
+
+    BinarySearchTree<std::string, ComputerScientist*> nameTree;
+    std::string text;
+    int longNames = 0;
+    for (ComputerScientist* cs : byName)
+    {
+        std::string name = makeName(cs);
+        nameTree.insert(cs, name);
+        text += name + "\n";
+
+        // Longer than std::string holds without allocating, in the
+        // common standard libraries
+        longNames += name.size() > 15;
+    }
+    std::vector<std::string_view> tokens;
+    for (std::size_t pos = 0; pos < text.size();)
+    {
+        std::size_t end = text.find('\n', pos);
+        tokens.emplace_back(text.data() + pos, end - pos);
+        pos = end + 1;
+    }
+    std::vector<std::string_view> names(numQueries);
+    std::uniform_int_distribution<std::size_t> nameDist(0,
+                                                        tokens.size() - 1);
+    for (std::string_view& name : names)
+    {
+        name = tokens[nameDist(rng)];
+    }
+
+    std::cout << "\nNames as " << title << " (" << longNames << " of "
+              << tokens.size() << " longer than 15 characters):\n";
+    timeLookups("find(std::string)", names, [&](std::string_view name) {
+        return nameTree.find(std::string(name)) != nullptr;
+    });
+    timeLookups("find(string_view)", names, [&](std::string_view name) {
+        return nameTree.find(name) != nullptr;
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    int numIds = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+    int numQueries = (argc > 2) ? std::atoi(argv[2]) : 1000000;
+    std::vector<double> exponents = {1.0, 1.25, 1.5};
+    if (argc > 3)
+    {
+        exponents = {std::atof(argv[3])};
+    }
+
+    auto list = load("csList.txt");
+    if (list.empty())
+    {
+        std::cerr << "Could not load csList.txt\n";
+        return 1;
+    }
+
+    // Insert in random order, which the plain tree needs to stay
+    // shallow
+    std::mt19937 rng{42};
+    std::vector<int> ids(numIds);
+    std::iota(ids.begin(), ids.end(), 1);
+    std::shuffle(ids.begin(), ids.end(), rng);
+
+    BinarySearchTree<int, ComputerScientist*> plainTree;
+    AVLTree<int, ComputerScientist*> avlTree;
+    SplayTree<int, ComputerScientist*> splayTree;
+    Treap<int, ComputerScientist*> treap;
+    CompactTree<int, ComputerScientist*> compactTree;
+    for (int id : ids)
+    {
+        ComputerScientist* cs = list[id % list.size()].get();
+        plainTree.insert(cs, id);
+        compactTree.insert(cs, id);
+        avlTree.insert(cs, id);
+        splayTree.insert(cs, id);
+        treap.insert(cs, id);
+    }
+
+    // Look up IDs which exist about 90% of the time
+    std::uniform_int_distribution<int> uniformDist(1, numIds + numIds / 9);
+    std::vector<int> uniform(numQueries);
+    for (int& query : uniform)
+    {
+        query = uniformDist(rng);
+    }
+
+    std::cout << numIds << " IDs from " << list.size()
+              << " computer scientists, " << numQueries << " lookups\n";
+
+    std::cout << "\nUniform IDs:\n";
+    timeLookups("BinarySearchTree", uniform,
+                [&](int id) { return plainTree.contains(id); });
+    timeLookups("CompactTree", uniform,
+                [&](int id) { return compactTree.contains(id); });
+    timeLookups("AVLTree", uniform,
+                [&](int id) { return avlTree.contains(id); });
+    timeLookups("SplayTree", uniform,
+                [&](int id) { return splayTree.contains(id); });
+
+    for (double exponent : exponents)
+    {
+        std::vector<int> zipf =
+            zipfQueries(numIds, numQueries, exponent, rng);
+
+        std::cout << "\nZipf IDs (s = " << std::setprecision(2)
+                  << exponent << "):\n";
+        timeLookups("BinarySearchTree", zipf,
+                    [&](int id) { return plainTree.contains(id); });
+        timeLookups("CompactTree", zipf,
+                    [&](int id) { return compactTree.contains(id); });
+        timeLookups("AVLTree", zipf,
+                    [&](int id) { return avlTree.contains(id); });
+        timeLookups("SplayTree", zipf,
+                    [&](int id) { return splayTree.contains(id); });
+    }
+
+    // Names looked up from tokens of a text buffer. Copying a token
+    // into a std::string allocates only for the long names.
+    timeNames(
+        "\"last, first\"", list,
+        [](ComputerScientist* cs) {
+            return cs->getLastName() + ", " + cs->getFirstName();
+        },
+        numQueries, rng);
+    timeNames(
+        "\"Prof. first last, PhD\"", list,
+        [](ComputerScientist* cs) {
+            return "Prof. " + cs->getFirstName() + " " +
+                   cs->getLastName() + ", PhD";
+        },
+        numQueries, rng);
+
+    // Pointer values are written as the ID of the computer scientist,
+    // which is its line in csList.txt
+    std::stringstream saved;
+    auto writeId = [](std::ostream& out, ComputerScientist* cs) {
+        int id = cs->getID();
+        out.write(reinterpret_cast<const char*>(&id), sizeof id);
+    };
+    auto readId = [&](std::istream& in) {
+        int id = 1;
+        in.read(reinterpret_cast<char*>(&id), sizeof id);
+        return list[(id - 1) % list.size()].get();
+    };
+    auto readKey = [](std::istream& in) {
+        int key = 0;
+        in.read(reinterpret_cast<char*>(&key), sizeof key);
+        return key;
+    };
+
+    std::cout << "\nRebuilding the BinarySearchTree:\n";
+    timePurge("insert every ID", [&] {
+        BinarySearchTree<int, ComputerScientist*> rebuilt;
+        for (int id : ids)
+        {
+            rebuilt.insert(list[id % list.size()].get(), id);
+        }
+    });
+    timePurge("serialize", [&] {
+        plainTree.serialize(saved, [](std::ostream& out, int key) {
+            out.write(reinterpret_cast<const char*>(&key), sizeof key);
+        }, writeId);
+    });
+    timePurge("deserialize", [&] {
+        BinarySearchTree<int, ComputerScientist*> rebuilt;
+        rebuilt.deserialize(saved, readKey, readId);
+    });
+
+    // The other trees remove one ID at a time, each from the root
+    int lo = numIds / 2;
+    int hi = lo + numIds / 10 - 1;
+    std::cout << "\nPurging IDs " << lo << "-" << hi << ":\n";
+    timePurge("BinarySearchTree", [&] {
+        for (int id = lo; id <= hi; id++)
+        {
+            plainTree.remove(id);
+        }
+    });
+    timePurge("AVLTree", [&] {
+        for (int id = lo; id <= hi; id++)
+        {
+            avlTree.remove(id);
+        }
+    });
+    timePurge("Treap::removeRange", [&] { treap.removeRange(lo, hi); });
+
+    // A delta of a tenth as many IDs, half of them new
+    std::vector<int> delta(numIds / 10);
+    std::uniform_int_distribution<int> deltaDist(1, 2 * numIds);
+    for (int& id : delta)
+    {
+        id = deltaDist(rng);
+    }
+    Treap<int, ComputerScientist*> deltaTreap;
+    for (int id : delta)
+    {
+        deltaTreap.insert(list[id % list.size()].get(), id);
+    }
+
+    std::cout << "\nMerging " << delta.size() << " IDs:\n";
+    timePurge("BinarySearchTree", [&] {
+        for (int id : delta)
+        {
+            plainTree.insert(list[id % list.size()].get(), id);
+        }
+    });
+    timePurge("Treap::unionWith", [&] { treap.unionWith(deltaTreap); });
+
+    return 0;
+}
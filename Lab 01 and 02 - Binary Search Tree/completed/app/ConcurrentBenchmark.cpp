@@ -0,0 +1,259 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: Times threads sharing one tree of computer scientists by
+// ID: the AVLTree behind a single reader-writer lock, and the
+// ConcurrentTree, whose lookups take no lock.
+//
+// First the threads fill an empty tree with the IDs in order, as they
+// are handed out, each thread taking the next ID from a shared counter.
+// Then, in a tree holding every other ID, they run several mixes of
+// lookups and changes. Each thread does an equal share of the
+// operations. A change inserts or removes (equally often) a random ID
+// from twice the range the tree starts with, so the tree stays about
+// the same size.
+//
+// Usage: bst_concurrent_bench [number of IDs] [number of operations]
+//                             [most threads]
+///
+
+#include "AVLTree.h"
+#include "ComputerScientist.h"
+#include "ConcurrentTree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Loads the computer scientists from a file of lines of the form
+ * ID,first name,last name,speciality
+ */
+std::vector<std::unique_ptr<ComputerScientist>>
+load(const std::string& filename)
+{
+    std::vector<std::unique_ptr<ComputerScientist>> list;
+    std::ifstream file(filename);
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::stringstream ss(line);
+        std::string id;
+        std::string first;
+        std::string last;
+        std::string speciality;
+        std::getline(ss, id, ',');
+        std::getline(ss, first, ',');
+        std::getline(ss, last, ',');
+        std::getline(ss, speciality, ',');
+        list.push_back(std::make_unique<ComputerScientist>(
+            first, last, speciality, std::stoi(id)));
+    }
+    return list;
+}
+
+/*
+ * An AVLTree, with a lock which lookups share and changes hold alone
+ */
+class LockedTree
+{
+  private:
+    AVLTree<int, ComputerScientist*> tree;
+    mutable std::shared_mutex mutex;
+
+  public:
+    bool contains(int id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return tree.contains(id);
+    }
+
+    bool insert(ComputerScientist* cs, int id)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        return tree.insert(cs, id);
+    }
+
+    void remove(int id)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        tree.remove(id);
+    }
+};
+
+/*
+ * Prints the rate of operations done by the threads in the time taken
+ */
+void printRate(const std::string& name, int numThreads, long numOps,
+               std::chrono::duration<double> elapsed, long found)
+{
+    double opsPerSecond = numOps / elapsed.count();
+    std::cout << "  " << std::left << std::setw(16) << name << std::right
+              << std::setw(3) << numThreads << " threads "
+              << std::setw(8) << std::fixed << std::setprecision(2)
+              << opsPerSecond / 1e6 << " Mops/s  (" << found
+              << " found)\n";
+}
+
+/*
+ * Inserts the IDs 1 to numIds into an empty tree, in order, with
+ * numThreads threads taking the next ID from a shared counter, and
+ * prints the inserts per second and the number of IDs then found
+ */
+template <typename Tree>
+void timeIngest(
+    const std::string& name,
+    const std::vector<std::unique_ptr<ComputerScientist>>& list,
+    int numIds, int numThreads)
+{
+    Tree tree;
+    std::atomic<int> nextId{1};
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.emplace_back([&] {
+            for (int id = nextId++; id <= numIds; id = nextId++)
+            {
+                tree.insert(list[id % list.size()].get(), id);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    long found = 0;
+    for (int id = 1; id <= numIds; id++)
+    {
+        found += tree.contains(id);
+    }
+    printRate(name, numThreads, numIds, stop - start, found);
+}
+
+/*
+ * Fills the tree, runs numOps operations spread over numThreads threads,
+ * changePercent of them changes, and prints the operations per second
+ */
+template <typename Tree>
+void timeMix(const std::string& name, const std::vector<int>& ids,
+             const std::vector<std::unique_ptr<ComputerScientist>>& list,
+             int numOps, int numThreads, int changePercent)
+{
+    Tree tree;
+    for (int id : ids)
+    {
+        tree.insert(list[id % list.size()].get(), id);
+    }
+
+    int numIds = static_cast<int>(ids.size());
+    int opsPerThread = numOps / numThreads;
+    std::vector<std::thread> threads;
+    std::vector<long> found(numThreads);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(t + 1);
+            std::uniform_int_distribution<int> idDist(1, 2 * numIds);
+            std::uniform_int_distribution<int> opDist(0, 199);
+            for (int i = 0; i < opsPerThread; i++)
+            {
+                int id = idDist(rng);
+                int op = opDist(rng);
+                if (op >= 2 * changePercent)
+                {
+                    found[t] += tree.contains(id);
+                }
+                else if (op % 2 == 0)
+                {
+                    tree.insert(list[id % list.size()].get(), id);
+                }
+                else
+                {
+                    tree.remove(id);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    long totalFound = std::accumulate(found.begin(), found.end(), 0L);
+    printRate(name, numThreads,
+              static_cast<long>(opsPerThread) * numThreads, stop - start,
+              totalFound);
+}
+
+int main(int argc, char* argv[])
+{
+    int numIds = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+    int numOps = (argc > 2) ? std::atoi(argv[2]) : 4000000;
+    int maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (argc > 3)
+    {
+        maxThreads = std::atoi(argv[3]);
+    }
+    maxThreads = std::max(maxThreads, 1);
+
+    auto list = load("csList.txt");
+    if (list.empty())
+    {
+        std::cerr << "Could not load csList.txt\n";
+        return 1;
+    }
+
+    // Every other ID, in order
+    std::vector<int> ids(numIds);
+    for (int i = 0; i < numIds; i++)
+    {
+        ids[i] = 2 * i + 1;
+    }
+
+    std::cout << numIds << " IDs, " << numOps << " operations\n";
+    std::cout << "\nInserting IDs in order:\n";
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        timeIngest<LockedTree>("locked AVLTree", list, numIds, threads);
+        timeIngest<ConcurrentTree<int, ComputerScientist*>>(
+            "ConcurrentTree", list, numIds, threads);
+    }
+
+    for (int changePercent : {0, 10, 50})
+    {
+        std::cout << "\n" << changePercent << "% changes:\n";
+        for (int threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            timeMix<LockedTree>("locked AVLTree", ids, list, numOps,
+                                threads, changePercent);
+            timeMix<ConcurrentTree<int, ComputerScientist*>>(
+                "ConcurrentTree", ids, list, numOps, threads,
+                changePercent);
+        }
+    }
+
+    return 0;
+}
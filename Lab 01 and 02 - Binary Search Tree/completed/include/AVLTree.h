@@ -0,0 +1,452 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A self-balancing (AVL) binary search tree.
+//
+// The plain BinarySearchTree takes keys in whatever shape they arrive,
+// so keys inserted in sorted order make it a linked list, with O(n)
+// searches and recursion n levels deep. This tree keeps the heights of
+// the two subtrees of every node within one of each other, rotating
+// nodes on the way back up from an insert or remove, so the tree is
+// never more than about 1.44 log2(n) levels deep whatever the order of
+// the keys.
+///
+
+#pragma once
+
+#include "BSTInterface.h"
+#include "NodeArena.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+template <typename KeyComparable, typename Value>
+class AVLTree : public BSTInterface<KeyComparable, Value>
+{
+    using Base = BSTInterface<KeyComparable, Value>;
+
+  public:
+    using typename Base::ValueHandle;
+
+  private:
+    /*
+     * Private BinaryNode Class
+     */
+    class BinaryNode
+    {
+      public:
+        KeyComparable key;
+        Value value;
+
+        BinaryNode* left;
+        BinaryNode* right;
+
+        // number of levels in the subtree rooted here
+        int height;
+
+        // The value is constructed in place from the remaining arguments
+        template <typename... Args>
+        explicit BinaryNode(KeyComparable key, Args&&... args)
+            : key{std::move(key)}, value(std::forward<Args>(args)...),
+              left{nullptr}, right{nullptr}, height{1}
+        {
+        }
+    };
+
+    // the root node of the tree
+    BinaryNode* root = nullptr;
+
+    // storage for the nodes
+    NodeArena<BinaryNode> nodes;
+
+    /*
+     * Returns the height of the subtree, 0 if it is empty
+     */
+    static int height(const BinaryNode* t)
+    {
+        return t ? t->height : 0;
+    }
+
+    static void updateHeight(BinaryNode* t)
+    {
+        t->height = 1 + std::max(height(t->left), height(t->right));
+    }
+
+    /*
+     * Makes the left child of t the root of the subtree
+     *
+     *         t             l
+     *        / \           / \
+     *       l   c   =>    a   t
+     *      / \               / \
+     *     a   b             b   c
+     */
+    static void rotateRight(BinaryNode*& t)
+    {
+        BinaryNode* l = t->left;
+        t->left = l->right;
+        l->right = t;
+        updateHeight(t);
+        updateHeight(l);
+        t = l;
+    }
+
+    /*
+     * Makes the right child of t the root of the subtree (the mirror of
+     * rotateRight)
+     */
+    static void rotateLeft(BinaryNode*& t)
+    {
+        BinaryNode* r = t->right;
+        t->right = r->left;
+        r->left = t;
+        updateHeight(t);
+        updateHeight(r);
+        t = r;
+    }
+
+    /*
+     * Restores the balance of a subtree whose children are balanced and
+     * differ in height by at most two, and updates its height.
+     */
+    static void balance(BinaryNode*& t)
+    {
+        if (height(t->left) - height(t->right) > 1)
+        {
+            // Left-right case: first make the left child lean left
+            if (height(t->left->left) < height(t->left->right))
+            {
+                rotateLeft(t->left);
+            }
+            rotateRight(t);
+        }
+        else if (height(t->right) - height(t->left) > 1)
+        {
+            // Right-left case: first make the right child lean right
+            if (height(t->right->right) < height(t->right->left))
+            {
+                rotateRight(t->right);
+            }
+            rotateLeft(t);
+        }
+        else
+        {
+            updateHeight(t);
+        }
+    }
+
+    /*
+     * Inserts a node into the subtree, with the value constructed from
+     * the given arguments, and rebalances on the way back up
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    template <typename... Args>
+    bool insert(BinaryNode*& t, KeyComparable& key, Args&&... args)
+    {
+        // Add the node where the search falls off the tree
+        if (!t)
+        {
+            t = nodes.create(std::move(key), std::forward<Args>(args)...);
+            return true; // SUCCESS: node added
+        }
+
+        bool inserted = false;
+        if (key < t->key)
+        {
+            inserted = insert(t->left, key, std::forward<Args>(args)...);
+        }
+        else if (t->key < key)
+        {
+            inserted = insert(t->right, key, std::forward<Args>(args)...);
+        }
+        else
+        {
+            return false; // FAIL: key already exists
+        }
+
+        if (inserted)
+        {
+            balance(t);
+        }
+        return inserted;
+    }
+
+    /*
+     * Unlinks the node with the largest key in the subtree, rebalancing
+     * on the way back up, and returns it
+     */
+    BinaryNode* detachMax(BinaryNode*& t)
+    {
+        if (t->right)
+        {
+            BinaryNode* max = detachMax(t->right);
+            balance(t);
+            return max;
+        }
+
+        // The max has no right child; its left subtree takes its place
+        BinaryNode* max = t;
+        t = t->left;
+        return max;
+    }
+
+    /*
+     * Removes the node with the key from the subtree, if it is there,
+     * and rebalances on the way back up
+     */
+    void remove(const KeyComparable& key, BinaryNode*& t)
+    {
+        // Check if the given node is null
+        if (!t)
+        {
+            return; // FAIL: key not found
+        }
+
+        if (key < t->key)
+        {
+            remove(key, t->left);
+        }
+        else if (t->key < key)
+        {
+            remove(key, t->right);
+        }
+        else if (t->left && t->right)
+        {
+            // Has two children
+            // Move the largest node in the left subtree into the place
+            // of the current node, so no key or value is copied
+            BinaryNode* max = detachMax(t->left);
+            max->left = t->left;
+            max->right = t->right;
+            nodes.destroy(t);
+            t = max;
+        }
+        else
+        {
+            // Has one child or none
+            // Replace the current node with the child, if any
+            BinaryNode* child = t->left ? t->left : t->right;
+            nodes.destroy(t);
+            t = child;
+        }
+
+        if (t)
+        {
+            balance(t);
+        }
+    }
+
+    /*
+     * Finds the node with the smallest element in the subtree
+     */
+    BinaryNode* findMin(BinaryNode* t) const
+    {
+        // Check if node is null
+        if (!t)
+        {
+            return nullptr; // FAIL: Node is null
+        }
+
+        // If there is a left child, keep walking
+        return t->left ? findMin(t->left) : t;
+    }
+
+    /*
+     * Finds the node with the largest element in the subtree
+     */
+    BinaryNode* findMax(BinaryNode* t) const
+    {
+        // Check if node is null
+        if (!t)
+        {
+            return nullptr; // FAIL: Node is null
+        }
+
+        // If there is a right child, keep walking
+        return t->right ? findMax(t->right) : t;
+    }
+
+    /*
+     * Finds the node with that satisfies equality for the element
+     */
+    BinaryNode* find(const KeyComparable& key, BinaryNode* node) const
+    {
+        // Check if the given node is null
+        if (!node)
+        {
+            return nullptr; // FAIL: node does not exist
+        }
+
+        if (key < node->key)
+        {
+            return find(key, node->left);
+        }
+        if (node->key < key)
+        {
+            return find(key, node->right);
+        }
+        return node; // SUCCESS: found the desired node
+    }
+
+    /*
+     * Destroys every node in the subtree
+     */
+    void makeEmpty(BinaryNode*& t)
+    {
+        // Skip null nodes
+        if (!t)
+        {
+            return;
+        }
+
+        // Destroy the children before their parent
+        makeEmpty(t->left);
+        makeEmpty(t->right);
+        nodes.destroy(t);
+        t = nullptr;
+    }
+
+    /*
+     * Prints the inorder the tree to the stream out
+     */
+    void printTree(BinaryNode* t, std::ostream& out) const
+    {
+        // Skip null nodes
+        if (!t)
+        {
+            return;
+        }
+
+        // Print in-order, recursing down branches:
+        //   Left Branch, Current, Right Branch
+        printTree(t->left, out);
+        Base::printValue(out, t->value);
+        out << "\n";
+        printTree(t->right, out);
+    }
+
+  public:
+    AVLTree() = default;
+
+    // The tree owns its nodes, so it cannot be copied
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
+
+    ~AVLTree()
+    {
+        makeEmpty();
+    }
+
+    /*
+     * Finds the node with the smallest element in the tree
+     */
+    ValueHandle findMin() const override
+    {
+        BinaryNode* found = findMin(root);
+        return found ? Base::toHandle(found->value) : nullptr;
+    }
+
+    /*
+     * Finds the node with the largest element in the tree
+     */
+    ValueHandle findMax() const override
+    {
+        BinaryNode* found = findMax(root);
+        return found ? Base::toHandle(found->value) : nullptr;
+    }
+
+    /*
+     * Finds the node with the key
+     * returns a pointer to its value in the tree if found
+     * returns nullptr if not
+     */
+    const Value* find(const KeyComparable& key) const override
+    {
+        BinaryNode* foundNode = find(key, root);
+        return foundNode ? &foundNode->value : nullptr;
+    }
+
+    // find(key, founditem) copies the value out
+    using Base::find;
+
+    /*
+     * Returns true if the item is found in the tree
+     */
+    bool contains(const KeyComparable& key) const override
+    {
+        return find(key, root) != nullptr;
+    }
+
+    /*
+     * Returns true if tree has no nodes
+     */
+    bool isEmpty() const override
+    {
+        return root == nullptr;
+    }
+
+    /*
+     * Prints the inorder the tree to the stream out
+     */
+    void printTree(std::ostream& out = std::cout) const override
+    {
+        printTree(root, out);
+    }
+
+    /*
+     * Removes all nodes from the tree
+     */
+    void makeEmpty() override
+    {
+        // Nodes with nothing to clean up are freed with their slabs
+        if constexpr (!std::is_trivially_destructible<BinaryNode>::value)
+        {
+            makeEmpty(root);
+        }
+
+        root = nullptr;
+        nodes.release();
+    }
+
+    /*
+     * Inserts a node into the tree
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    bool insert(Value value, KeyComparable key) override
+    {
+        return emplace(std::move(key), std::move(value));
+    }
+
+    /*
+     * Inserts a node into the tree, constructing its value in place from
+     * the given arguments
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    template <typename... Args>
+    bool emplace(KeyComparable key, Args&&... args)
+    {
+        return insert(root, key, std::forward<Args>(args)...);
+    }
+
+    /*
+     * Removes the node with the key, if it is in the tree
+     */
+    void remove(const KeyComparable& key) override
+    {
+        remove(key, root);
+    }
+
+    /*
+     * Returns the number of levels in the tree, 0 if it is empty
+     */
+    int getHeight() const
+    {
+        return height(root);
+    }
+}; // end of AVLTree class
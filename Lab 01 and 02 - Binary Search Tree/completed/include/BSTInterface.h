@@ -1,27 +1,187 @@
+#pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <istream>
 #include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
 
+/*
+ * True if values of type T can be written to an std::ostream.
+ */
+template <typename T, typename = void> struct IsPrintable : std::false_type
+{
+};
+
+template <typename T>
+struct IsPrintable<T, std::void_t<decltype(std::declval<std::ostream&>()
+                                           << std::declval<const T&>())>>
+    : std::true_type
+{
+};
+
+/*
+ * True if keys of type K can be compared with keys of type Key, both
+ * ways round, so a tree of Key can be searched for a K without making a
+ * Key of it: a std::string_view or a const char* for std::string keys.
+ */
+template <typename K, typename Key, typename = void>
+struct IsComparableKey : std::false_type
+{
+};
+
+template <typename K, typename Key>
+struct IsComparableKey<
+    K, Key,
+    std::void_t<
+        decltype(std::declval<const K&>() < std::declval<const Key&>()),
+        decltype(std::declval<const Key&>() < std::declval<const K&>()),
+        decltype(std::declval<const K&>() != std::declval<const Key&>())>>
+    : std::true_type
+{
+};
+
+/*
+ * The value may be a pointer to an object held elsewhere, or the object
+ * itself, held inline in the node. Inline values may be move-only.
+ */
 template <typename KeyComparable, typename Value> class BSTInterface
 {
-    // only allow pointer types for the value
-    static_assert(std::is_pointer<Value>::value, "Expected a pointer");
+  public:
+    // What findMin() and findMax() return: the value itself for pointer
+    // values, otherwise a pointer to the value in the tree. Both are
+    // nullptr if the tree is empty.
+    using ValueHandle =
+        std::conditional_t<std::is_pointer<Value>::value, Value,
+                           const Value*>;
+
+  protected:
+    /*
+     * Returns the handle findMin() and findMax() return for a value in
+     * the tree.
+     */
+    static ValueHandle toHandle(const Value& value)
+    {
+        if constexpr (std::is_pointer<Value>::value)
+        {
+            return value;
+        }
+        else
+        {
+            return &value;
+        }
+    }
+
+    /*
+     * Prints a value to the stream out. Pointer values print the object
+     * they point to. Values which cannot be printed are shown as
+     * "<value>".
+     */
+    static void printValue(std::ostream& out, const Value& value)
+    {
+        using Item = std::remove_pointer_t<Value>;
+        if constexpr (!IsPrintable<Item>::value)
+        {
+            out << "<value>";
+        }
+        else if constexpr (std::is_pointer<Value>::value)
+        {
+            out << *value;
+        }
+        else
+        {
+            out << value;
+        }
+    }
+
+    /*
+     * Writes an item as serialize() does by default: the bytes of a
+     * trivially copyable item, or the length and characters of a string
+     */
+    template <typename T>
+    static void writeItem(std::ostream& out, const T& item)
+    {
+        if constexpr (std::is_same<T, std::string>::value)
+        {
+            std::uint64_t size = item.size();
+            out.write(reinterpret_cast<const char*>(&size), sizeof size);
+            out.write(item.data(), item.size());
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable<T>::value &&
+                              !std::is_pointer<T>::value,
+                          "serialize() needs functions to write keys or "
+                          "values which are pointers or not plain data");
+            out.write(reinterpret_cast<const char*>(&item), sizeof item);
+        }
+    }
+
+    /*
+     * Reads an item written by writeItem()
+     */
+    template <typename T> static T readItem(std::istream& in)
+    {
+        if constexpr (std::is_same<T, std::string>::value)
+        {
+            std::uint64_t size = 0;
+            in.read(reinterpret_cast<char*>(&size), sizeof size);
+
+            // Read a bounded piece at a time, so a corrupt length fails
+            // at the end of the stream rather than in allocating
+            std::string item;
+            char piece[4096];
+            while (in && size > 0)
+            {
+                auto n = std::min<std::uint64_t>(size, sizeof piece);
+                in.read(piece, static_cast<std::streamsize>(n));
+                item.append(piece, in.gcount());
+                size -= n;
+            }
+            return item;
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable<T>::value &&
+                              !std::is_pointer<T>::value,
+                          "deserialize() needs functions to read keys or "
+                          "values which are pointers or not plain data");
+            T item{};
+            in.read(reinterpret_cast<char*>(&item), sizeof item);
+            return item;
+        }
+    }
 
-  private:
   public:
     BSTInterface(){};
     BSTInterface(const BSTInterface& rhs){};
     BSTInterface(BSTInterface&& rhs){};
     virtual ~BSTInterface(){};
 
-    virtual const Value findMin() const = 0;
-    virtual const Value findMax() const = 0;
+    virtual ValueHandle findMin() const = 0;
+    virtual ValueHandle findMax() const = 0;
     virtual bool contains(const KeyComparable& key) const = 0;
-    virtual bool find(const KeyComparable& key,
-                      Value& itemFound) const = 0;
+    virtual const Value* find(const KeyComparable& key) const = 0;
     virtual bool isEmpty() const = 0;
     virtual void printTree(std::ostream& out = std::cout) const = 0;
     virtual void makeEmpty() = 0;
     virtual bool insert(Value item, KeyComparable key) = 0;
     virtual void remove(const KeyComparable& key) = 0;
+
+    /*
+     * Copies the value with the given key into itemFound.
+     * Returns true if it was found, false otherwise.
+     */
+    bool find(const KeyComparable& key, Value& itemFound) const
+    {
+        const Value* found = find(key);
+        if (found)
+        {
+            itemFound = *found;
+        }
+        return found != nullptr;
+    }
 };
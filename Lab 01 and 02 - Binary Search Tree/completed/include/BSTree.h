@@ -5,20 +5,57 @@
 //
 // Description: An object-oriented implementation of a Binary Search Tree.
 // Includes functions for inserting, finding, and removing nodes. The nodes
-// are referenced by a key, which can be any comparable type.
+// are referenced by a key, which can be any comparable type. The values
+// may be pointers or, to save an allocation per node, held inline in the
+// nodes (see emplace()). The nodes are allocated from an arena (see
+// NodeArena.h), which releases them all at once when the tree is emptied.
+//
+// Every operation walks the tree in a loop instead of recursing, so a
+// tree made as deep as it is long by sorted input cannot overflow the
+// stack. (AVLTree keeps the depth itself down.)
+//
+// Keys which arrive in order can be inserted from where the last one
+// went (see insertHint() and insertSortedRun()) instead of from the root,
+// so appending k sorted keys after the largest takes O(k) steps plus
+// one search.
+//
+// A tree keyed by strings can be searched with a std::string_view or a
+// const char* (see find()), without copying it into a std::string first.
+//
+// A tree can be written to a stream and read back as the same tree (see
+// serialize()). The nodes are written in preorder, each after a byte
+// saying which children it has, so reading rebuilds the exact shape in
+// one pass with no comparisons, into a single slab of the arena.
 ///
 
+#pragma once
 
 #include "BSTInterface.h"
 #include "ComputerScientist.h"
-
+#include "NodeArena.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
 template <typename KeyComparable, typename Value>
 class BinarySearchTree : public BSTInterface<KeyComparable, Value>
 {
+    using Base = BSTInterface<KeyComparable, Value>;
+
+  public:
+    using typename Base::ValueHandle;
+
   private:
     /*
      * Private BinaryNode Class
@@ -35,10 +72,12 @@ class BinarySearchTree : public BSTInterface<KeyComparable, Value>
         // by using a member initializer list.
         // This method uses direct initialization, which is more
         // efficient than using assignment operators inside the constructor
-        // body.
-        BinaryNode(KeyComparable& key, Value& value,
-                   BinaryNode* left = nullptr, BinaryNode* right = nullptr)
-            : value{value}, left{left}, right{right}, key{key}
+        // body. The value is constructed in place from the remaining
+        // arguments.
+        template <typename... Args>
+        explicit BinaryNode(KeyComparable key, Args&&... args)
+            : key{std::move(key)}, value(std::forward<Args>(args)...),
+              left{nullptr}, right{nullptr}
         {
         }
     };
@@ -46,134 +85,70 @@ class BinarySearchTree : public BSTInterface<KeyComparable, Value>
     // the root node of the tree
     BinaryNode* root = nullptr;
 
-    /*
-     * Inserts a node into the tree
-     * returns true if item inserted
-     * returns false if item not inserted (Key already in tree)
-     * maintains this property of the tree:
-     *     All nodes to the left will be less
-     *     All nodes to the right will be greater
-     */
-    bool insert(Value item, KeyComparable key, BinaryNode* node)
-    {
-        // Check if the given node is null
-        if (!node)
-        {
-            return false; // FAIL: node does not exist
-        }
+    // storage for the nodes
+    NodeArena<BinaryNode> nodes;
 
-        // Check if the key is the same as the current key (already exists)
-        if (key == node->key)
-        {
-            return false; // FAIL: key already exists
-        }
+    // the first bytes of a serialized tree
+    static constexpr char MAGIC[4] = {'B', 'S', 'T', '1'};
 
-        // Use left branch for smaller keys
-        if (key < node->key)
-        {
-            // If there is a left node, recurse down the left branch
-            if (node->left)
-            {
-                return insert(item, key, node->left);
-            }
-
-            // Otherwise, make this the left child
-            node->left = new BinaryNode(key, item);
-            return true; // SUCCESS: node added
-        }
+    // the bits of the byte written before each node
+    static constexpr int HAS_LEFT = 1;
+    static constexpr int HAS_RIGHT = 2;
 
-        // Use right branch for larger keys
-        // If there is a right node, recurse down the right branch
-        if (node->right)
+    /*
+     * Returns the link (the root, or the left or right pointer of the
+     * parent) which holds the node with the key, or the null link where
+     * it would be inserted. Walks down in a loop, so the depth of the
+     * tree does not matter.
+     */
+    BinaryNode*& findLink(const KeyComparable& key)
+    {
+        BinaryNode** link = &root;
+        while (*link && key != (*link)->key)
         {
-            return insert(item, key, node->right);
+            // Smaller keys are on the left, larger keys on the right
+            link = (key < (*link)->key) ? &(*link)->left : &(*link)->right;
         }
-
-        node->right = new BinaryNode(key, item);
-        return true; // SUCCESS: node added
+        return *link;
     }
 
     /*
-     * remove a node from the tree
+     * remove the node at the link from the tree
      * maintains this property of the tree:
      *     All nodes to the left will be less
      *     All nodes to the right will be greater
      */
-    void remove(const KeyComparable& key, BinaryNode*& t)
+    void remove(BinaryNode*& t)
     {
-        // Check if the given node is null
-        if (!t)
-        {
-            return; // FAIL: node does not exist
-        }
-
-        // Check left
-        if (key < t->key)
-        {
-            return remove(key, t->left);
-        }
-
-        // Check right
-        if (key > t->key)
+        // Has two children?
+        if (t->left && t->right)
         {
-            return remove(key, t->right);
-        }
-
-        // Check current node
-        if (key != t->key)
-        {
-            return; // FAIL: key not found
-        }
-
-        // Has a left child?
-        if (t->left)
-        {
-            // Has a right child?
-            if (t->right)
+            // Find the link to the largest node in the left subtree
+            BinaryNode** maxLink = &t->left;
+            while ((*maxLink)->right)
             {
-                // Has two children
-                // Replace the current node with the largest in the left
-                // subtree by copying the key and value, keeping the
-                // current left and right children.
-                auto max = findMax(t->left);
-                t->key = max->key;
-                t->value = max->value;
-
-                // Call this function on the key to delete to unlink
-                // correctly from parent
-                remove(max->key, t->left);
+                maxLink = &(*maxLink)->right;
             }
-            else
-            {
-                // Has a left child only.
-                // Replace the current node with the left child.
-                auto tmp = t->left;
-                delete t;
-                t = tmp;
-            }
-        }
-        else if (t->right)
-        {
-            // Has a right child only
-            // Replace the current node with the right child.
-            auto tmp = t->right;
-            delete t;
-            t = tmp;
-        }
-        else
-        {
-            // No children
-            // Just delete.
-            delete t;
-            t = nullptr;
-            return; // Don't reset root if there's no children
-        }
 
-        // Reset root if deleted
-        if (key == root->key)
-        {
-            root = t;
+            // Unlink the max node, which has no right child, and move it
+            // into the place of the current node. No key or value is
+            // copied.
+            BinaryNode* max = *maxLink;
+            *maxLink = max->left;
+            max->left = t->left;
+            max->right = t->right;
+            nodes.destroy(t);
+            t = max;
+            return;
         }
+
+        // Has one child or none
+        // Replace the current node with the child, if any.
+        // Note: t refers to the link in the parent (or root itself), so
+        // this relinks the tree
+        BinaryNode* child = t->left ? t->left : t->right;
+        nodes.destroy(t);
+        t = child;
     }
 
     /*
@@ -187,13 +162,11 @@ class BinarySearchTree : public BSTInterface<KeyComparable, Value>
             return nullptr; // FAIL: Node is null
         }
 
-        // If there is a left child, keep walking
-        if (t->left)
+        // While there is a left child, keep walking
+        while (t->left)
         {
-            return findMin(t->left);
+            t = t->left;
         }
-
-        // If there is no left child, return the current node
         return t;
     }
 
@@ -208,132 +181,296 @@ class BinarySearchTree : public BSTInterface<KeyComparable, Value>
             return nullptr; // FAIL: Node is null
         }
 
-        // If there is a right child, keep walking
-        if (t->right)
+        // While there is a right child, keep walking
+        while (t->right)
         {
-            return findMax(t->right);
+            t = t->right;
         }
-
-        // If there is no right child, return the current node
         return t;
     }
 
     /*
-     * Finds the node with that satisfies equality for the element
+     * Finds the node with that satisfies equality for the element, which
+     * may be of any type comparable with the keys
      */
-    BinaryNode* find(const KeyComparable& key, BinaryNode* node) const
+    template <typename K>
+    BinaryNode* find(const K& key, BinaryNode* node) const
     {
-        // Check if the given node is null
-        if (!node)
-        {
-            return nullptr; // FAIL: node does not exist
-        }
-
-        // Check the current node
-        if (key == node->key)
+        // Walk down until the key is found or the path ends.
+        // If the key is less than the current node, go left;
+        // otherwise, go right.
+        while (node && key != node->key)
         {
-            return node; // SUCCESS: found the desired node
+            node = (key < node->key) ? node->left : node->right;
         }
 
-        // If the key is less than the current node, check left;
-        // otherwise, check right.
         // Return either the located node or nullptr if not found
-        return (key < node->key) ? find(key, node->left)
-                                 : find(key, node->right);
+        return node;
     }
 
     /*
-     * Returns true if the item is found in the tree
+     * Destroys every node in the subtree, without recursion
      */
-    bool contains(const Value& item, BinaryNode* t) const
+    void makeEmpty(BinaryNode*& t)
     {
-        // optional code
-        return false;
+        while (t)
+        {
+            if (t->left)
+            {
+                // Rotate the left child up, so the subtree leans right
+                BinaryNode* left = t->left;
+                t->left = left->right;
+                left->right = t;
+                t = left;
+            }
+            else
+            {
+                // No left child, so destroy the node and go right
+                BinaryNode* right = t->right;
+                nodes.destroy(t);
+                t = right;
+            }
+        }
     }
 
+  public:
     /*
-     * Removes all elelements from the tree
+     * Forward iterator over the tree in order of keys.
+     * Dereferencing yields the value; the key is available from key().
+     * The nodes still to visit are kept on an explicit stack, so no
+     * recursion is needed however deep the tree.
+     * Iterators are invalidated by any change to the tree.
      */
-    void makeEmpty(BinaryNode*& t)
+    class Iterator
     {
-        // optional code
-    }
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Value*;
+        using reference = const Value&;
+
+      private:
+        friend class BinarySearchTree;
+
+        // the current node on top, below it the ancestors whose left
+        // subtree is being visited
+        std::vector<const BinaryNode*> stack;
+
+        explicit Iterator(const BinaryNode* node)
+        {
+            pushLeft(node);
+        }
+
+        /*
+         * Pushes the node and its chain of left children, so the
+         * smallest node of the subtree ends up on top
+         */
+        void pushLeft(const BinaryNode* node)
+        {
+            while (node)
+            {
+                stack.push_back(node);
+                node = node->left;
+            }
+        }
+
+      public:
+        Iterator() = default;
+
+        const KeyComparable& key() const
+        {
+            return stack.back()->key;
+        }
+
+        reference operator*() const
+        {
+            return stack.back()->value;
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        Iterator& operator++()
+        {
+            // The next node is the smallest of the right subtree, or
+            // else the nearest ancestor still on the stack
+            const BinaryNode* node = stack.back();
+            stack.pop_back();
+            pushLeft(node->right);
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator prev = *this;
+            ++*this;
+            return prev;
+        }
+
+        bool operator==(const Iterator& rhs) const
+        {
+            if (stack.empty() || rhs.stack.empty())
+            {
+                return stack.empty() && rhs.stack.empty();
+            }
+            return stack.back() == rhs.stack.back();
+        }
 
+        bool operator!=(const Iterator& rhs) const
+        {
+            return !(*this == rhs);
+        }
+    };
+
+  private:
     /*
-     * Prints the inorder the tree to the stream out
+     * Inserts a node, with the value constructed from the given
+     * arguments, searching from the node of the hint (see insertHint()),
+     * and moves the hint to the node with the key
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
      */
-    void printTree(BinaryNode* t, std::ostream& out) const
+    template <typename... Args>
+    bool emplaceAfter(Iterator& hint, KeyComparable& key, Args&&... args)
     {
-        // Skip null nodes
-        if (!t)
+        // The stack holds the hint's node on top, and below it the
+        // ancestors whose left subtree it is in, each larger than the
+        // one above. Climb while the key is not below the next of them.
+        std::vector<const BinaryNode*>& stack = hint.stack;
+        while (stack.size() >= 2 && !(key < stack[stack.size() - 2]->key))
         {
-            return;
+            stack.pop_back();
         }
 
-        // Print in-order, recursing down branches:
-        //   Left Branch, Current, Right Branch
-        printTree(t->left, out);
-        out << *t->value << "\n";
-        printTree(t->right, out);
+        // The key is then the node on top, or in its right subtree
+        BinaryNode** link = &root;
+        if (!stack.empty() && !(key < stack.back()->key))
+        {
+            if (key == stack.back()->key)
+            {
+                return false; // FAIL: key already exists
+            }
+
+            // Iterators only see the nodes as const, but the tree owns
+            // them
+            auto* from = const_cast<BinaryNode*>(stack.back());
+            stack.pop_back();
+            link = &from->right;
+        }
+        else
+        {
+            stack.clear();
+        }
+
+        // Walk down as findLink() does, keeping the nodes where the
+        // walk goes left on the stack
+        while (*link && key != (*link)->key)
+        {
+            if (key < (*link)->key)
+            {
+                stack.push_back(*link);
+                link = &(*link)->left;
+            }
+            else
+            {
+                link = &(*link)->right;
+            }
+        }
+
+        bool inserted = false;
+        if (!*link)
+        {
+            // Add the node at the null link
+            *link =
+                nodes.create(std::move(key), std::forward<Args>(args)...);
+            inserted = true;
+        }
+        stack.push_back(*link);
+        return inserted;
     }
 
   public:
-    BinarySearchTree()
-    {
-        // optional code
-    }
+    BinarySearchTree() = default;
+
+    // The tree owns its nodes, so it cannot be copied
+    BinarySearchTree(const BinarySearchTree&) = delete;
+    BinarySearchTree& operator=(const BinarySearchTree&) = delete;
 
     ~BinarySearchTree()
     {
-        // optional code
+        makeEmpty();
     }
 
     /*
      * Finds the node with the smallest element in the tree
      */
-    const Value findMin() const
+    ValueHandle findMin() const
     {
         BinaryNode* found = findMin(root);
-        return found ? found->value : nullptr;
+        return found ? Base::toHandle(found->value) : nullptr;
     }
 
     /*
      * Finds the node with the largest element in the tree
      */
-    const Value findMax() const
+    ValueHandle findMax() const
     {
         BinaryNode* found = findMax(root);
-        return found ? found->value : nullptr;
+        return found ? Base::toHandle(found->value) : nullptr;
     }
 
     /*
-     * Finds the node with that the key
-     * updates the founditem refrerence if found
-     * returns true if it was found
-     * returns false if it was not
+     * Finds the node with the key
+     * returns a pointer to its value in the tree if found
+     * returns nullptr if not
      */
-    bool find(const KeyComparable& key, Value& founditem) const
+    const Value* find(const KeyComparable& key) const
     {
         // Try finding the key
         BinaryNode* foundNode = find(key, root);
 
-        // If the key is found, set the out param 'founditem' to the value
-        if (foundNode)
-        {
-            founditem = foundNode->value;
-        }
+        // Return the value if the key was found, nullptr otherwise
+        return foundNode ? &foundNode->value : nullptr;
+    }
 
-        // Return true if the key was found, false otherwise
-        return (foundNode != nullptr);
+    /*
+     * Finds the node with the key equal to one of another type, such as
+     * a std::string_view for std::string keys, without making a
+     * KeyComparable of it
+     * returns a pointer to its value in the tree if found
+     * returns nullptr if not
+     */
+    template <typename K, typename = std::enable_if_t<
+                              IsComparableKey<K, KeyComparable>::value>>
+    const Value* find(const K& key) const
+    {
+        BinaryNode* foundNode = find(key, root);
+        return foundNode ? &foundNode->value : nullptr;
     }
 
+    // find(key, founditem) copies the value out
+    using Base::find;
+
     /*
      * Returns true if the item is found in the tree
      */
     bool contains(const KeyComparable& key) const
     {
-        // optional code
-        return false;
+        return find(key, root) != nullptr;
+    }
+
+    /*
+     * Returns true if a key equal to one of another type is found in the
+     * tree (see find())
+     */
+    template <typename K, typename = std::enable_if_t<
+                              IsComparableKey<K, KeyComparable>::value>>
+    bool contains(const K& key) const
+    {
+        return find(key, root) != nullptr;
     }
 
     /*
@@ -341,7 +478,6 @@ class BinarySearchTree : public BSTInterface<KeyComparable, Value>
      */
     bool isEmpty() const
     {
-        // optional code
         return root == nullptr;
     }
 
@@ -350,7 +486,11 @@ class BinarySearchTree : public BSTInterface<KeyComparable, Value>
      */
     void printTree(std::ostream& out = cout) const
     {
-        printTree(root, out);
+        for (auto it = begin(); it != end(); ++it)
+        {
+            Base::printValue(out, *it);
+            out << "\n";
+        }
     }
 
     /*
@@ -358,7 +498,16 @@ class BinarySearchTree : public BSTInterface<KeyComparable, Value>
      */
     void makeEmpty()
     {
-        // optional code
+        // Only nodes holding something to clean up (a string key, an
+        // inline value owning memory, ...) must be visited one by one.
+        // Otherwise dropping the slabs frees every node at once.
+        if constexpr (!std::is_trivially_destructible<BinaryNode>::value)
+        {
+            makeEmpty(root);
+        }
+
+        root = nullptr;
+        nodes.release();
     }
 
     /*
@@ -369,15 +518,76 @@ class BinarySearchTree : public BSTInterface<KeyComparable, Value>
      */
     bool insert(Value value, KeyComparable key)
     {
-        // If there is no root node, add this as the root
-        if (!root)
+        return emplace(std::move(key), std::move(value));
+    }
+
+    /*
+     * Inserts a node into the tree, constructing its value in place from
+     * the given arguments
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    template <typename... Args>
+    bool emplace(KeyComparable key, Args&&... args)
+    {
+        // Find where the key belongs, starting from the root
+        BinaryNode*& link = findLink(key);
+        if (link)
         {
-            root = new BinaryNode(key, value);
-            return true;
+            return false; // FAIL: key already exists
         }
 
-        // Try adding the value to the tree, starting from the root
-        return insert(value, key, root);
+        // Add the node at the null link, maintaining this property of
+        // the tree:
+        //     All nodes to the left will be less
+        //     All nodes to the right will be greater
+        link = nodes.create(std::move(key), std::forward<Args>(args)...);
+        return true; // SUCCESS: node added
+    }
+
+    /*
+     * Inserts a node into the tree, searching from the hint (an iterator
+     * to a node with a smaller key, such as the one returned by the last
+     * insert) instead of from the root. The search climbs from the hint
+     * only as far as it must to reach a subtree holding the key, so a key
+     * just after the hint is placed in a step or two. A hint past the key
+     * is no help, and the search starts from the root.
+     * returns an iterator to the node with the key, whether it was added
+     * or was already in the tree
+     */
+    Iterator insertHint(Iterator hint, KeyComparable key, Value value)
+    {
+        return emplaceHint(std::move(hint), std::move(key),
+                           std::move(value));
+    }
+
+    /*
+     * Inserts a node as insertHint() does, constructing its value in
+     * place from the given arguments
+     */
+    template <typename... Args>
+    Iterator emplaceHint(Iterator hint, KeyComparable key, Args&&... args)
+    {
+        emplaceAfter(hint, key, std::forward<Args>(args)...);
+        return hint;
+    }
+
+    /*
+     * Inserts every (key, value) pair of the run, in order, each one
+     * searched for from the last (see insertHint()). The run should be
+     * sorted by key, or nearly so.
+     * returns the number of items inserted
+     */
+    template <typename Range> int insertSortedRun(const Range& run)
+    {
+        int inserted = 0;
+        Iterator hint = end();
+        for (const auto& [key, value] : run)
+        {
+            KeyComparable nextKey = key;
+            inserted += emplaceAfter(hint, nextKey, value);
+        }
+        return inserted;
     }
 
     /*
@@ -385,6 +595,189 @@ class BinarySearchTree : public BSTInterface<KeyComparable, Value>
      */
     void remove(const KeyComparable& key) override
     {
-        remove(key, root);
+        BinaryNode*& link = findLink(key);
+        if (!link)
+        {
+            return; // FAIL: key not found
+        }
+        remove(link);
+    }
+
+    /*
+     * Writes the tree to the stream out, to be read back by
+     * deserialize(): the number of nodes, then each node in preorder as
+     * a byte saying which children it has, its key and its value. Keys
+     * and values are written as writeItem() (in BSTInterface.h) does:
+     * plain data as its bytes, in the order of this machine, and strings
+     * as their length and characters. Other types need the overload
+     * below.
+     */
+    void serialize(std::ostream& out) const
+    {
+        serialize(out, Base::template writeItem<KeyComparable>,
+                  Base::template writeItem<Value>);
+    }
+
+    /*
+     * Writes the tree as serialize(out) does, writing each key by
+     * calling writeKey(out, key) and each value by calling
+     * writeValue(out, value), such as an ID for a pointer value.
+     */
+    template <typename WriteKey, typename WriteValue>
+    void serialize(std::ostream& out, WriteKey writeKey,
+                   WriteValue writeValue) const
+    {
+        std::uint64_t count = std::distance(begin(), end());
+        out.write(MAGIC, sizeof MAGIC);
+        out.write(reinterpret_cast<const char*>(&count), sizeof count);
+
+        // Visit the nodes in preorder, with the subtrees still to write
+        // on an explicit stack
+        std::vector<const BinaryNode*> stack;
+        if (root)
+        {
+            stack.push_back(root);
+        }
+        while (!stack.empty())
+        {
+            const BinaryNode* t = stack.back();
+            stack.pop_back();
+
+            int shape =
+                (t->left ? HAS_LEFT : 0) | (t->right ? HAS_RIGHT : 0);
+            out.put(static_cast<char>(shape));
+            writeKey(out, t->key);
+            writeValue(out, t->value);
+
+            // The left subtree comes first, so goes on the stack last
+            if (t->right)
+            {
+                stack.push_back(t->right);
+            }
+            if (t->left)
+            {
+                stack.push_back(t->left);
+            }
+        }
+    }
+
+    /*
+     * Replaces the tree with one read from the stream in, as written by
+     * serialize(out). Every node is linked into the place the shape
+     * bytes give it, so the tree comes back in the same shape in one
+     * pass, without comparing keys, and its nodes are allocated side by
+     * side.
+     * Throws std::runtime_error if the stream ends early or does not
+     * hold a tree, leaving the tree empty.
+     */
+    void deserialize(std::istream& in)
+    {
+        deserialize(in, Base::template readItem<KeyComparable>,
+                    Base::template readItem<Value>);
+    }
+
+    /*
+     * Reads the tree as deserialize(in) does, reading each key by
+     * calling readKey(in) and each value by calling readValue(in), to
+     * undo serialize(out, writeKey, writeValue).
+     */
+    template <typename ReadKey, typename ReadValue>
+    void deserialize(std::istream& in, ReadKey readKey,
+                     ReadValue readValue)
+    {
+        makeEmpty();
+
+        char magic[sizeof MAGIC] = {};
+        std::uint64_t count = 0;
+        in.read(magic, sizeof magic);
+        in.read(reinterpret_cast<char*>(&count), sizeof count);
+        if (!in || !std::equal(magic, magic + sizeof magic, MAGIC))
+        {
+            throw std::runtime_error("BinarySearchTree: not a tree");
+        }
+
+        try
+        {
+            // Read every node before making any, so that the count is
+            // only trusted once the stream has held that many. The
+            // staging arrays grow with what is read, so a corrupt count
+            // fails at the end of the stream rather than in allocating.
+            std::vector<char> shapes;
+            std::vector<std::pair<KeyComparable, Value>> items;
+            shapes.reserve(std::min<std::uint64_t>(count, 1 << 16));
+            items.reserve(std::min<std::uint64_t>(count, 1 << 16));
+
+            // the number of children named by the shapes so far and not
+            // yet read, starting with the root
+            std::uint64_t pending = count > 0 ? 1 : 0;
+            for (std::uint64_t i = 0; i < count; i++)
+            {
+                int shape = in.get();
+                KeyComparable key = readKey(in);
+                Value value = readValue(in);
+                if (!in || pending == 0)
+                {
+                    throw std::runtime_error(
+                        "BinarySearchTree: stream ended or is corrupt");
+                }
+
+                pending += ((shape & HAS_LEFT) ? 1 : 0) +
+                           ((shape & HAS_RIGHT) ? 1 : 0) - 1;
+                shapes.push_back(static_cast<char>(shape));
+                items.emplace_back(std::move(key), std::move(value));
+            }
+
+            if (pending != 0)
+            {
+                throw std::runtime_error(
+                    "BinarySearchTree: stream ended or is corrupt");
+            }
+
+            // The links still to fill in, the next one on top. Each
+            // starts out null, so the tree is whole at every step.
+            std::vector<BinaryNode**> links;
+            if (count > 0)
+            {
+                links.push_back(&root);
+                nodes.reserve(count);
+            }
+            for (std::size_t i = 0; i < items.size(); i++)
+            {
+                BinaryNode** link = links.back();
+                links.pop_back();
+                *link = nodes.create(std::move(items[i].first),
+                                     std::move(items[i].second));
+                if (shapes[i] & HAS_RIGHT)
+                {
+                    links.push_back(&(*link)->right);
+                }
+                if (shapes[i] & HAS_LEFT)
+                {
+                    links.push_back(&(*link)->left);
+                }
+            }
+        }
+        catch (...)
+        {
+            // FAIL: Drop what was read
+            makeEmpty();
+            throw;
+        }
+    }
+
+    /*
+     * Returns an iterator to the node with the smallest key
+     */
+    Iterator begin() const
+    {
+        return Iterator(root);
+    }
+
+    /*
+     * Returns an iterator past the node with the largest key
+     */
+    Iterator end() const
+    {
+        return Iterator();
     }
 }; // end of BinarySearchTree class
@@ -0,0 +1,545 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A binary search tree whose nodes are kept in one array
+// and linked by 32-bit indices into it instead of pointers.
+//
+// A node holds only its key and the indices of its two children: 12
+// bytes for an int key, where a BinarySearchTree node with a pointer
+// value takes 32. The values are kept in a second array alongside, so a
+// search touches only the small nodes on the way down, and two to three
+// times as many of them fit in each cache line. Nodes freed by remove()
+// are reused by later inserts.
+//
+// Since nothing in the tree points at an address, the tree can be copied
+// or moved as its two arrays, and the arrays can be written out and read
+// back as they are (see serialize()), with every node at the same index.
+// A tree holds at most about four billion nodes.
+//
+// Like the plain BinarySearchTree the tree is not balanced, and every
+// operation walks it in a loop. Keys and values must be default
+// constructible, so that a freed node can let go of what it held.
+///
+
+#pragma once
+
+#include "BSTInterface.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename KeyComparable, typename Value>
+class CompactTree : public BSTInterface<KeyComparable, Value>
+{
+    using Base = BSTInterface<KeyComparable, Value>;
+
+  public:
+    using typename Base::ValueHandle;
+
+    // the position of a node in the arrays
+    using Index = std::uint32_t;
+
+    // the index of no node
+    static constexpr Index NIL = std::numeric_limits<Index>::max();
+
+  private:
+    /*
+     * Private BinaryNode Class
+     * Its value is values[i], for the node at nodes[i].
+     */
+    class BinaryNode
+    {
+      public:
+        KeyComparable key;
+
+        // Freed nodes are chained through left
+        Index left;
+        Index right;
+    };
+
+    std::vector<BinaryNode> nodes;
+    std::vector<Value> values;
+
+    // the root node of the tree
+    Index root = NIL;
+
+    // the first of the freed nodes
+    Index freeList = NIL;
+
+    // number of nodes in the tree
+    int count = 0;
+
+    // the first bytes of a serialized tree
+    static constexpr char MAGIC[4] = {'C', 'P', 'T', '1'};
+
+    /*
+     * Returns the link (the root, or the left or right index of the
+     * parent) which holds the node with the key, or the NIL link where
+     * it would be inserted. The link is only good until a node is
+     * allocated.
+     */
+    Index& findLink(const KeyComparable& key)
+    {
+        Index* link = &root;
+        while (*link != NIL && key != nodes[*link].key)
+        {
+            // Smaller keys are on the left, larger keys on the right
+            BinaryNode& node = nodes[*link];
+            link = (key < node.key) ? &node.left : &node.right;
+        }
+        return *link;
+    }
+
+    /*
+     * Finds the node with that satisfies equality for the element
+     */
+    Index find(const KeyComparable& key, Index t) const
+    {
+        while (t != NIL && key != nodes[t].key)
+        {
+            t = (key < nodes[t].key) ? nodes[t].left : nodes[t].right;
+        }
+        return t;
+    }
+
+    /*
+     * Takes a freed node, or else adds one to the end of the arrays, and
+     * fills it in
+     */
+    template <typename... Args>
+    Index allocate(KeyComparable key, Args&&... args)
+    {
+        if (freeList != NIL)
+        {
+            Index t = freeList;
+            freeList = nodes[t].left;
+            nodes[t] = BinaryNode{std::move(key), NIL, NIL};
+            values[t] = Value(std::forward<Args>(args)...);
+            return t;
+        }
+
+        if (nodes.size() >= NIL)
+        {
+            throw std::length_error("CompactTree: too many nodes");
+        }
+        nodes.push_back(BinaryNode{std::move(key), NIL, NIL});
+        values.emplace_back(std::forward<Args>(args)...);
+        return static_cast<Index>(nodes.size() - 1);
+    }
+
+    /*
+     * Puts the node on the free list, letting go of its key and value
+     */
+    void release(Index t)
+    {
+        using Key = KeyComparable;
+        if constexpr (!std::is_trivially_destructible<Key>::value)
+        {
+            nodes[t].key = Key();
+        }
+        if constexpr (!std::is_trivially_destructible<Value>::value)
+        {
+            values[t] = Value();
+        }
+        nodes[t].left = freeList;
+        freeList = t;
+    }
+
+    /*
+     * remove the node at the link from the tree
+     * maintains this property of the tree:
+     *     All nodes to the left will be less
+     *     All nodes to the right will be greater
+     */
+    void remove(Index& t)
+    {
+        Index removed = t;
+        BinaryNode& node = nodes[removed];
+
+        // Has two children?
+        if (node.left != NIL && node.right != NIL)
+        {
+            // Find the link to the largest node in the left subtree
+            Index* maxLink = &node.left;
+            while (nodes[*maxLink].right != NIL)
+            {
+                maxLink = &nodes[*maxLink].right;
+            }
+
+            // Unlink the max node, which has no right child, and move it
+            // into the place of the current node. No key or value is
+            // copied.
+            Index max = *maxLink;
+            *maxLink = nodes[max].left;
+            nodes[max].left = node.left;
+            nodes[max].right = node.right;
+            t = max;
+        }
+        else
+        {
+            // Has one child or none
+            // Replace the current node with the child, if any
+            t = (node.left != NIL) ? node.left : node.right;
+        }
+
+        release(removed);
+        count--;
+    }
+
+    /*
+     * Checks that the links read by deserialize() make one tree and one
+     * free list, which between them hold every node once, and returns
+     * the number of nodes in the tree.
+     * Throws std::runtime_error if they do not.
+     */
+    int checkLinks() const
+    {
+        std::vector<bool> seen(nodes.size());
+        auto visit = [&](Index t) {
+            if (t >= nodes.size() || seen[t])
+            {
+                // FAIL: A link leads out of the arrays or round a loop
+                throw std::runtime_error("CompactTree: stream is corrupt");
+            }
+            seen[t] = true;
+        };
+
+        int inTree = 0;
+        std::vector<Index> stack;
+        if (root != NIL)
+        {
+            visit(root);
+            stack.push_back(root);
+        }
+        while (!stack.empty())
+        {
+            Index t = stack.back();
+            stack.pop_back();
+            inTree++;
+            for (Index child : {nodes[t].left, nodes[t].right})
+            {
+                if (child != NIL)
+                {
+                    visit(child);
+                    stack.push_back(child);
+                }
+            }
+        }
+
+        std::size_t freed = 0;
+        for (Index t = freeList; t != NIL; t = nodes[t].left)
+        {
+            visit(t);
+            freed++;
+        }
+
+        if (inTree + freed != nodes.size())
+        {
+            // FAIL: Some node is in neither
+            throw std::runtime_error("CompactTree: stream is corrupt");
+        }
+        return inTree;
+    }
+
+  public:
+    CompactTree() = default;
+
+    /*
+     * Makes room for n nodes in all, so that inserting up to n keys does
+     * not move the arrays
+     */
+    void reserve(std::size_t n)
+    {
+        nodes.reserve(n);
+        values.reserve(n);
+    }
+
+    /*
+     * Finds the node with the smallest element in the tree
+     */
+    ValueHandle findMin() const override
+    {
+        Index t = root;
+        while (t != NIL && nodes[t].left != NIL)
+        {
+            t = nodes[t].left;
+        }
+        return (t != NIL) ? Base::toHandle(values[t]) : nullptr;
+    }
+
+    /*
+     * Finds the node with the largest element in the tree
+     */
+    ValueHandle findMax() const override
+    {
+        Index t = root;
+        while (t != NIL && nodes[t].right != NIL)
+        {
+            t = nodes[t].right;
+        }
+        return (t != NIL) ? Base::toHandle(values[t]) : nullptr;
+    }
+
+    /*
+     * Finds the node with the key
+     * returns a pointer to its value in the tree if found, which is only
+     * good until the next insert
+     * returns nullptr if not
+     */
+    const Value* find(const KeyComparable& key) const override
+    {
+        Index found = find(key, root);
+        return (found != NIL) ? &values[found] : nullptr;
+    }
+
+    // find(key, founditem) copies the value out
+    using Base::find;
+
+    /*
+     * Returns true if the item is found in the tree
+     */
+    bool contains(const KeyComparable& key) const override
+    {
+        return find(key, root) != NIL;
+    }
+
+    /*
+     * Returns true if tree has no nodes
+     */
+    bool isEmpty() const override
+    {
+        return root == NIL;
+    }
+
+    /*
+     * Prints the inorder the tree to the stream out
+     */
+    void printTree(std::ostream& out = std::cout) const override
+    {
+        // Visit the nodes in order with an explicit stack of the
+        // ancestors whose left subtree is being visited
+        std::vector<Index> stack;
+        Index t = root;
+        while (t != NIL || !stack.empty())
+        {
+            while (t != NIL)
+            {
+                stack.push_back(t);
+                t = nodes[t].left;
+            }
+
+            t = stack.back();
+            stack.pop_back();
+            Base::printValue(out, values[t]);
+            out << "\n";
+            t = nodes[t].right;
+        }
+    }
+
+    /*
+     * Removes all nodes from the tree, and frees the arrays
+     */
+    void makeEmpty() override
+    {
+        std::vector<BinaryNode>().swap(nodes);
+        std::vector<Value>().swap(values);
+        root = NIL;
+        freeList = NIL;
+        count = 0;
+    }
+
+    /*
+     * Inserts a node into the tree
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    bool insert(Value value, KeyComparable key) override
+    {
+        return emplace(std::move(key), std::move(value));
+    }
+
+    /*
+     * Inserts a node into the tree, constructing its value from the
+     * given arguments
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    template <typename... Args>
+    bool emplace(KeyComparable key, Args&&... args)
+    {
+        // Find where the key belongs, keeping the parent's index rather
+        // than a link into the array, which allocating may move
+        Index parent = NIL;
+        Index t = root;
+        while (t != NIL && key != nodes[t].key)
+        {
+            parent = t;
+            t = (key < nodes[t].key) ? nodes[t].left : nodes[t].right;
+        }
+        if (t != NIL)
+        {
+            return false; // FAIL: key already exists
+        }
+
+        bool goesLeft = (parent != NIL) && key < nodes[parent].key;
+        Index node = allocate(std::move(key), std::forward<Args>(args)...);
+        if (parent == NIL)
+        {
+            root = node;
+        }
+        else if (goesLeft)
+        {
+            nodes[parent].left = node;
+        }
+        else
+        {
+            nodes[parent].right = node;
+        }
+
+        count++;
+        return true; // SUCCESS: node added
+    }
+
+    /*
+     * Removes the node with the key, if it is in the tree
+     */
+    void remove(const KeyComparable& key) override
+    {
+        Index& link = findLink(key);
+        if (link == NIL)
+        {
+            return; // FAIL: key not found
+        }
+        remove(link);
+    }
+
+    int getCount() const
+    {
+        return count;
+    }
+
+    /*
+     * Writes the tree to the stream out, to be read back by
+     * deserialize(): the number of nodes in the arrays, the root and the
+     * first freed node, then each node as its two child indices, its key
+     * and its value. Keys and values are written as writeItem() (in
+     * BSTInterface.h) does. Other types need the overload below.
+     */
+    void serialize(std::ostream& out) const
+    {
+        serialize(out, Base::template writeItem<KeyComparable>,
+                  Base::template writeItem<Value>);
+    }
+
+    /*
+     * Writes the tree as serialize(out) does, writing each key by
+     * calling writeKey(out, key) and each value by calling
+     * writeValue(out, value), such as an ID for a pointer value.
+     */
+    template <typename WriteKey, typename WriteValue>
+    void serialize(std::ostream& out, WriteKey writeKey,
+                   WriteValue writeValue) const
+    {
+        std::uint64_t size = nodes.size();
+        out.write(MAGIC, sizeof MAGIC);
+        out.write(reinterpret_cast<const char*>(&size), sizeof size);
+        out.write(reinterpret_cast<const char*>(&root), sizeof root);
+        out.write(reinterpret_cast<const char*>(&freeList),
+                  sizeof freeList);
+
+        for (std::size_t t = 0; t < nodes.size(); t++)
+        {
+            const BinaryNode& node = nodes[t];
+            out.write(reinterpret_cast<const char*>(&node.left),
+                      sizeof node.left);
+            out.write(reinterpret_cast<const char*>(&node.right),
+                      sizeof node.right);
+            writeKey(out, node.key);
+            writeValue(out, values[t]);
+        }
+    }
+
+    /*
+     * Replaces the tree with one read from the stream in, as written by
+     * serialize(out). The arrays come back as they were, so every node
+     * and every freed node keeps its index.
+     * Throws std::runtime_error if the stream ends early or does not
+     * hold a tree, leaving the tree empty.
+     */
+    void deserialize(std::istream& in)
+    {
+        deserialize(in, Base::template readItem<KeyComparable>,
+                    Base::template readItem<Value>);
+    }
+
+    /*
+     * Reads the tree as deserialize(in) does, reading each key by
+     * calling readKey(in) and each value by calling readValue(in), to
+     * undo serialize(out, writeKey, writeValue).
+     */
+    template <typename ReadKey, typename ReadValue>
+    void deserialize(std::istream& in, ReadKey readKey,
+                     ReadValue readValue)
+    {
+        makeEmpty();
+
+        char magic[sizeof MAGIC] = {};
+        std::uint64_t size = 0;
+        Index readRoot = NIL;
+        Index readFreeList = NIL;
+        in.read(magic, sizeof magic);
+        in.read(reinterpret_cast<char*>(&size), sizeof size);
+        in.read(reinterpret_cast<char*>(&readRoot), sizeof readRoot);
+        in.read(reinterpret_cast<char*>(&readFreeList),
+                sizeof readFreeList);
+        if (!in || !std::equal(magic, magic + sizeof magic, MAGIC) ||
+            size >= NIL)
+        {
+            throw std::runtime_error("CompactTree: not a tree");
+        }
+
+        try
+        {
+            // The size is not trusted for more than a bounded
+            // reservation: a corrupt one fails at the end of the stream
+            reserve(std::min<std::uint64_t>(size, 1 << 16));
+            for (std::uint64_t i = 0; i < size; i++)
+            {
+                Index left = NIL;
+                Index right = NIL;
+                in.read(reinterpret_cast<char*>(&left), sizeof left);
+                in.read(reinterpret_cast<char*>(&right), sizeof right);
+                KeyComparable key = readKey(in);
+                Value value = readValue(in);
+                if (!in)
+                {
+                    throw std::runtime_error(
+                        "CompactTree: stream ended or is corrupt");
+                }
+
+                nodes.push_back(BinaryNode{std::move(key), left, right});
+                values.push_back(std::move(value));
+            }
+
+            root = readRoot;
+            freeList = readFreeList;
+            count = checkLinks();
+        }
+        catch (...)
+        {
+            // FAIL: Drop what was read
+            makeEmpty();
+            throw;
+        }
+    }
+}; // end of CompactTree class
@@ -0,0 +1,778 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A binary search tree which many threads may search and
+// change at once.
+//
+// The tree is leaf-oriented (external): the keys and values are all in
+// the leaves, and each inner node holds a copy of the smallest key of
+// its right subtree to route searches. An insert replaces a leaf with a
+// new inner node over the old leaf and the new one. A remove replaces the
+// parent of a leaf with the leaf's sibling. Either way one child link
+// changes, with a single atomic store, so a search never sees the tree
+// half changed.
+//
+// Searches take no locks and never retry: they follow child links from
+// the top to a leaf. A writer locks only the one or two inner nodes
+// whose links it changes (each has a spin lock of its own), and checks
+// that they are still in the tree and still point where its search went;
+// if not, another writer got there first and it searches again. Writers
+// in different parts of the tree never wait for each other.
+//
+// The tree is kept balanced as a relaxed AVL tree. Each inner node holds
+// its height, and after a change the writer walks back up its search
+// path fixing heights, until one is unchanged. Where one side has grown
+// two taller than the other, it rotates. A rotation does not change the
+// nodes in place, which a search might be passing through: it builds
+// copies of the two or three inner nodes rotated, hangs them from the
+// parent's link in one store, and retires the originals. Heights may be
+// briefly out of date while writers race, but each writer repairs what
+// it changed, so sorted input, such as IDs handed out in order, keeps
+// the tree about as shallow as an AVLTree.
+//
+// Every lock is taken from the top down, parent before child, so writers
+// and rotations cannot deadlock. Unlinked nodes are freed through the
+// EpochReclaimer, once no search which could still be looking at them is
+// left.
+///
+
+#pragma once
+
+#include "BSTInterface.h"
+#include "EpochReclaimer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+template <typename KeyComparable, typename Value>
+class ConcurrentTree : public BSTInterface<KeyComparable, Value>
+{
+    using Base = BSTInterface<KeyComparable, Value>;
+
+  public:
+    using typename Base::ValueHandle;
+
+  private:
+    /*
+     * A lock of one byte, so that inner nodes stay small. Writers hold it
+     * only to check and change a link or two, so a waiting writer yields
+     * its time slice instead of sleeping.
+     */
+    class SpinLock
+    {
+      private:
+        std::atomic<bool> locked{false};
+
+      public:
+        void lock()
+        {
+            while (locked.exchange(true, std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        void unlock()
+        {
+            locked.store(false, std::memory_order_release);
+        }
+    };
+
+    /*
+     * Private Node Classes
+     * A Node is a Leaf or an Inner node, as isLeaf says.
+     */
+    class Node
+    {
+      public:
+        KeyComparable key;
+        bool isLeaf;
+
+        Node(KeyComparable key, bool isLeaf)
+            : key{std::move(key)}, isLeaf{isLeaf}
+        {
+        }
+    };
+
+    class Leaf : public Node
+    {
+      public:
+        Value value;
+
+        // The value is constructed in place from the remaining arguments
+        template <typename... Args>
+        explicit Leaf(KeyComparable key, Args&&... args)
+            : Node{std::move(key), true},
+              value(std::forward<Args>(args)...)
+        {
+        }
+    };
+
+    class Inner : public Node
+    {
+      public:
+        // keys less than this node's key are on the left
+        std::atomic<Node*> left;
+        std::atomic<Node*> right;
+
+        // the height of the subtree, a leaf being 0, as last fixed
+        std::atomic<int> height;
+
+        // held while the links, height or removed change
+        SpinLock mutex;
+
+        // true once the node is unlinked from the tree
+        bool removed = false;
+
+        Inner(KeyComparable key, Node* left, Node* right)
+            : Node{std::move(key), false}, left{left}, right{right},
+              height{1 + std::max(heightOf(left), heightOf(right))}
+        {
+        }
+
+        /*
+         * Returns the link to the child on the key's side
+         */
+        std::atomic<Node*>& childFor(const KeyComparable& key)
+        {
+            return (key < this->key) ? left : right;
+        }
+    };
+
+    // the link to the first node of the tree
+    std::atomic<Node*> top{nullptr};
+
+    // held while top changes
+    SpinLock topMutex;
+
+    static bool sameKey(const KeyComparable& key, const Node* node)
+    {
+        return !(key < node->key) && !(node->key < key);
+    }
+
+    /*
+     * Returns the height of the subtree, as last fixed
+     */
+    static int heightOf(const Node* node)
+    {
+        if (!node || node->isLeaf)
+        {
+            return 0;
+        }
+        auto* inner = static_cast<const Inner*>(node);
+        return inner->height.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * Returns the link out of the inner node (or the top) to the key's
+     * side
+     */
+    std::atomic<Node*>& linkFor(Inner* node, const KeyComparable& key)
+    {
+        return node ? node->childFor(key) : top;
+    }
+
+    SpinLock& mutexOf(Inner* node)
+    {
+        return node ? node->mutex : topMutex;
+    }
+
+    /*
+     * Returns true if the inner node has been unlinked. The top is never
+     * unlinked. The node's mutex must be held.
+     */
+    static bool isRemoved(const Inner* node)
+    {
+        return node && node->removed;
+    }
+
+    /*
+     * Follows the links from the top to the leaf where the key is or
+     * would be, and returns it (nullptr only if the tree is empty). The
+     * caller must hold a Guard.
+     */
+    Node* search(const KeyComparable& key) const
+    {
+        Node* t = top.load(std::memory_order_acquire);
+        while (t && !t->isLeaf)
+        {
+            t = static_cast<Inner*>(t)->childFor(key).load(
+                std::memory_order_acquire);
+        }
+        return t;
+    }
+
+    /*
+     * Searches as search() does, filling ancestors with the inner nodes
+     * passed on the way, the top one first. The caller must hold a Guard.
+     */
+    Node* search(const KeyComparable& key, std::vector<Inner*>& ancestors)
+    {
+        ancestors.clear();
+        Node* t = top.load(std::memory_order_acquire);
+        while (t && !t->isLeaf)
+        {
+            ancestors.push_back(static_cast<Inner*>(t));
+            t = ancestors.back()->childFor(key).load(
+                std::memory_order_acquire);
+        }
+        return t;
+    }
+
+    /*
+     * Returns the link out of the parent (or the top) which holds the
+     * node, or nullptr if the node is no longer its child. The parent's
+     * mutex must be held.
+     */
+    std::atomic<Node*>* linkTo(Inner* parent, const Node* node)
+    {
+        if (!parent)
+        {
+            return (top.load(std::memory_order_relaxed) == node) ? &top
+                                                                 : nullptr;
+        }
+        if (parent->left.load(std::memory_order_relaxed) == node)
+        {
+            return &parent->left;
+        }
+        if (parent->right.load(std::memory_order_relaxed) == node)
+        {
+            return &parent->right;
+        }
+        return nullptr;
+    }
+
+    /*
+     * Replaces the node, one side of which is two taller than the other,
+     * with copies of it and the nodes rotated with it, hung from the link
+     * in one store. The originals are marked removed and retired, so
+     * searches already in them still reach every key, and writers which
+     * locked them search again. The locks of the link's owner and of the
+     * node must be held.
+     */
+    void rotate(std::atomic<Node*>& link, Inner* node, bool leftHeavy)
+    {
+        // The taller side is at least 2 high, so is an inner node
+        auto* child = static_cast<Inner*>(
+            (leftHeavy ? node->left : node->right)
+                .load(std::memory_order_relaxed));
+        std::lock_guard<SpinLock> childLock(child->mutex);
+
+        // the child's subtrees on the outside and inside of the tree
+        Node* outer = (leftHeavy ? child->left : child->right)
+                          .load(std::memory_order_relaxed);
+        Node* inner = (leftHeavy ? child->right : child->left)
+                          .load(std::memory_order_relaxed);
+        Node* left = node->left.load(std::memory_order_relaxed);
+        Node* right = node->right.load(std::memory_order_relaxed);
+
+        if (heightOf(inner) <= heightOf(outer))
+        {
+            // Single rotation: the child comes up, and the node takes
+            // the child's inside subtree
+            Inner* lowered = leftHeavy
+                                 ? new Inner(node->key, inner, right)
+                                 : new Inner(node->key, left, inner);
+            link.store(leftHeavy ? new Inner(child->key, outer, lowered)
+                                 : new Inner(child->key, lowered, outer),
+                       std::memory_order_release);
+        }
+        else
+        {
+            // Double rotation: the child's inside child, 1 or more high
+            // so an inner node, comes up between the child and the node
+            auto* grandchild = static_cast<Inner*>(inner);
+            std::lock_guard<SpinLock> grandchildLock(grandchild->mutex);
+            Node* innerLeft =
+                grandchild->left.load(std::memory_order_relaxed);
+            Node* innerRight =
+                grandchild->right.load(std::memory_order_relaxed);
+
+            Inner* lower = nullptr;
+            Inner* upper = nullptr;
+            if (leftHeavy)
+            {
+                lower = new Inner(child->key, outer, innerLeft);
+                upper = new Inner(node->key, innerRight, right);
+            }
+            else
+            {
+                lower = new Inner(node->key, left, innerLeft);
+                upper = new Inner(child->key, innerRight, outer);
+            }
+            link.store(new Inner(grandchild->key, lower, upper),
+                       std::memory_order_release);
+
+            grandchild->removed = true;
+            retire(grandchild);
+        }
+
+        child->removed = true;
+        node->removed = true;
+        retire(child);
+        retire(node);
+    }
+
+    /*
+     * Fixes the height of the node, a child of the parent (or the top),
+     * rotating it if it is out of balance.
+     * returns true if its height changed or it was rotated, so that the
+     * parent needs fixing too
+     * returns false if it was unchanged, or is no longer in the tree
+     */
+    bool fixNode(Inner* parent, Inner* node)
+    {
+        std::lock_guard<SpinLock> parentLock(mutexOf(parent));
+        std::atomic<Node*>* link = linkTo(parent, node);
+        if (isRemoved(parent) || !link)
+        {
+            return false; // FAIL: Moved by another writer, who fixes it
+        }
+
+        std::lock_guard<SpinLock> nodeLock(node->mutex);
+        int leftHeight =
+            heightOf(node->left.load(std::memory_order_relaxed));
+        int rightHeight =
+            heightOf(node->right.load(std::memory_order_relaxed));
+        if (leftHeight - rightHeight > 1 || rightHeight - leftHeight > 1)
+        {
+            rotate(*link, node, leftHeight > rightHeight);
+            return true; // SUCCESS: Rotated
+        }
+
+        int height = 1 + std::max(leftHeight, rightHeight);
+        if (node->height.load(std::memory_order_relaxed) == height)
+        {
+            return false; // RETURN: Nothing above changes
+        }
+        node->height.store(height, std::memory_order_relaxed);
+        return true;
+    }
+
+    /*
+     * Fixes the first count ancestors from a search, from the lowest of
+     * them up to the top, until one is unchanged. The caller must hold a
+     * Guard.
+     */
+    void rebalance(const std::vector<Inner*>& ancestors, std::size_t count)
+    {
+        std::size_t i = count;
+        while (i-- > 0)
+        {
+            Inner* parent = (i > 0) ? ancestors[i - 1] : nullptr;
+            if (!fixNode(parent, ancestors[i]))
+            {
+                return; // RETURN: Balanced from here up
+            }
+        }
+    }
+
+    /*
+     * Puts the leaf's sibling in the place of its parent, if the parent
+     * still hangs from the grandparent (or the top) and holds the leaf.
+     * returns true if the leaf was unlinked
+     */
+    bool unlinkLeaf(Inner* grandparent, Inner* parent, Node* leaf,
+                    const KeyComparable& key)
+    {
+        // Lock from the top down, as every writer does
+        std::lock_guard<SpinLock> outer(mutexOf(grandparent));
+        std::lock_guard<SpinLock> inner(parent->mutex);
+
+        std::atomic<Node*>& link = linkFor(grandparent, key);
+        std::atomic<Node*>& leafLink = parent->childFor(key);
+        if (isRemoved(grandparent) || parent->removed ||
+            link.load(std::memory_order_relaxed) != parent ||
+            leafLink.load(std::memory_order_relaxed) != leaf)
+        {
+            return false; // FAIL: Changed since the search
+        }
+
+        std::atomic<Node*>& siblingLink =
+            (&leafLink == &parent->left) ? parent->right : parent->left;
+        link.store(siblingLink.load(std::memory_order_relaxed),
+                   std::memory_order_release);
+        parent->removed = true;
+
+        retire(parent);
+        retire(leaf);
+        return true; // SUCCESS: leaf unlinked
+    }
+
+    /*
+     * Returns the leaf with the key, nullptr if it is not in the tree.
+     * The caller must hold a Guard.
+     */
+    const Leaf* findLeaf(const KeyComparable& key) const
+    {
+        const Node* leaf = search(key);
+        if (!leaf || !sameKey(key, leaf))
+        {
+            return nullptr; // FAIL: key not found
+        }
+        return static_cast<const Leaf*>(leaf);
+    }
+
+    /*
+     * Returns the leftmost or rightmost leaf, nullptr if the tree is
+     * empty. The caller must hold a Guard.
+     */
+    const Leaf* findEnd(std::atomic<Node*> Inner::*side) const
+    {
+        const Node* t = top.load(std::memory_order_acquire);
+        while (t && !t->isLeaf)
+        {
+            auto* inner = static_cast<const Inner*>(t);
+            t = (inner->*side).load(std::memory_order_acquire);
+        }
+        return static_cast<const Leaf*>(t);
+    }
+
+    static void retire(Node* node)
+    {
+        if (node->isLeaf)
+        {
+            EpochReclaimer::retire(static_cast<Leaf*>(node));
+        }
+        else
+        {
+            EpochReclaimer::retire(static_cast<Inner*>(node));
+        }
+    }
+
+  public:
+    ConcurrentTree() = default;
+
+    // The tree owns its nodes, so it cannot be copied
+    ConcurrentTree(const ConcurrentTree&) = delete;
+    ConcurrentTree& operator=(const ConcurrentTree&) = delete;
+
+    /*
+     * DESTRUCTOR
+     * No other thread may be using the tree
+     */
+    ~ConcurrentTree()
+    {
+        std::vector<Node*> stack;
+        if (Node* t = top.load())
+        {
+            stack.push_back(t);
+        }
+
+        while (!stack.empty())
+        {
+            Node* t = stack.back();
+            stack.pop_back();
+            if (t->isLeaf)
+            {
+                delete static_cast<Leaf*>(t);
+            }
+            else
+            {
+                auto* inner = static_cast<Inner*>(t);
+                stack.push_back(inner->left.load());
+                stack.push_back(inner->right.load());
+                delete inner;
+            }
+        }
+    }
+
+    /*
+     * Finds the node with the smallest element in the tree. For inline
+     * values the handle is only safe to use while the key cannot be
+     * removed, or while the caller holds a Guard.
+     */
+    ValueHandle findMin() const override
+    {
+        EpochReclaimer::Guard guard;
+        const Leaf* found = findEnd(&Inner::left);
+        return found ? Base::toHandle(found->value) : nullptr;
+    }
+
+    /*
+     * Finds the node with the largest element in the tree (see findMin)
+     */
+    ValueHandle findMax() const override
+    {
+        EpochReclaimer::Guard guard;
+        const Leaf* found = findEnd(&Inner::right);
+        return found ? Base::toHandle(found->value) : nullptr;
+    }
+
+    /*
+     * Finds the node with the key
+     * returns a pointer to its value in the tree if found, which is only
+     * safe to use while the key cannot be removed, or while the caller
+     * holds an EpochReclaimer::Guard
+     * returns nullptr if not
+     */
+    const Value* find(const KeyComparable& key) const override
+    {
+        EpochReclaimer::Guard guard;
+        const Leaf* found = findLeaf(key);
+        return found ? &found->value : nullptr;
+    }
+
+    /*
+     * Copies the value with the given key into itemFound, before the key
+     * can be removed.
+     * Returns true if it was found, false otherwise.
+     */
+    bool find(const KeyComparable& key, Value& itemFound) const
+    {
+        EpochReclaimer::Guard guard;
+        const Leaf* found = findLeaf(key);
+        if (found)
+        {
+            itemFound = found->value;
+        }
+        return found != nullptr;
+    }
+
+    /*
+     * Returns true if the item is found in the tree
+     */
+    bool contains(const KeyComparable& key) const override
+    {
+        EpochReclaimer::Guard guard;
+        return findLeaf(key) != nullptr;
+    }
+
+    /*
+     * Returns true if tree has no nodes
+     */
+    bool isEmpty() const override
+    {
+        return top.load(std::memory_order_acquire) == nullptr;
+    }
+
+    /*
+     * Prints the inorder the tree to the stream out. Keys inserted or
+     * removed while it prints may or may not be shown.
+     */
+    void printTree(std::ostream& out = std::cout) const override
+    {
+        EpochReclaimer::Guard guard;
+
+        // Visit the leaves from left to right with an explicit stack of
+        // the subtrees still to visit
+        std::vector<const Node*> stack;
+        if (const Node* t = top.load(std::memory_order_acquire))
+        {
+            stack.push_back(t);
+        }
+
+        while (!stack.empty())
+        {
+            const Node* t = stack.back();
+            stack.pop_back();
+            if (t->isLeaf)
+            {
+                Base::printValue(out, static_cast<const Leaf*>(t)->value);
+                out << "\n";
+            }
+            else
+            {
+                auto* inner = static_cast<const Inner*>(t);
+                stack.push_back(
+                    inner->right.load(std::memory_order_acquire));
+                stack.push_back(
+                    inner->left.load(std::memory_order_acquire));
+            }
+        }
+    }
+
+    /*
+     * Removes all nodes from the tree
+     */
+    void makeEmpty() override
+    {
+        EpochReclaimer::Guard guard;
+
+        Node* detached = nullptr;
+        {
+            std::lock_guard<SpinLock> lock(topMutex);
+            detached = top.exchange(nullptr);
+        }
+
+        // Writers may still be working in the detached nodes. Marking
+        // each inner node removed, under its lock, stops them before its
+        // links are read.
+        std::vector<Node*> stack;
+        if (detached)
+        {
+            stack.push_back(detached);
+        }
+
+        while (!stack.empty())
+        {
+            Node* t = stack.back();
+            stack.pop_back();
+            if (!t->isLeaf)
+            {
+                auto* inner = static_cast<Inner*>(t);
+                std::lock_guard<SpinLock> lock(inner->mutex);
+                inner->removed = true;
+                stack.push_back(inner->left.load());
+                stack.push_back(inner->right.load());
+            }
+            retire(t);
+        }
+    }
+
+    /*
+     * Inserts a node into the tree
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    bool insert(Value value, KeyComparable key) override
+    {
+        return emplace(std::move(key), std::move(value));
+    }
+
+    /*
+     * Inserts a node into the tree, constructing its value in place from
+     * the given arguments
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    template <typename... Args>
+    bool emplace(KeyComparable key, Args&&... args)
+    {
+        EpochReclaimer::Guard guard;
+
+        // built on the first try, and kept if another writer wins
+        Leaf* leaf = nullptr;
+        std::vector<Inner*> ancestors;
+        while (true)
+        {
+            Node* found = search(key, ancestors);
+            Inner* parent = ancestors.empty() ? nullptr : ancestors.back();
+            if (found && sameKey(key, found))
+            {
+                delete leaf;
+                return false; // FAIL: key already exists
+            }
+
+            if (!leaf)
+            {
+                leaf = new Leaf(key, std::forward<Args>(args)...);
+            }
+
+            // The new leaf and the old one go under a new inner node,
+            // keyed by the larger of the two
+            Inner* fork = nullptr;
+            if (found)
+            {
+                fork = (key < found->key)
+                           ? new Inner(found->key, leaf, found)
+                           : new Inner(key, found, leaf);
+            }
+
+            bool linked = false;
+            {
+                std::lock_guard<SpinLock> lock(mutexOf(parent));
+                std::atomic<Node*>& link = linkFor(parent, key);
+                if (!isRemoved(parent) &&
+                    link.load(std::memory_order_relaxed) == found)
+                {
+                    Node* replacement = fork;
+                    if (!replacement)
+                    {
+                        replacement = leaf; // The tree was empty
+                    }
+                    link.store(replacement, std::memory_order_release);
+                    linked = true;
+                }
+            }
+
+            if (linked)
+            {
+                // The fork is one higher than the leaf it replaced
+                rebalance(ancestors, ancestors.size());
+                return true; // SUCCESS: node added
+            }
+
+            // Another writer changed the link first. No reader saw the
+            // fork, so it can go straight away.
+            delete fork;
+        }
+    }
+
+    /*
+     * Removes the node with the key, if it is in the tree
+     */
+    void remove(const KeyComparable& key) override
+    {
+        EpochReclaimer::Guard guard;
+        std::vector<Inner*> ancestors;
+        while (true)
+        {
+            Node* leaf = search(key, ancestors);
+            if (!leaf || !sameKey(key, leaf))
+            {
+                return; // FAIL: key not found
+            }
+
+            // The only leaf hangs from the top
+            if (ancestors.empty())
+            {
+                std::lock_guard<SpinLock> lock(topMutex);
+                if (top.load(std::memory_order_relaxed) == leaf)
+                {
+                    top.store(nullptr, std::memory_order_release);
+                    retire(leaf);
+                    return; // SUCCESS: node removed
+                }
+                continue;
+            }
+
+            Inner* parent = ancestors.back();
+            Inner* grandparent = (ancestors.size() > 1)
+                                     ? ancestors[ancestors.size() - 2]
+                                     : nullptr;
+            if (unlinkLeaf(grandparent, parent, leaf, key))
+            {
+                // The grandparent lost a level on one side
+                rebalance(ancestors, ancestors.size() - 1);
+                return; // SUCCESS: node removed
+            }
+            // Another writer got there first
+        }
+    }
+
+    /*
+     * Returns the number of levels in the tree, leaves included, 0 if it
+     * is empty. No other thread may be changing the tree.
+     */
+    int getHeight() const
+    {
+        int height = 0;
+        std::vector<std::pair<const Node*, int>> stack;
+        if (const Node* t = top.load(std::memory_order_acquire))
+        {
+            stack.emplace_back(t, 1);
+        }
+
+        while (!stack.empty())
+        {
+            auto [t, depth] = stack.back();
+            stack.pop_back();
+            height = std::max(height, depth);
+            if (!t->isLeaf)
+            {
+                auto* inner = static_cast<const Inner*>(t);
+                stack.emplace_back(inner->left.load(), depth + 1);
+                stack.emplace_back(inner->right.load(), depth + 1);
+            }
+        }
+        return height;
+    }
+}; // end of ConcurrentTree class
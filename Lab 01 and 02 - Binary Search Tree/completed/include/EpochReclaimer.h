@@ -0,0 +1,69 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: Epoch-based memory reclamation, for trees whose readers
+// take no locks.
+//
+// A reader that takes no lock may still be looking at a node which a
+// writer has just unlinked, so the writer cannot free the node straight
+// away. Instead it retires the node, and the node is freed only once
+// every thread that could have seen it has moved on.
+//
+// Threads announce when they are reading by holding a Guard. A global
+// epoch counter goes up by one only when every thread holding a Guard has
+// seen the current epoch. A node retired in epoch e was unlinked before
+// any Guard taken in epoch e + 1 began, so once the epoch reaches e + 2
+// no reader can reach the node and it is freed.
+//
+// There is one epoch for the whole program, shared by every tree. Each
+// thread keeps its own list of retired objects. A thread which exits
+// hands what is left of its list to the others.
+///
+
+#pragma once
+
+#include <cstddef>
+
+class EpochReclaimer
+{
+  public:
+    // at most this many threads may hold a Guard at once
+    static constexpr std::size_t MAX_THREADS = 1024;
+
+    /*
+     * Marks the calling thread as reading for as long as it lives.
+     * Guards may be nested.
+     */
+    class Guard
+    {
+      public:
+        Guard();
+        ~Guard();
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    /*
+     * Deletes the object once no Guard which could have seen it is left.
+     * It must already be unreachable by new readers.
+     */
+    template <typename T> static void retire(T* object)
+    {
+        retire(object, [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    /*
+     * Calls deleter(object) once no Guard which could have seen the
+     * object is left
+     */
+    static void retire(void* object, void (*deleter)(void*));
+
+    /*
+     * Advances the epoch if it can, and frees the retired objects which
+     * are now safe to free
+     */
+    static void collect();
+};
@@ -0,0 +1,158 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: Allocates the nodes of a tree from large slabs, reusing
+// freed nodes through a free list.
+//
+// Allocating every node with new costs a call to malloc per insert and
+// scatters the nodes over the heap. The arena hands out consecutive
+// slots of a slab instead, so nodes inserted together sit together in
+// memory, and the whole arena is released slab by slab.
+///
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+template <typename Node> class NodeArena
+{
+  public:
+    // the first slab holds this many nodes; each one after holds twice
+    // as many as the last, up to MAX_SLAB_NODES
+    static constexpr std::size_t MIN_SLAB_NODES = 32;
+    static constexpr std::size_t MAX_SLAB_NODES = 4096;
+
+  private:
+    /*
+     * Room for one node, or the link to the next free slot once the node
+     * is destroyed.
+     */
+    union Slot
+    {
+        Slot* next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+
+    // slots of the last slab not yet handed out
+    Slot* unused = nullptr;
+    std::size_t unusedCount = 0;
+
+    // slots handed out and then freed
+    Slot* freeList = nullptr;
+
+    // size of the next slab
+    std::size_t slabNodes = MIN_SLAB_NODES;
+
+    /*
+     * Returns a slot for a new node, taking it from the free list if
+     * there is one, or else from the current slab, allocating a new slab
+     * when that is used up.
+     */
+    Slot* takeSlot()
+    {
+        if (this->freeList)
+        {
+            Slot* slot = this->freeList;
+            this->freeList = slot->next;
+            return slot; // SUCCESS: Reused a freed slot
+        }
+
+        if (this->unusedCount == 0)
+        {
+            this->slabs.emplace_back(new Slot[this->slabNodes]);
+            this->unused = this->slabs.back().get();
+            this->unusedCount = this->slabNodes;
+            this->slabNodes =
+                std::min(2 * this->slabNodes, MAX_SLAB_NODES);
+        }
+
+        this->unusedCount--;
+        return this->unused++;
+    }
+
+  public:
+    NodeArena() = default;
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    /*
+     * Constructs a node from the given arguments and returns it.
+     */
+    template <typename... Args> Node* create(Args&&... args)
+    {
+        Slot* slot = takeSlot();
+        try
+        {
+            return ::new (slot->storage) Node(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            // FAIL: The node could not be constructed
+            slot->next = this->freeList;
+            this->freeList = slot;
+            throw;
+        }
+    }
+
+    /*
+     * Destroys a node from this arena, keeping its slot for the next
+     * node created.
+     */
+    void destroy(Node* node) noexcept
+    {
+        node->~Node();
+
+        auto* slot = reinterpret_cast<Slot*>(node);
+        slot->next = this->freeList;
+        this->freeList = slot;
+    }
+
+    /*
+     * Makes sure the next n nodes created, if no freed slot is waiting,
+     * come from one slab and so sit side by side in memory. What is left
+     * of the current slab is not used. (On the free list it would be
+     * taken before the new slab.)
+     */
+    void reserve(std::size_t n)
+    {
+        if (this->unusedCount >= n)
+        {
+            return; // RETURN: The current slab has room
+        }
+
+        this->slabs.emplace_back(new Slot[n]);
+        this->unused = this->slabs.back().get();
+        this->unusedCount = n;
+    }
+
+    /*
+     * Frees every slab at once. Nodes still in use are not destroyed, so
+     * the owner must first destroy any which need it.
+     */
+    void release() noexcept
+    {
+        this->slabs.clear();
+        this->unused = nullptr;
+        this->unusedCount = 0;
+        this->freeList = nullptr;
+        this->slabNodes = MIN_SLAB_NODES;
+    }
+
+    /*
+     * Returns the number of slabs allocated.
+     */
+    [[nodiscard]] std::size_t getSlabCount() const noexcept
+    {
+        return this->slabs.size();
+    }
+};
@@ -0,0 +1,447 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A persistent binary search tree, whose old versions stay
+// readable after it changes.
+//
+// Nodes are never changed once built. An insert or remove copies only the
+// nodes on the path to the key, O(log n) of them, and the new path shares
+// every other subtree with the version before. Nodes are reference
+// counted, so a node is freed once no version uses it.
+//
+// snapshot() takes the current version in O(1) time. A Snapshot can be
+// searched from any thread while the tree goes on changing: it never
+// waits for a writer and never sees a change half made. Writers take
+// turns through a mutex; each publishes its new version with a single
+// atomic store.
+//
+// The tree is balanced as a treap (see Treap.h), with the random
+// priorities stored in the nodes. Values are copied along with their
+// nodes, so they must be copyable.
+///
+
+#pragma once
+
+#include "BSTInterface.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+template <typename KeyComparable, typename Value>
+class PersistentTree : public BSTInterface<KeyComparable, Value>
+{
+    using Base = BSTInterface<KeyComparable, Value>;
+
+  public:
+    using typename Base::ValueHandle;
+
+  private:
+    class BinaryNode;
+    using NodePtr = std::shared_ptr<const BinaryNode>;
+
+    /*
+     * Private BinaryNode Class
+     * Nodes are only ever reached through a NodePtr, so they cannot
+     * change after they are built.
+     */
+    class BinaryNode
+    {
+      public:
+        KeyComparable key;
+        Value value;
+
+        NodePtr left;
+        NodePtr right;
+
+        // no node has a higher priority than its parent
+        std::uint32_t priority;
+
+        // number of nodes in the subtree rooted here
+        int size;
+
+        BinaryNode(KeyComparable key, Value value, std::uint32_t priority,
+                   NodePtr left, NodePtr right)
+            : key{std::move(key)}, value(std::move(value)),
+              left{std::move(left)}, right{std::move(right)},
+              priority{priority},
+              size{1 + sizeOf(this->left) + sizeOf(this->right)}
+        {
+        }
+    };
+
+    // the current version
+    NodePtr root;
+
+    // serializes writers
+    mutable std::mutex writeMutex;
+
+    // source of node priorities
+    std::minstd_rand rng{std::random_device{}()};
+
+    static int sizeOf(const NodePtr& t)
+    {
+        return t ? t->size : 0;
+    }
+
+    /*
+     * Returns a copy of node t with the given children
+     */
+    static NodePtr withChildren(const NodePtr& t, NodePtr left,
+                                NodePtr right)
+    {
+        return std::make_shared<const BinaryNode>(
+            t->key, t->value, t->priority, std::move(left),
+            std::move(right));
+    }
+
+    /*
+     * Splits the subtree into the keys less than the given key and those
+     * greater, copying the nodes on the path. The key must not be in the
+     * subtree.
+     */
+    static std::pair<NodePtr, NodePtr> split(const NodePtr& t,
+                                             const KeyComparable& key)
+    {
+        if (!t)
+        {
+            return {}; // RETURN: Nothing to split
+        }
+
+        if (t->key < key)
+        {
+            auto [less, greater] = split(t->right, key);
+            return {withChildren(t, t->left, std::move(less)),
+                    std::move(greater)};
+        }
+
+        auto [less, greater] = split(t->left, key);
+        return {std::move(less),
+                withChildren(t, std::move(greater), t->right)};
+    }
+
+    /*
+     * Joins two subtrees, where every key of left is less than every key
+     * of right, copying the nodes on their facing spines
+     */
+    static NodePtr join(const NodePtr& left, const NodePtr& right)
+    {
+        if (!left || !right)
+        {
+            return left ? left : right; // RETURN: Nothing to join
+        }
+
+        if (right->priority < left->priority)
+        {
+            return withChildren(left, left->left,
+                                join(left->right, right));
+        }
+        return withChildren(right, join(left, right->left), right->right);
+    }
+
+    /*
+     * Returns the subtree with the key added, copying the nodes on the
+     * path. The key must not be in the subtree.
+     */
+    static NodePtr insert(const NodePtr& t, KeyComparable& key,
+                          Value& value, std::uint32_t priority)
+    {
+        // The new node goes above any node with a lower priority, taking
+        // the subtree there split around its key
+        if (!t || t->priority < priority)
+        {
+            auto [less, greater] = split(t, key);
+            return std::make_shared<const BinaryNode>(
+                std::move(key), std::move(value), priority,
+                std::move(less), std::move(greater));
+        }
+
+        if (key < t->key)
+        {
+            return withChildren(t, insert(t->left, key, value, priority),
+                                t->right);
+        }
+        return withChildren(t, t->left,
+                            insert(t->right, key, value, priority));
+    }
+
+    /*
+     * Returns the subtree with the key removed, copying the nodes on the
+     * path. The key must be in the subtree.
+     */
+    static NodePtr remove(const NodePtr& t, const KeyComparable& key)
+    {
+        if (key < t->key)
+        {
+            return withChildren(t, remove(t->left, key), t->right);
+        }
+        if (t->key < key)
+        {
+            return withChildren(t, t->left, remove(t->right, key));
+        }
+
+        // Its two subtrees take its place
+        return join(t->left, t->right);
+    }
+
+    /*
+     * Finds the node with that satisfies equality for the element
+     */
+    static const BinaryNode* find(const KeyComparable& key,
+                                  const BinaryNode* node)
+    {
+        while (node && (node->key < key || key < node->key))
+        {
+            node = (key < node->key) ? node->left.get()
+                                     : node->right.get();
+        }
+        return node;
+    }
+
+    /*
+     * Prints the inorder the subtree to the stream out
+     */
+    static void printTree(const BinaryNode* t, std::ostream& out)
+    {
+        // Visit the nodes in order with an explicit stack of the
+        // ancestors whose left subtree is being visited
+        std::vector<const BinaryNode*> stack;
+        while (t || !stack.empty())
+        {
+            while (t)
+            {
+                stack.push_back(t);
+                t = t->left.get();
+            }
+
+            t = stack.back();
+            stack.pop_back();
+            Base::printValue(out, t->value);
+            out << "\n";
+            t = t->right.get();
+        }
+    }
+
+    /*
+     * Returns the current version
+     */
+    NodePtr load() const
+    {
+        return std::atomic_load(&root);
+    }
+
+  public:
+    /*
+     * A read-only view of one version of the tree. It keeps the nodes of
+     * that version alive, and does not change when the tree does.
+     */
+    class Snapshot
+    {
+      private:
+        friend class PersistentTree;
+
+        NodePtr root;
+
+        explicit Snapshot(NodePtr root) : root{std::move(root)}
+        {
+        }
+
+      public:
+        Snapshot() = default;
+
+        /*
+         * Finds the node with the key
+         * returns a pointer to its value, valid as long as the snapshot
+         * returns nullptr if not found
+         */
+        const Value* find(const KeyComparable& key) const
+        {
+            const BinaryNode* found =
+                PersistentTree::find(key, root.get());
+            return found ? &found->value : nullptr;
+        }
+
+        /*
+         * Returns true if the item is found in the snapshot
+         */
+        bool contains(const KeyComparable& key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        /*
+         * Finds the node with the smallest element in the snapshot
+         */
+        ValueHandle findMin() const
+        {
+            const BinaryNode* t = root.get();
+            while (t && t->left)
+            {
+                t = t->left.get();
+            }
+            return t ? Base::toHandle(t->value) : nullptr;
+        }
+
+        /*
+         * Finds the node with the largest element in the snapshot
+         */
+        ValueHandle findMax() const
+        {
+            const BinaryNode* t = root.get();
+            while (t && t->right)
+            {
+                t = t->right.get();
+            }
+            return t ? Base::toHandle(t->value) : nullptr;
+        }
+
+        bool isEmpty() const
+        {
+            return root == nullptr;
+        }
+
+        /*
+         * Prints the inorder the snapshot to the stream out
+         */
+        void printTree(std::ostream& out = std::cout) const
+        {
+            PersistentTree::printTree(root.get(), out);
+        }
+
+        int getCount() const
+        {
+            return sizeOf(root);
+        }
+    };
+
+    PersistentTree() = default;
+
+    /*
+     * CONSTRUCTOR
+     * Starts from a snapshot of another tree, sharing all of its nodes
+     */
+    explicit PersistentTree(const Snapshot& from) : root{from.root}
+    {
+    }
+
+    // Copy a tree through a snapshot instead
+    PersistentTree(const PersistentTree&) = delete;
+    PersistentTree& operator=(const PersistentTree&) = delete;
+
+    /*
+     * Returns the current version of the tree, in O(1) time. May be
+     * called from any thread.
+     */
+    Snapshot snapshot() const
+    {
+        return Snapshot(load());
+    }
+
+    /*
+     * Finds the node with the smallest element in the tree
+     */
+    ValueHandle findMin() const override
+    {
+        return snapshot().findMin();
+    }
+
+    /*
+     * Finds the node with the largest element in the tree
+     */
+    ValueHandle findMax() const override
+    {
+        return snapshot().findMax();
+    }
+
+    /*
+     * Finds the node with the key
+     * returns a pointer to its value in the tree if found, which is only
+     * valid until the tree next changes (search a snapshot instead from
+     * other threads)
+     * returns nullptr if not
+     */
+    const Value* find(const KeyComparable& key) const override
+    {
+        const BinaryNode* found = find(key, load().get());
+        return found ? &found->value : nullptr;
+    }
+
+    // find(key, founditem) copies the value out
+    using Base::find;
+
+    /*
+     * Returns true if the item is found in the tree
+     */
+    bool contains(const KeyComparable& key) const override
+    {
+        return find(key, load().get()) != nullptr;
+    }
+
+    /*
+     * Returns true if tree has no nodes
+     */
+    bool isEmpty() const override
+    {
+        return load() == nullptr;
+    }
+
+    /*
+     * Prints the inorder the tree to the stream out
+     */
+    void printTree(std::ostream& out = std::cout) const override
+    {
+        snapshot().printTree(out);
+    }
+
+    /*
+     * Removes all nodes from the tree. Snapshots keep theirs.
+     */
+    void makeEmpty() override
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        std::atomic_store(&root, NodePtr());
+    }
+
+    /*
+     * Inserts a node into a new version of the tree
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    bool insert(Value value, KeyComparable key) override
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        if (find(key, root.get()))
+        {
+            return false; // FAIL: key already exists
+        }
+
+        auto priority = static_cast<std::uint32_t>(rng());
+        std::atomic_store(&root, insert(root, key, value, priority));
+        return true; // SUCCESS: node added
+    }
+
+    /*
+     * Removes the node with the key, if it is in the tree, from a new
+     * version of the tree
+     */
+    void remove(const KeyComparable& key) override
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        if (!find(key, root.get()))
+        {
+            return; // FAIL: key not found
+        }
+
+        std::atomic_store(&root, remove(root, key));
+    }
+
+    int getCount() const
+    {
+        return sizeOf(load());
+    }
+}; // end of PersistentTree class
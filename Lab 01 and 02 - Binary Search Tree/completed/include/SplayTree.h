@@ -0,0 +1,360 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A self-adjusting (splay) binary search tree.
+//
+// Every lookup, insert and remove moves the node it reaches to the root
+// by a series of rotations (a "splay"), roughly halving the depth of
+// every node on the way. Keys used often stay near the root, so when a
+// few keys get most of the lookups, those lookups stop after a level or
+// two. Any sequence of m operations takes O(m log n) time in all, though
+// a single one may take O(n).
+//
+// The splay is done top-down in a single loop (Sleator and Tarjan), so
+// no recursion or parent pointers are needed. Since lookups change the
+// shape of the tree, the const lookups (find() and contains()) change
+// it too: a SplayTree must not be searched from several threads at once.
+///
+
+#pragma once
+
+#include "BSTInterface.h"
+#include "NodeArena.h"
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename KeyComparable, typename Value>
+class SplayTree : public BSTInterface<KeyComparable, Value>
+{
+    using Base = BSTInterface<KeyComparable, Value>;
+
+  public:
+    using typename Base::ValueHandle;
+
+  private:
+    /*
+     * Private BinaryNode Class
+     */
+    class BinaryNode
+    {
+      public:
+        KeyComparable key;
+        Value value;
+
+        BinaryNode* left;
+        BinaryNode* right;
+
+        // The value is constructed in place from the remaining arguments
+        template <typename... Args>
+        explicit BinaryNode(KeyComparable key, Args&&... args)
+            : key{std::move(key)}, value(std::forward<Args>(args)...),
+              left{nullptr}, right{nullptr}
+        {
+        }
+    };
+
+    // the root node of the tree, which lookups move
+    mutable BinaryNode* root = nullptr;
+
+    // storage for the nodes
+    NodeArena<BinaryNode> nodes;
+
+    /*
+     * Splays the subtree rooted at t for the key: brings the node with
+     * the key, or else the last node on the path to where it would be,
+     * to the root. Returns the new root.
+     */
+    static BinaryNode* splay(BinaryNode* t, const KeyComparable& key)
+    {
+        if (!t)
+        {
+            return nullptr; // RETURN: Empty subtree
+        }
+
+        // Nodes passed on the way down are hung on two side trees: those
+        // less than the key on the left tree, those greater on the right.
+        // Each hook is the free link where the next node goes.
+        BinaryNode* leftTree = nullptr;
+        BinaryNode* rightTree = nullptr;
+        BinaryNode** leftHook = &leftTree;
+        BinaryNode** rightHook = &rightTree;
+
+        while (true)
+        {
+            if (key < t->key)
+            {
+                if (!t->left)
+                {
+                    break; // No closer node
+                }
+
+                // Zig-zig: rotate right first, which halves the path
+                if (key < t->left->key)
+                {
+                    BinaryNode* l = t->left;
+                    t->left = l->right;
+                    l->right = t;
+                    t = l;
+                    if (!t->left)
+                    {
+                        break;
+                    }
+                }
+
+                // Hang t on the right tree, and go left
+                *rightHook = t;
+                rightHook = &t->left;
+                t = t->left;
+            }
+            else if (t->key < key)
+            {
+                if (!t->right)
+                {
+                    break; // No closer node
+                }
+
+                // Zag-zag: rotate left first
+                if (t->right->key < key)
+                {
+                    BinaryNode* r = t->right;
+                    t->right = r->left;
+                    r->left = t;
+                    t = r;
+                    if (!t->right)
+                    {
+                        break;
+                    }
+                }
+
+                // Hang t on the left tree, and go right
+                *leftHook = t;
+                leftHook = &t->right;
+                t = t->right;
+            }
+            else
+            {
+                break; // Found the key
+            }
+        }
+
+        // Put the side trees back together under t
+        *leftHook = t->left;
+        *rightHook = t->right;
+        t->left = leftTree;
+        t->right = rightTree;
+        return t;
+    }
+
+  public:
+    SplayTree() = default;
+
+    // The tree owns its nodes, so it cannot be copied
+    SplayTree(const SplayTree&) = delete;
+    SplayTree& operator=(const SplayTree&) = delete;
+
+    ~SplayTree()
+    {
+        makeEmpty();
+    }
+
+    /*
+     * Finds the node with the smallest element in the tree. The tree is
+     * not splayed.
+     */
+    ValueHandle findMin() const override
+    {
+        BinaryNode* t = root;
+        while (t && t->left)
+        {
+            t = t->left;
+        }
+        return t ? Base::toHandle(t->value) : nullptr;
+    }
+
+    /*
+     * Finds the node with the largest element in the tree. The tree is
+     * not splayed.
+     */
+    ValueHandle findMax() const override
+    {
+        BinaryNode* t = root;
+        while (t && t->right)
+        {
+            t = t->right;
+        }
+        return t ? Base::toHandle(t->value) : nullptr;
+    }
+
+    /*
+     * Finds the node with the key, and moves it to the root
+     * returns a pointer to its value in the tree if found
+     * returns nullptr if not
+     */
+    const Value* find(const KeyComparable& key) const override
+    {
+        root = splay(root, key);
+        if (!root || key < root->key || root->key < key)
+        {
+            return nullptr; // FAIL: key not found
+        }
+        return &root->value;
+    }
+
+    // find(key, founditem) copies the value out
+    using Base::find;
+
+    /*
+     * Returns true if the item is found in the tree
+     */
+    bool contains(const KeyComparable& key) const override
+    {
+        return find(key) != nullptr;
+    }
+
+    /*
+     * Returns true if tree has no nodes
+     */
+    bool isEmpty() const override
+    {
+        return root == nullptr;
+    }
+
+    /*
+     * Prints the inorder the tree to the stream out
+     */
+    void printTree(std::ostream& out = std::cout) const override
+    {
+        // Visit the nodes in order with an explicit stack of the
+        // ancestors whose left subtree is being visited
+        std::vector<const BinaryNode*> stack;
+        const BinaryNode* t = root;
+        while (t || !stack.empty())
+        {
+            while (t)
+            {
+                stack.push_back(t);
+                t = t->left;
+            }
+
+            t = stack.back();
+            stack.pop_back();
+            Base::printValue(out, t->value);
+            out << "\n";
+            t = t->right;
+        }
+    }
+
+    /*
+     * Removes all nodes from the tree
+     */
+    void makeEmpty() override
+    {
+        // Nodes with nothing to clean up are freed with their slabs
+        if constexpr (!std::is_trivially_destructible<BinaryNode>::value)
+        {
+            // Rotate left children up, destroying each node once it has
+            // none
+            while (root)
+            {
+                if (root->left)
+                {
+                    BinaryNode* left = root->left;
+                    root->left = left->right;
+                    left->right = root;
+                    root = left;
+                }
+                else
+                {
+                    BinaryNode* right = root->right;
+                    nodes.destroy(root);
+                    root = right;
+                }
+            }
+        }
+
+        root = nullptr;
+        nodes.release();
+    }
+
+    /*
+     * Inserts a node into the tree, at the root
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    bool insert(Value value, KeyComparable key) override
+    {
+        return emplace(std::move(key), std::move(value));
+    }
+
+    /*
+     * Inserts a node into the tree, at the root, constructing its value
+     * in place from the given arguments
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    template <typename... Args>
+    bool emplace(KeyComparable key, Args&&... args)
+    {
+        // Bring the nearest key to the root
+        root = splay(root, key);
+        if (root && !(key < root->key) && !(root->key < key))
+        {
+            return false; // FAIL: key already exists
+        }
+
+        // The new node splits the old root from its subtree on the
+        // other side of the key
+        BinaryNode* node =
+            nodes.create(std::move(key), std::forward<Args>(args)...);
+        if (root)
+        {
+            if (node->key < root->key)
+            {
+                node->left = root->left;
+                node->right = root;
+                root->left = nullptr;
+            }
+            else
+            {
+                node->right = root->right;
+                node->left = root;
+                root->right = nullptr;
+            }
+        }
+        root = node;
+        return true; // SUCCESS: node added
+    }
+
+    /*
+     * Removes the node with the key, if it is in the tree
+     */
+    void remove(const KeyComparable& key) override
+    {
+        root = splay(root, key);
+        if (!root || key < root->key || root->key < key)
+        {
+            return; // FAIL: key not found
+        }
+
+        // Splaying the left subtree for the key, which is larger than
+        // all of it, brings its largest node up with no right child, so
+        // the right subtree can hang there
+        BinaryNode* left = root->left;
+        BinaryNode* right = root->right;
+        nodes.destroy(root);
+
+        root = splay(left, key);
+        if (root)
+        {
+            root->right = right;
+        }
+        else
+        {
+            root = right;
+        }
+    }
+}; // end of SplayTree class
@@ -0,0 +1,738 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A treap: a binary search tree whose nodes also carry a
+// random priority, kept in heap order (no node has a higher priority
+// than its parent). The random priorities give the tree the shape of one
+// built by inserting the keys in random order, so it is O(log n) deep
+// with high probability whatever order the keys really arrive in.
+//
+// Every change is made by splitting a tree at a key or joining two trees
+// whose keys do not overlap, and both are also public. A range of k keys
+// is removed by cutting out the subtree which holds exactly those keys,
+// in O(log n + k) time, instead of searching for each key from the root.
+//
+// The set operations (unionWith(), intersectWith() and difference())
+// split one tree at the root key of the other and recurse on the two
+// halves, which takes O(m log(n / m + 1)) work for trees of m <= n keys.
+// The halves share no nodes, so on large trees the top few levels of the
+// recursion run the left half in another thread.
+//
+// Since nodes move from one treap to another in split() and join(), each
+// one is allocated on its own rather than from a NodeArena.
+///
+
+#pragma once
+
+#include "BSTInterface.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+template <typename KeyComparable, typename Value>
+class Treap : public BSTInterface<KeyComparable, Value>
+{
+    using Base = BSTInterface<KeyComparable, Value>;
+
+  public:
+    using typename Base::ValueHandle;
+
+    // set operations on fewer keys than this run in a single thread
+    static constexpr int PARALLEL_MIN_KEYS = 10000;
+
+  private:
+    /*
+     * Private BinaryNode Class
+     */
+    class BinaryNode
+    {
+      public:
+        KeyComparable key;
+        Value value;
+
+        BinaryNode* left;
+        BinaryNode* right;
+
+        // no node has a higher priority than its parent
+        std::uint32_t priority;
+
+        // The value is constructed in place from the remaining arguments
+        template <typename... Args>
+        BinaryNode(std::uint32_t priority, KeyComparable key,
+                   Args&&... args)
+            : key{std::move(key)}, value(std::forward<Args>(args)...),
+              left{nullptr}, right{nullptr}, priority{priority}
+        {
+        }
+    };
+
+    // the root node of the tree
+    BinaryNode* root = nullptr;
+
+    // source of node priorities
+    std::minstd_rand rng{std::random_device{}()};
+
+    /*
+     * Splits the subtree into the nodes for which goesLeft(node) is true,
+     * which must all be less than the others, and the rest. Both parts
+     * keep their order and heap order.
+     */
+    template <typename Predicate>
+    static void split(BinaryNode* t, Predicate goesLeft,
+                      BinaryNode*& left, BinaryNode*& right)
+    {
+        // Each hook is the free link where the next node of its part
+        // goes: the right link of the largest node so far in the left
+        // part, the left link of the smallest in the right part
+        BinaryNode** leftHook = &left;
+        BinaryNode** rightHook = &right;
+        while (t)
+        {
+            if (goesLeft(t))
+            {
+                // t and its left subtree go left; split its right
+                *leftHook = t;
+                leftHook = &t->right;
+                t = t->right;
+            }
+            else
+            {
+                // t and its right subtree go right; split its left
+                *rightHook = t;
+                rightHook = &t->left;
+                t = t->left;
+            }
+        }
+        *leftHook = nullptr;
+        *rightHook = nullptr;
+    }
+
+    /*
+     * Splits the subtree into the keys less than the given key and the
+     * rest
+     */
+    static void splitBefore(BinaryNode* t, const KeyComparable& key,
+                            BinaryNode*& left, BinaryNode*& right)
+    {
+        split(
+            t, [&](const BinaryNode* node) { return node->key < key; },
+            left, right);
+    }
+
+    /*
+     * Splits the subtree into the keys up to and including the given key
+     * and the rest
+     */
+    static void splitAfter(BinaryNode* t, const KeyComparable& key,
+                           BinaryNode*& left, BinaryNode*& right)
+    {
+        split(
+            t, [&](const BinaryNode* node) { return !(key < node->key); },
+            left, right);
+    }
+
+    /*
+     * Joins two subtrees, where every key of left is less than every key
+     * of right, and returns the root of the result
+     */
+    static BinaryNode* join(BinaryNode* left, BinaryNode* right)
+    {
+        // Walk down the right spine of left and the left spine of right
+        // together, taking the node with the higher priority each time
+        BinaryNode* result = nullptr;
+        BinaryNode** hook = &result;
+        while (left && right)
+        {
+            if (right->priority < left->priority)
+            {
+                *hook = left;
+                hook = &left->right;
+                left = left->right;
+            }
+            else
+            {
+                *hook = right;
+                hook = &right->left;
+                right = right->left;
+            }
+        }
+        *hook = left ? left : right;
+        return result;
+    }
+
+    /*
+     * Returns the link (the root, or the left or right pointer of the
+     * parent) which holds the node with the key, or a null link if there
+     * is none
+     */
+    BinaryNode*& findLink(const KeyComparable& key)
+    {
+        BinaryNode** link = &root;
+        while (*link && ((*link)->key < key || key < (*link)->key))
+        {
+            link = (key < (*link)->key) ? &(*link)->left : &(*link)->right;
+        }
+        return *link;
+    }
+
+    /*
+     * Finds the node with that satisfies equality for the element
+     */
+    BinaryNode* find(const KeyComparable& key, BinaryNode* node) const
+    {
+        while (node && (node->key < key || key < node->key))
+        {
+            node = (key < node->key) ? node->left : node->right;
+        }
+        return node;
+    }
+
+    /*
+     * Deletes every node in the subtree, without recursion, and returns
+     * how many there were
+     */
+    static int destroy(BinaryNode* t)
+    {
+        int count = 0;
+        while (t)
+        {
+            if (t->left)
+            {
+                // Rotate the left child up, so the subtree leans right
+                BinaryNode* left = t->left;
+                t->left = left->right;
+                left->right = t;
+                t = left;
+            }
+            else
+            {
+                BinaryNode* right = t->right;
+                delete t;
+                t = right;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    /*
+     * Splits the subtree into the keys less than the given key and those
+     * greater, and returns the node with the key, unlinked, or nullptr
+     */
+    static BinaryNode* splitAround(BinaryNode* t,
+                                   const KeyComparable& key,
+                                   BinaryNode*& left, BinaryNode*& right)
+    {
+        splitBefore(t, key, left, right);
+
+        // The key, if there, is the smallest of the right part
+        BinaryNode** link = &right;
+        while (*link && (*link)->left)
+        {
+            link = &(*link)->left;
+        }
+        BinaryNode* found = *link;
+        if (!found || key < found->key)
+        {
+            return nullptr; // RETURN: Key not found
+        }
+
+        // Its right subtree takes its place, which keeps heap order
+        *link = found->right;
+        found->left = nullptr;
+        found->right = nullptr;
+        return found;
+    }
+
+    /*
+     * Runs left() and right(), the left one in another thread if there
+     * are levels of parallelism left
+     */
+    template <typename Left, typename Right>
+    static void forkJoin(int parallelDepth, Left left, Right right)
+    {
+        if (parallelDepth <= 0)
+        {
+            left();
+            right();
+            return;
+        }
+
+        auto pending = std::async(std::launch::async, left);
+        right();
+        pending.get();
+    }
+
+    /*
+     * Returns the number of levels of the set operations to run in
+     * parallel for the given tree
+     */
+    static int getParallelDepth(const BinaryNode* t)
+    {
+        // Counting the keys up to the limit takes no more work than the
+        // operation itself, which visits every one of them
+        int count = 0;
+        std::vector<const BinaryNode*> stack;
+        for (; t && count < PARALLEL_MIN_KEYS; count++)
+        {
+            if (t->right)
+            {
+                stack.push_back(t->right);
+            }
+            if (t->left)
+            {
+                t = t->left;
+            }
+            else if (!stack.empty())
+            {
+                t = stack.back();
+                stack.pop_back();
+            }
+            else
+            {
+                t = nullptr;
+            }
+        }
+        if (count < PARALLEL_MIN_KEYS)
+        {
+            return 0; // RETURN: Too small to be worth a thread
+        }
+
+        // Enough levels for about twice as many tasks as hardware threads
+        int threads =
+            std::max(static_cast<int>(std::thread::hardware_concurrency()),
+                     1);
+        int depth = 1;
+        while ((1 << depth) < 2 * threads)
+        {
+            depth++;
+        }
+        return depth;
+    }
+
+    /*
+     * Returns the union of two subtrees, keeping the node from mine when
+     * both have a key
+     */
+    static BinaryNode* unite(BinaryNode* mine, BinaryNode* theirs,
+                             int parallelDepth)
+    {
+        if (!mine || !theirs)
+        {
+            return mine ? mine : theirs; // RETURN: Nothing to merge
+        }
+
+        // The root with the higher priority stays on top; the other tree
+        // is split around its key
+        bool mineOnTop = !(mine->priority < theirs->priority);
+        BinaryNode* top = mineOnTop ? mine : theirs;
+        BinaryNode* other = mineOnTop ? theirs : mine;
+
+        BinaryNode* left = nullptr;
+        BinaryNode* right = nullptr;
+        BinaryNode* duplicate = splitAround(other, top->key, left, right);
+        BinaryNode* topLeft = top->left;
+        BinaryNode* topRight = top->right;
+        if (duplicate && !mineOnTop)
+        {
+            // Keep my node, in their node's place
+            duplicate->priority = top->priority;
+            delete top;
+            top = duplicate;
+        }
+        else if (duplicate)
+        {
+            delete duplicate;
+        }
+
+        // Pass the halves of mine first, so mine win further down too
+        int depth = parallelDepth - 1;
+        forkJoin(
+            depth,
+            [&] {
+                top->left = mineOnTop ? unite(topLeft, left, depth)
+                                      : unite(left, topLeft, depth);
+            },
+            [&] {
+                top->right = mineOnTop ? unite(topRight, right, depth)
+                                       : unite(right, topRight, depth);
+            });
+        return top;
+    }
+
+    /*
+     * Returns the nodes of mine whose keys are also in theirs, and
+     * deletes the rest of both
+     */
+    static BinaryNode* intersect(BinaryNode* mine, BinaryNode* theirs,
+                                 int parallelDepth)
+    {
+        if (!mine || !theirs)
+        {
+            destroy(mine);
+            destroy(theirs);
+            return nullptr; // RETURN: Nothing in common
+        }
+
+        BinaryNode* left = nullptr;
+        BinaryNode* right = nullptr;
+        BinaryNode* duplicate =
+            splitAround(theirs, mine->key, left, right);
+
+        BinaryNode* commonLeft = nullptr;
+        BinaryNode* commonRight = nullptr;
+        int depth = parallelDepth - 1;
+        forkJoin(
+            depth,
+            [&] { commonLeft = intersect(mine->left, left, depth); },
+            [&] { commonRight = intersect(mine->right, right, depth); });
+
+        if (!duplicate)
+        {
+            delete mine;
+            return join(commonLeft, commonRight);
+        }
+
+        delete duplicate;
+        mine->left = commonLeft;
+        mine->right = commonRight;
+        return mine;
+    }
+
+    /*
+     * Returns the nodes of mine whose keys are not in theirs, and deletes
+     * the rest of both
+     */
+    static BinaryNode* subtract(BinaryNode* mine, BinaryNode* theirs,
+                                int parallelDepth)
+    {
+        if (!mine || !theirs)
+        {
+            destroy(theirs);
+            return mine; // RETURN: Nothing to take away
+        }
+
+        BinaryNode* left = nullptr;
+        BinaryNode* right = nullptr;
+        BinaryNode* duplicate =
+            splitAround(theirs, mine->key, left, right);
+
+        BinaryNode* keptLeft = nullptr;
+        BinaryNode* keptRight = nullptr;
+        int depth = parallelDepth - 1;
+        forkJoin(
+            depth, [&] { keptLeft = subtract(mine->left, left, depth); },
+            [&] { keptRight = subtract(mine->right, right, depth); });
+
+        if (duplicate)
+        {
+            delete duplicate;
+            delete mine;
+            return join(keptLeft, keptRight);
+        }
+
+        mine->left = keptLeft;
+        mine->right = keptRight;
+        return mine;
+    }
+
+  public:
+    Treap() = default;
+
+    // The tree owns its nodes, so it cannot be copied, only moved
+    Treap(const Treap&) = delete;
+    Treap& operator=(const Treap&) = delete;
+
+    Treap(Treap&& rhs) noexcept : root{rhs.root}
+    {
+        rhs.root = nullptr;
+    }
+
+    Treap& operator=(Treap&& rhs) noexcept
+    {
+        std::swap(root, rhs.root);
+        return *this;
+    }
+
+    ~Treap()
+    {
+        makeEmpty();
+    }
+
+    /*
+     * Finds the node with the smallest element in the tree
+     */
+    ValueHandle findMin() const override
+    {
+        BinaryNode* t = root;
+        while (t && t->left)
+        {
+            t = t->left;
+        }
+        return t ? Base::toHandle(t->value) : nullptr;
+    }
+
+    /*
+     * Finds the node with the largest element in the tree
+     */
+    ValueHandle findMax() const override
+    {
+        BinaryNode* t = root;
+        while (t && t->right)
+        {
+            t = t->right;
+        }
+        return t ? Base::toHandle(t->value) : nullptr;
+    }
+
+    /*
+     * Finds the node with the key
+     * returns a pointer to its value in the tree if found
+     * returns nullptr if not
+     */
+    const Value* find(const KeyComparable& key) const override
+    {
+        BinaryNode* foundNode = find(key, root);
+        return foundNode ? &foundNode->value : nullptr;
+    }
+
+    // find(key, founditem) copies the value out
+    using Base::find;
+
+    /*
+     * Returns true if the item is found in the tree
+     */
+    bool contains(const KeyComparable& key) const override
+    {
+        return find(key, root) != nullptr;
+    }
+
+    /*
+     * Returns true if tree has no nodes
+     */
+    bool isEmpty() const override
+    {
+        return root == nullptr;
+    }
+
+    /*
+     * Prints the inorder the tree to the stream out
+     */
+    void printTree(std::ostream& out = std::cout) const override
+    {
+        // Visit the nodes in order with an explicit stack of the
+        // ancestors whose left subtree is being visited
+        std::vector<const BinaryNode*> stack;
+        const BinaryNode* t = root;
+        while (t || !stack.empty())
+        {
+            while (t)
+            {
+                stack.push_back(t);
+                t = t->left;
+            }
+
+            t = stack.back();
+            stack.pop_back();
+            Base::printValue(out, t->value);
+            out << "\n";
+            t = t->right;
+        }
+    }
+
+    /*
+     * Removes all nodes from the tree
+     */
+    void makeEmpty() override
+    {
+        destroy(root);
+        root = nullptr;
+    }
+
+    /*
+     * Inserts a node into the tree
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    bool insert(Value value, KeyComparable key) override
+    {
+        return emplace(std::move(key), std::move(value));
+    }
+
+    /*
+     * Inserts a node into the tree, constructing its value in place from
+     * the given arguments
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    template <typename... Args>
+    bool emplace(KeyComparable key, Args&&... args)
+    {
+        if (contains(key))
+        {
+            return false; // FAIL: key already exists
+        }
+
+        auto* node = new BinaryNode(static_cast<std::uint32_t>(rng()),
+                                    std::move(key),
+                                    std::forward<Args>(args)...);
+
+        // Walk down to where the new node's priority puts it, then split
+        // the subtree there around it
+        BinaryNode** link = &root;
+        while (*link && node->priority < (*link)->priority)
+        {
+            link = (node->key < (*link)->key) ? &(*link)->left
+                                              : &(*link)->right;
+        }
+        splitBefore(*link, node->key, node->left, node->right);
+        *link = node;
+        return true; // SUCCESS: node added
+    }
+
+    /*
+     * Removes the node with the key, if it is in the tree
+     */
+    void remove(const KeyComparable& key) override
+    {
+        BinaryNode*& link = findLink(key);
+        if (!link)
+        {
+            return; // FAIL: key not found
+        }
+
+        // Its two subtrees take its place
+        BinaryNode* node = link;
+        link = join(node->left, node->right);
+        delete node;
+    }
+
+    /*
+     * Removes every key from lo to hi, inclusive, and returns how many
+     * were removed. Takes O(log n + k) time for k keys removed.
+     */
+    int removeRange(const KeyComparable& lo, const KeyComparable& hi)
+    {
+        if (hi < lo)
+        {
+            return 0; // RETURN: Empty range
+        }
+
+        // Cut the tree into the keys below, within and above the range
+        BinaryNode* below = nullptr;
+        BinaryNode* rest = nullptr;
+        BinaryNode* within = nullptr;
+        BinaryNode* above = nullptr;
+        splitBefore(root, lo, below, rest);
+        splitAfter(rest, hi, within, above);
+
+        root = join(below, above);
+        return destroy(within);
+    }
+
+    /*
+     * Moves every key not less than the given key into a new treap,
+     * which is returned. Takes O(log n) time.
+     */
+    Treap split(const KeyComparable& key)
+    {
+        Treap upper;
+        splitBefore(root, key, root, upper.root);
+        return upper;
+    }
+
+    /*
+     * Moves every key of the other treap into this one, leaving it empty.
+     * Every key of the other treap must be greater than every key of this
+     * one. Takes O(log n) time.
+     * Throws std::invalid_argument if the keys overlap.
+     */
+    void join(Treap& other)
+    {
+        if (this == &other || !other.root)
+        {
+            return; // RETURN: Nothing to add
+        }
+
+        if (root)
+        {
+            const BinaryNode* max = root;
+            while (max->right)
+            {
+                max = max->right;
+            }
+            const BinaryNode* min = other.root;
+            while (min->left)
+            {
+                min = min->left;
+            }
+            if (!(max->key < min->key))
+            {
+                // FAIL: The keys overlap
+                throw std::invalid_argument(
+                    "Joined keys must all be greater");
+            }
+        }
+
+        root = join(root, other.root);
+        other.root = nullptr;
+    }
+
+    /*
+     * Moves every key of the other treap which is not already here into
+     * this one, leaving the other empty. Where both have a key, the
+     * value here is kept.
+     */
+    void unionWith(Treap& other)
+    {
+        if (this == &other)
+        {
+            return; // RETURN: Already the union
+        }
+
+        int parallelDepth = getParallelDepth(other.root);
+        root = unite(root, other.root, parallelDepth);
+        other.root = nullptr;
+    }
+
+    /*
+     * Removes every key which is not also in the other treap, leaving
+     * the other empty.
+     */
+    void intersectWith(Treap& other)
+    {
+        if (this == &other)
+        {
+            return; // RETURN: Already the intersection
+        }
+
+        int parallelDepth = getParallelDepth(other.root);
+        root = intersect(root, other.root, parallelDepth);
+        other.root = nullptr;
+    }
+
+    /*
+     * Removes every key which is in the other treap, leaving the other
+     * empty.
+     */
+    void difference(Treap& other)
+    {
+        if (this == &other)
+        {
+            makeEmpty();
+            return; // RETURN: Nothing is left
+        }
+
+        int parallelDepth = getParallelDepth(other.root);
+        root = subtract(root, other.root, parallelDepth);
+        other.root = nullptr;
+    }
+}; // end of Treap class
@@ -0,0 +1,200 @@
+#include "EpochReclaimer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+// the epoch of a thread holding no Guard
+constexpr std::uint64_t IDLE = std::numeric_limits<std::uint64_t>::max();
+
+// retire() tries to free objects each time this many more are waiting
+constexpr std::size_t COLLECT_EVERY = 64;
+
+struct Retired
+{
+    void* object;
+    void (*deleter)(void*);
+
+    // the epoch it was retired in
+    std::uint64_t epoch;
+};
+
+// One per thread holding a Guard, each on its own cache line
+struct alignas(64) Slot
+{
+    std::atomic<std::uint64_t> epoch{IDLE};
+    std::atomic<bool> taken{false};
+};
+
+std::atomic<std::uint64_t> globalEpoch{0};
+
+Slot slots[EpochReclaimer::MAX_THREADS];
+
+// number of slots ever taken; the rest need not be scanned
+std::atomic<std::size_t> slotsUsed{0};
+
+/*
+ * Objects retired by threads which have since exited. Whatever is left
+ * at the end of the program is freed then.
+ */
+struct Orphans
+{
+    std::mutex mutex;
+    std::vector<Retired> list;
+
+    ~Orphans()
+    {
+        for (Retired& retired : list)
+        {
+            retired.deleter(retired.object);
+        }
+    }
+} orphans;
+
+/*
+ * Frees the objects retired at least two epochs before the given one
+ */
+void freeExpired(std::vector<Retired>& list, std::uint64_t epoch)
+{
+    auto expired =
+        std::partition(list.begin(), list.end(), [&](const Retired& r) {
+            return r.epoch + 2 > epoch;
+        });
+
+    // Take them off the list first, in case a deleter retires more
+    std::vector<Retired> toFree(expired, list.end());
+    list.erase(expired, list.end());
+    for (Retired& retired : toFree)
+    {
+        retired.deleter(retired.object);
+    }
+}
+
+/*
+ * Advances the epoch, if every thread holding a Guard has seen it, and
+ * returns the epoch
+ */
+std::uint64_t tryAdvance()
+{
+    std::uint64_t epoch = globalEpoch.load();
+    std::size_t used = std::min(slotsUsed.load(), std::size(slots));
+    for (std::size_t i = 0; i < used; i++)
+    {
+        std::uint64_t seen = slots[i].epoch.load();
+        if (seen != IDLE && seen != epoch)
+        {
+            return epoch; // RETURN: A reader is still behind
+        }
+    }
+
+    globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+    return globalEpoch.load();
+}
+
+/*
+ * Takes a free slot for the calling thread
+ */
+Slot* takeSlot()
+{
+    // Reuse the slot of a thread which has exited
+    std::size_t used = std::min(slotsUsed.load(), std::size(slots));
+    for (std::size_t i = 0; i < used; i++)
+    {
+        bool expected = false;
+        if (!slots[i].taken.load(std::memory_order_relaxed) &&
+            slots[i].taken.compare_exchange_strong(expected, true))
+        {
+            return &slots[i];
+        }
+    }
+
+    std::size_t i = slotsUsed.fetch_add(1);
+    if (i >= std::size(slots))
+    {
+        throw std::runtime_error("EpochReclaimer: too many threads");
+    }
+    slots[i].taken.store(true);
+    return &slots[i];
+}
+
+struct ThreadState
+{
+    Slot* slot = nullptr;
+
+    // number of Guards the thread holds
+    int depth = 0;
+
+    std::vector<Retired> retired;
+
+    ~ThreadState()
+    {
+        if (slot)
+        {
+            slot->epoch.store(IDLE);
+            slot->taken.store(false);
+        }
+
+        if (!retired.empty())
+        {
+            std::lock_guard<std::mutex> lock(orphans.mutex);
+            orphans.list.insert(orphans.list.end(), retired.begin(),
+                                retired.end());
+        }
+    }
+};
+
+thread_local ThreadState self;
+} // namespace
+
+EpochReclaimer::Guard::Guard()
+{
+    if (self.depth == 0)
+    {
+        if (!self.slot)
+        {
+            self.slot = takeSlot();
+        }
+
+        // The fence makes the announcement seen before any node is read
+        self.slot->epoch.store(globalEpoch.load(),
+                               std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    self.depth++;
+}
+
+EpochReclaimer::Guard::~Guard()
+{
+    if (--self.depth == 0)
+    {
+        self.slot->epoch.store(IDLE, std::memory_order_release);
+    }
+}
+
+void EpochReclaimer::retire(void* object, void (*deleter)(void*))
+{
+    self.retired.push_back({object, deleter, globalEpoch.load()});
+    if (self.retired.size() % COLLECT_EVERY == 0)
+    {
+        collect();
+    }
+}
+
+void EpochReclaimer::collect()
+{
+    std::uint64_t epoch = tryAdvance();
+    freeExpired(self.retired, epoch);
+
+    // Help free what exited threads left, unless another thread is
+    std::unique_lock<std::mutex> lock(orphans.mutex, std::try_to_lock);
+    if (lock && !orphans.list.empty())
+    {
+        freeExpired(orphans.list, epoch);
+    }
+}
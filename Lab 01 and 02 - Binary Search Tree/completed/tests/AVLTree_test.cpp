@@ -0,0 +1,158 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A self-balancing (AVL) binary search tree.
+///
+
+#include <AVLTree.h>
+
+#include "TreeTestHelpers.h"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+SCENARIO("AVLTree: Stay balanced when keys arrive in order")
+{
+    GIVEN("A tree of keys inserted in increasing order")
+    {
+        AVLTree<int, int> tree;
+        int count = GENERATE(1, 2, 3, 10, 1000, 100000);
+        for (int key = 1; key <= count; key++)
+        {
+            REQUIRE(tree.insert(10 * key, key));
+        }
+
+        THEN("Its height is within the AVL bound")
+        {
+            REQUIRE(tree.getHeight() <= maxAvlHeight(count));
+        }
+
+        THEN("Every key is found with its value")
+        {
+            for (int key = 1; key <= count; key++)
+            {
+                const int* value = tree.find(key);
+                REQUIRE(value != nullptr);
+                REQUIRE(*value == 10 * key);
+            }
+        }
+
+        WHEN("The first half of the keys is removed")
+        {
+            for (int key = 1; key <= count / 2; key++)
+            {
+                tree.remove(key);
+            }
+
+            THEN("Its height is within the bound for what is left")
+            {
+                int left = count - count / 2;
+                REQUIRE(tree.getHeight() <= maxAvlHeight(left));
+                REQUIRE(*tree.findMin() == 10 * (count / 2 + 1));
+            }
+        }
+    }
+
+    GIVEN("A tree of keys inserted in decreasing order")
+    {
+        AVLTree<int, int> tree;
+        const int count = 100000;
+        for (int key = count; key >= 1; key--)
+        {
+            tree.insert(10 * key, key);
+        }
+
+        THEN("Its height is within the AVL bound")
+        {
+            REQUIRE(tree.getHeight() <= maxAvlHeight(count));
+        }
+    }
+}
+
+SCENARIO("AVLTree: Random insertions and removals match a std::map")
+{
+    GIVEN("A tree and a map changed by the same random operations")
+    {
+        AVLTree<int, int> tree;
+        std::map<int, int> expected;
+
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(1, 2000);
+        std::uniform_int_distribution<int> opDist(0, 2);
+
+        for (int i = 0; i < 50000; i++)
+        {
+            int key = keyDist(rng);
+            switch (opDist(rng))
+            {
+            case 0:
+            {
+                bool inserted = expected.emplace(key, 10 * key).second;
+                REQUIRE(tree.insert(10 * key, key) == inserted);
+                break;
+            }
+            case 1:
+                expected.erase(key);
+                tree.remove(key);
+                break;
+            default:
+                REQUIRE(tree.contains(key) == (expected.count(key) == 1));
+            }
+        }
+
+        THEN("They hold the same values, in order")
+        {
+            std::vector<int> values;
+            for (auto& [key, value] : expected)
+            {
+                values.push_back(value);
+            }
+            REQUIRE(printedValues(tree) == values);
+        }
+
+        THEN("The tree is within the AVL bound")
+        {
+            int count = static_cast<int>(expected.size());
+            REQUIRE(tree.getHeight() <= maxAvlHeight(count));
+        }
+    }
+}
+
+SCENARIO("AVLTree: Store move-only values inline")
+{
+    GIVEN("A tree of strings held by unique_ptr")
+    {
+        AVLTree<int, std::unique_ptr<std::string>> tree;
+        for (int key = 1; key <= 100; key++)
+        {
+            tree.emplace(key, std::make_unique<std::string>(
+                                  std::to_string(key)));
+        }
+
+        THEN("Each value is found under its key")
+        {
+            for (int key = 1; key <= 100; key++)
+            {
+                REQUIRE(**tree.find(key) == std::to_string(key));
+            }
+        }
+
+        WHEN("The tree is emptied")
+        {
+            tree.makeEmpty();
+
+            THEN("It is empty, with no height")
+            {
+                REQUIRE(tree.isEmpty());
+                REQUIRE(0 == tree.getHeight());
+            }
+        }
+    }
+}
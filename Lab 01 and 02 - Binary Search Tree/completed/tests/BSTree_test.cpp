@@ -0,0 +1,505 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: An object-oriented implementation of a Binary Search Tree.
+///
+
+#include <BSTree.h>
+
+#include "TreeTestHelpers.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+// The tree used by most of the tests
+using IntTree = BinarySearchTree<int, int>;
+
+// Generate the numbers 1 to count in random order
+std::vector<int> shuffledKeys(int count)
+{
+    std::vector<int> keys(count);
+    std::iota(keys.begin(), keys.end(), 1);
+    std::shuffle(keys.begin(), keys.end(),
+                 std::mt19937{std::random_device{}()});
+    return keys;
+}
+
+SCENARIO("BSTree: Iterate over a tree in order")
+{
+    GIVEN("An empty tree")
+    {
+        IntTree tree;
+
+        THEN("begin() is end()")
+        {
+            REQUIRE(tree.begin() == tree.end());
+        }
+    }
+
+    GIVEN("A tree of keys inserted in random order")
+    {
+        IntTree tree;
+        int count = GENERATE(1, 2, 100, 5000);
+        for (int key : shuffledKeys(count))
+        {
+            tree.insert(10 * key, key);
+        }
+
+        THEN("The iterator visits every key in order, with its value")
+        {
+            int expected = 1;
+            for (auto it = tree.begin(); it != tree.end(); ++it)
+            {
+                REQUIRE(it.key() == expected);
+                REQUIRE(*it == 10 * expected);
+                expected++;
+            }
+            REQUIRE(expected == count + 1);
+        }
+
+        THEN("The iterator works with the standard algorithms")
+        {
+            REQUIRE(std::distance(tree.begin(), tree.end()) == count);
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+        }
+
+        THEN("Post-increment returns the node it leaves")
+        {
+            auto it = tree.begin();
+            auto prev = it++;
+            REQUIRE(prev.key() == 1);
+            if (count > 1)
+            {
+                REQUIRE(it.key() == 2);
+            }
+            else
+            {
+                REQUIRE(it == tree.end());
+            }
+        }
+    }
+}
+
+SCENARIO("BSTree: Random insertions and removals match a std::map")
+{
+    GIVEN("A tree and a map changed by the same random operations")
+    {
+        IntTree tree;
+        std::map<int, int> expected;
+
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(1, 2000);
+        std::uniform_int_distribution<int> opDist(0, 2);
+
+        for (int i = 0; i < 50000; i++)
+        {
+            int key = keyDist(rng);
+            switch (opDist(rng))
+            {
+            case 0:
+            {
+                bool inserted = expected.emplace(key, 10 * key).second;
+                REQUIRE(tree.insert(10 * key, key) == inserted);
+                break;
+            }
+            case 1:
+                expected.erase(key);
+                tree.remove(key);
+                break;
+            default:
+                REQUIRE(tree.contains(key) == (expected.count(key) == 1));
+            }
+        }
+
+        THEN("Iterating gives the same keys and values, in order")
+        {
+            auto it = tree.begin();
+            for (auto& [key, value] : expected)
+            {
+                REQUIRE(it != tree.end());
+                REQUIRE(it.key() == key);
+                REQUIRE(*it == value);
+                ++it;
+            }
+            REQUIRE(it == tree.end());
+        }
+    }
+}
+
+SCENARIO("BSTree: Handle a tree as deep as it is long")
+{
+    GIVEN("A tree of keys inserted in increasing order")
+    {
+        // Every node is the right child of the one before, so anything
+        // which recursed would go this many calls deep
+        const int count = 20000;
+        auto tree = std::make_unique<IntTree>();
+        for (int key = 1; key <= count; key++)
+        {
+            tree->insert(10 * key, key);
+        }
+
+        THEN("The largest key is found at the bottom")
+        {
+            REQUIRE(*tree->findMax() == 10 * count);
+            REQUIRE(tree->contains(count));
+        }
+
+        THEN("It prints every value in order")
+        {
+            std::ostringstream expected;
+            for (int key = 1; key <= count; key++)
+            {
+                expected << 10 * key << "\n";
+            }
+            REQUIRE(printed(*tree) == expected.str());
+        }
+
+        WHEN("The keys are removed from the top down")
+        {
+            for (int key = 1; key <= count; key += 2)
+            {
+                tree->remove(key);
+            }
+
+            THEN("Only the other keys are left")
+            {
+                REQUIRE(std::distance(tree->begin(), tree->end()) ==
+                        count / 2);
+                REQUIRE(*tree->findMin() == 20);
+            }
+        }
+
+        WHEN("The tree is destroyed")
+        {
+            tree.reset();
+
+            THEN("It does not overflow the stack")
+            {
+                REQUIRE(tree == nullptr);
+            }
+        }
+    }
+}
+
+SCENARIO("BSTree: Insert sorted runs from a hint")
+{
+    GIVEN("An empty tree")
+    {
+        IntTree tree;
+
+        WHEN("A long sorted run is inserted")
+        {
+            // One by one from the root this would take 100000^2 / 2
+            // steps, since the tree is one long chain
+            std::vector<std::pair<int, int>> run;
+            for (int key = 1; key <= 100000; key++)
+            {
+                run.emplace_back(key, 10 * key);
+            }
+            int inserted = tree.insertSortedRun(run);
+
+            THEN("Every key is inserted, in order")
+            {
+                REQUIRE(100000 == inserted);
+                int expected = 1;
+                for (auto it = tree.begin(); it != tree.end(); ++it)
+                {
+                    REQUIRE(it.key() == expected);
+                    REQUIRE(*it == 10 * expected);
+                    expected++;
+                }
+                REQUIRE(100001 == expected);
+            }
+        }
+
+        WHEN("Keys are inserted one after another from the last hint")
+        {
+            auto hint = tree.end();
+            for (int key = 1; key <= 100; key++)
+            {
+                hint = tree.insertHint(hint, key, 10 * key);
+                REQUIRE(hint.key() == key);
+            }
+
+            THEN("The tree holds them all")
+            {
+                REQUIRE(std::distance(tree.begin(), tree.end()) == 100);
+                REQUIRE(*tree.findMax() == 1000);
+            }
+
+            AND_WHEN("A key already there is inserted")
+            {
+                hint = tree.insertHint(hint, 50, -1);
+
+                THEN("The hint moves to it and its value is kept")
+                {
+                    REQUIRE(hint.key() == 50);
+                    REQUIRE(*hint == 500);
+                }
+            }
+
+            AND_WHEN("A key before the hint is inserted")
+            {
+                hint = tree.insertHint(hint, 0, 0);
+
+                THEN("It is still put in its place")
+                {
+                    REQUIRE(hint.key() == 0);
+                    REQUIRE(tree.begin().key() == 0);
+                }
+            }
+        }
+    }
+
+    GIVEN("A tree and a set of the same random keys")
+    {
+        IntTree tree;
+        std::set<int> expected;
+        for (int key : shuffledKeys(2000))
+        {
+            if (key % 3 == 0)
+            {
+                tree.insert(10 * key, key);
+                expected.insert(key);
+            }
+        }
+
+        WHEN("A nearly sorted run of keys, some already there, is added")
+        {
+            std::vector<std::pair<int, int>> run;
+            for (int key = 1; key <= 2000; key += 2)
+            {
+                run.emplace_back(key, 10 * key);
+            }
+            for (std::size_t i = 0; i + 1 < run.size(); i += 7)
+            {
+                std::swap(run[i], run[i + 1]);
+            }
+
+            int added = 0;
+            for (auto& [key, value] : run)
+            {
+                added += expected.insert(key).second;
+            }
+            int inserted = tree.insertSortedRun(run);
+
+            THEN("Only the new keys are inserted, each in its place")
+            {
+                REQUIRE(inserted == added);
+                std::vector<int> keys;
+                for (auto it = tree.begin(); it != tree.end(); ++it)
+                {
+                    keys.push_back(it.key());
+                }
+                REQUIRE(keys == std::vector<int>(expected.begin(),
+                                                 expected.end()));
+            }
+        }
+    }
+}
+
+// Returns the bytes serialize() writes for the tree
+std::string serialized(const IntTree& tree)
+{
+    std::ostringstream out;
+    tree.serialize(out);
+    return out.str();
+}
+
+SCENARIO("BSTree: Serialize a tree and read it back")
+{
+    GIVEN("A tree of random keys")
+    {
+        IntTree tree;
+        int count = GENERATE(0, 1, 2, 1000);
+        for (int key : shuffledKeys(count))
+        {
+            tree.insert(10 * key, key);
+        }
+
+        WHEN("It is serialized and read into another tree")
+        {
+            std::istringstream in(serialized(tree));
+            IntTree copy;
+            copy.insert(-1, -1);
+            copy.deserialize(in);
+
+            THEN("The copy holds the same keys and values")
+            {
+                REQUIRE(std::equal(copy.begin(), copy.end(), tree.begin(),
+                                   tree.end()));
+                REQUIRE(std::distance(copy.begin(), copy.end()) == count);
+                REQUIRE_FALSE(copy.contains(-1));
+            }
+
+            THEN("The copy has the same shape")
+            {
+                // The preorder bytes fix the shape, so equal bytes mean
+                // an equal tree
+                REQUIRE(serialized(copy) == serialized(tree));
+            }
+        }
+    }
+
+    GIVEN("A tree as deep as it is long")
+    {
+        std::vector<std::pair<int, int>> run;
+        for (int key = 1; key <= 100000; key++)
+        {
+            run.emplace_back(key, 10 * key);
+        }
+        IntTree tree;
+        tree.insertSortedRun(run);
+
+        THEN("It reads back without recursing")
+        {
+            std::istringstream in(serialized(tree));
+            IntTree copy;
+            copy.deserialize(in);
+            REQUIRE(*copy.findMax() == 1000000);
+            REQUIRE(serialized(copy) == serialized(tree));
+        }
+
+        THEN("Its nodes are read back side by side, in preorder")
+        {
+            // The keys come in preorder, so each node is one node's size
+            // past the one before it, even past the first 1 << 16
+            std::istringstream in(serialized(tree));
+            IntTree copy;
+            copy.deserialize(in);
+
+            auto address = [&](int key) {
+                return reinterpret_cast<std::uintptr_t>(copy.find(key));
+            };
+            std::uintptr_t stride = address(2) - address(1);
+            for (int key = 2; key <= 100000; key++)
+            {
+                REQUIRE(address(key) - address(key - 1) == stride);
+            }
+        }
+    }
+
+    GIVEN("A tree of string keys and values")
+    {
+        BinarySearchTree<std::string, std::string> tree;
+        for (int i = 0; i < 200; i++)
+        {
+            tree.insert(std::string(i, 'v'), "key " + std::to_string(i));
+        }
+
+        THEN("It reads back the same")
+        {
+            std::stringstream stream;
+            tree.serialize(stream);
+            BinarySearchTree<std::string, std::string> copy;
+            copy.deserialize(stream);
+            REQUIRE(std::equal(copy.begin(), copy.end(), tree.begin(),
+                               tree.end()));
+            REQUIRE(*copy.find("key 199") == std::string(199, 'v'));
+        }
+    }
+}
+
+SCENARIO("BSTree: Refuse corrupt serialized trees")
+{
+    GIVEN("The bytes of a tree of three keys")
+    {
+        IntTree tree;
+        tree.insert(20, 2);
+        tree.insert(10, 1);
+        tree.insert(30, 3);
+        std::string bytes = serialized(tree);
+
+        // The magic and the count come first, then each node
+        const std::size_t header = 4 + 8;
+
+        IntTree copy;
+        copy.insert(40, 4);
+
+        WHEN("The magic is wrong")
+        {
+            bytes[0] = 'X';
+
+            THEN("Reading it throws and leaves the tree empty")
+            {
+                std::istringstream in(bytes);
+                REQUIRE_THROWS_AS(copy.deserialize(in),
+                                  std::runtime_error);
+                REQUIRE(copy.isEmpty());
+            }
+        }
+
+        WHEN("The stream is cut short")
+        {
+            bytes.resize(bytes.size() - 1);
+
+            THEN("Reading it throws and leaves the tree empty")
+            {
+                std::istringstream in(bytes);
+                REQUIRE_THROWS_AS(copy.deserialize(in),
+                                  std::runtime_error);
+                REQUIRE(copy.isEmpty());
+            }
+        }
+
+        WHEN("The node count is huge")
+        {
+            std::uint64_t count = GENERATE(std::uint64_t{1} << 31,
+                                           std::uint64_t{1} << 33,
+                                           std::uint64_t{1} << 40);
+            std::memcpy(&bytes[4], &count, sizeof count);
+
+            THEN("Reading it throws without trying to allocate it all")
+            {
+                std::istringstream in(bytes);
+                REQUIRE_THROWS_AS(copy.deserialize(in),
+                                  std::runtime_error);
+                REQUIRE(copy.isEmpty());
+            }
+        }
+
+        WHEN("The node count is too small for the shape")
+        {
+            std::uint64_t count = 2;
+            std::memcpy(&bytes[4], &count, sizeof count);
+
+            THEN("Reading it throws and leaves the tree empty")
+            {
+                std::istringstream in(bytes);
+                REQUIRE_THROWS_AS(copy.deserialize(in),
+                                  std::runtime_error);
+                REQUIRE(copy.isEmpty());
+            }
+        }
+
+        WHEN("The root claims no children")
+        {
+            bytes[header] = 0;
+
+            THEN("Reading it throws and leaves the tree empty")
+            {
+                std::istringstream in(bytes);
+                REQUIRE_THROWS_AS(copy.deserialize(in),
+                                  std::runtime_error);
+                REQUIRE(copy.isEmpty());
+            }
+        }
+    }
+}
@@ -0,0 +1,289 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A binary search tree whose nodes are kept in one array
+// and linked by 32-bit indices into it instead of pointers.
+///
+
+#include <CompactTree.h>
+
+#include "TreeTestHelpers.h"
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using IntCompactTree = CompactTree<int, int>;
+
+// Returns the bytes serialize() writes for the tree
+std::string serialized(const IntCompactTree& tree)
+{
+    std::ostringstream out;
+    tree.serialize(out);
+    return out.str();
+}
+
+SCENARIO("CompactTree: Random operations match a std::map")
+{
+    GIVEN("A tree and a map changed by the same random operations")
+    {
+        IntCompactTree tree;
+        std::map<int, int> expected;
+
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(1, 2000);
+        std::uniform_int_distribution<int> opDist(0, 2);
+
+        for (int i = 0; i < 50000; i++)
+        {
+            int key = keyDist(rng);
+            switch (opDist(rng))
+            {
+            case 0:
+            {
+                bool inserted = expected.emplace(key, 10 * key).second;
+                REQUIRE(tree.insert(10 * key, key) == inserted);
+                break;
+            }
+            case 1:
+                expected.erase(key);
+                tree.remove(key);
+                break;
+            default:
+                REQUIRE(tree.contains(key) == (expected.count(key) == 1));
+            }
+        }
+
+        THEN("They hold the same values, in order")
+        {
+            std::ostringstream values;
+            for (auto& [key, value] : expected)
+            {
+                values << value << "\n";
+            }
+            REQUIRE(printed(tree) == values.str());
+            REQUIRE(static_cast<int>(expected.size()) == tree.getCount());
+        }
+    }
+}
+
+SCENARIO("CompactTree: Serialize a tree and read it back")
+{
+    GIVEN("A tree with some of its nodes freed")
+    {
+        IntCompactTree tree;
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(1, 5000);
+        for (int i = 0; i < 2000; i++)
+        {
+            int key = keyDist(rng);
+            tree.insert(10 * key, key);
+        }
+        for (int i = 0; i < 500; i++)
+        {
+            tree.remove(keyDist(rng));
+        }
+
+        WHEN("It is serialized and read into another tree")
+        {
+            std::istringstream in(serialized(tree));
+            IntCompactTree copy;
+            copy.insert(1, 1);
+            copy.deserialize(in);
+
+            THEN("The copy holds the same keys and values")
+            {
+                REQUIRE(printed(copy) == printed(tree));
+                REQUIRE(copy.getCount() == tree.getCount());
+            }
+
+            THEN("The copy has the same arrays, freed nodes and all")
+            {
+                REQUIRE(serialized(copy) == serialized(tree));
+            }
+
+            AND_WHEN("The same keys are added to both")
+            {
+                for (int key = 6000; key < 7000; key++)
+                {
+                    tree.insert(10 * key, key);
+                    copy.insert(10 * key, key);
+                }
+
+                THEN("They reuse the same freed nodes")
+                {
+                    REQUIRE(serialized(copy) == serialized(tree));
+                }
+            }
+        }
+    }
+
+    GIVEN("An empty tree")
+    {
+        IntCompactTree tree;
+
+        THEN("It reads back empty")
+        {
+            std::istringstream in(serialized(tree));
+            IntCompactTree copy;
+            copy.deserialize(in);
+            REQUIRE(copy.isEmpty());
+            REQUIRE(0 == copy.getCount());
+        }
+    }
+
+    GIVEN("A tree of string keys and values")
+    {
+        CompactTree<std::string, std::string> tree;
+        for (int i = 0; i < 200; i++)
+        {
+            tree.insert(std::string(i, 'v'), "key " + std::to_string(i));
+        }
+        tree.remove("key 7");
+
+        THEN("It reads back the same")
+        {
+            std::stringstream stream;
+            tree.serialize(stream);
+            CompactTree<std::string, std::string> copy;
+            copy.deserialize(stream);
+            REQUIRE(printed(copy) == printed(tree));
+            REQUIRE(*copy.find("key 199") == std::string(199, 'v'));
+        }
+    }
+
+    GIVEN("A tree of pointer values, written by ID")
+    {
+        std::vector<std::string> names = {"Ada", "Alan", "Grace"};
+        CompactTree<int, std::string*> tree;
+        for (int id = 0; id < 3; id++)
+        {
+            tree.insert(&names[id], id);
+        }
+
+        THEN("It reads back pointing to the same objects")
+        {
+            // Each key and ID is written as the bytes of an int
+            auto writeInt = [](std::ostream& out, int n) {
+                out.write(reinterpret_cast<const char*>(&n), sizeof n);
+            };
+            auto readInt = [](std::istream& in) {
+                int n = 0;
+                in.read(reinterpret_cast<char*>(&n), sizeof n);
+                return n;
+            };
+
+            std::stringstream stream;
+            tree.serialize(stream, writeInt,
+                           [&](std::ostream& out, std::string* name) {
+                               writeInt(out, name - names.data());
+                           });
+
+            CompactTree<int, std::string*> copy;
+            copy.deserialize(stream, readInt, [&](std::istream& in) {
+                return &names[readInt(in)];
+            });
+            REQUIRE(*copy.find(1) == &names[1]);
+            REQUIRE(printed(copy) == "Ada\nAlan\nGrace\n");
+        }
+    }
+}
+
+SCENARIO("CompactTree: Refuse corrupt serialized trees")
+{
+    GIVEN("The bytes of a tree of two keys")
+    {
+        IntCompactTree tree;
+        tree.insert(10, 1);
+        tree.insert(20, 2);
+        std::string bytes = serialized(tree);
+
+        // The magic, the size, the root and the free list come first,
+        // then each node
+        const std::size_t header = 4 + 8 + 4 + 4;
+        const std::size_t nodeBytes = 4 * sizeof(std::uint32_t);
+
+        IntCompactTree copy;
+        copy.insert(30, 3);
+
+        WHEN("The magic is wrong")
+        {
+            bytes[0] = 'X';
+
+            THEN("Reading it throws and leaves the tree empty")
+            {
+                std::istringstream in(bytes);
+                REQUIRE_THROWS_AS(copy.deserialize(in),
+                                  std::runtime_error);
+                REQUIRE(copy.isEmpty());
+            }
+        }
+
+        WHEN("The stream is cut short")
+        {
+            bytes.resize(bytes.size() - 1);
+
+            THEN("Reading it throws and leaves the tree empty")
+            {
+                std::istringstream in(bytes);
+                REQUIRE_THROWS_AS(copy.deserialize(in),
+                                  std::runtime_error);
+                REQUIRE(copy.isEmpty());
+            }
+        }
+
+        WHEN("The node count is huge")
+        {
+            std::uint64_t size = GENERATE(std::uint64_t{1} << 31,
+                                          std::uint64_t{1} << 33,
+                                          std::uint64_t{1} << 40);
+            std::memcpy(&bytes[4], &size, sizeof size);
+
+            THEN("Reading it throws without trying to allocate it all")
+            {
+                std::istringstream in(bytes);
+                REQUIRE_THROWS_AS(copy.deserialize(in),
+                                  std::runtime_error);
+                REQUIRE(copy.isEmpty());
+            }
+        }
+
+        WHEN("The second node links back to the first")
+        {
+            std::uint32_t first = 0;
+            std::memcpy(&bytes[header + nodeBytes], &first, sizeof first);
+
+            THEN("Reading it throws instead of looping")
+            {
+                std::istringstream in(bytes);
+                REQUIRE_THROWS_AS(copy.deserialize(in),
+                                  std::runtime_error);
+                REQUIRE(copy.isEmpty());
+            }
+        }
+
+        WHEN("A link leads past the end of the arrays")
+        {
+            std::uint32_t past = 2;
+            std::memcpy(&bytes[header + nodeBytes + 4], &past,
+                        sizeof past);
+
+            THEN("Reading it throws")
+            {
+                std::istringstream in(bytes);
+                REQUIRE_THROWS_AS(copy.deserialize(in),
+                                  std::runtime_error);
+                REQUIRE(copy.isEmpty());
+            }
+        }
+    }
+}
@@ -0,0 +1,225 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A binary search tree which many threads may search and
+// change at once.
+///
+
+#include <ConcurrentTree.h>
+
+#include "TreeTestHelpers.h"
+
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using IntTree = ConcurrentTree<int, int>;
+
+// Returns the most levels the tree may have over count leaves: its inner
+// nodes form an AVL tree, with the leaves one level below
+double maxConcurrentHeight(int count)
+{
+    return maxAvlHeight(count) + 1;
+}
+
+SCENARIO("ConcurrentTree: Match a std::map on one thread")
+{
+    GIVEN("A tree and a map changed by the same random operations")
+    {
+        IntTree tree;
+        std::map<int, int> expected;
+
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(1, 2000);
+        std::uniform_int_distribution<int> opDist(0, 2);
+
+        for (int i = 0; i < 50000; i++)
+        {
+            int key = keyDist(rng);
+            switch (opDist(rng))
+            {
+            case 0:
+            {
+                bool inserted = expected.emplace(key, 10 * key).second;
+                REQUIRE(tree.insert(10 * key, key) == inserted);
+                break;
+            }
+            case 1:
+                expected.erase(key);
+                tree.remove(key);
+                break;
+            default:
+            {
+                int value = 0;
+                bool found = tree.find(key, value);
+                REQUIRE(found == (expected.count(key) == 1));
+                if (found)
+                {
+                    REQUIRE(value == 10 * key);
+                }
+            }
+            }
+        }
+
+        THEN("They hold the same keys and values, in order")
+        {
+            std::vector<int> values;
+            for (auto& [key, value] : expected)
+            {
+                values.push_back(value);
+            }
+            REQUIRE(printedValues(tree) == values);
+            REQUIRE(tree.isEmpty() == expected.empty());
+        }
+
+        THEN("The smallest and largest values match")
+        {
+            if (!expected.empty())
+            {
+                REQUIRE(*tree.findMin() == expected.begin()->second);
+                REQUIRE(*tree.findMax() == expected.rbegin()->second);
+            }
+        }
+
+        THEN("The tree is balanced")
+        {
+            int count = static_cast<int>(expected.size());
+            REQUIRE(tree.getHeight() <= maxConcurrentHeight(count));
+        }
+    }
+
+    GIVEN("A tree of keys inserted in order")
+    {
+        IntTree tree;
+        int count = GENERATE(1, 2, 3, 100, 1024, 20000);
+        for (int key = 1; key <= count; key++)
+        {
+            tree.insert(10 * key, key);
+        }
+
+        THEN("It is balanced")
+        {
+            REQUIRE(tree.getHeight() <= maxConcurrentHeight(count));
+        }
+
+        WHEN("Every other key is removed")
+        {
+            for (int key = 2; key <= count; key += 2)
+            {
+                tree.remove(key);
+            }
+
+            THEN("Only the odd keys are left")
+            {
+                for (int key = 1; key <= count; key++)
+                {
+                    REQUIRE(tree.contains(key) == (key % 2 == 1));
+                }
+            }
+
+            THEN("It is still balanced")
+            {
+                int left = (count + 1) / 2;
+                REQUIRE(tree.getHeight() <= maxConcurrentHeight(left));
+            }
+        }
+    }
+}
+
+SCENARIO("ConcurrentTree: Insert, remove and find on many threads")
+{
+    GIVEN("Threads each changing their own keys, mixed through the tree")
+    {
+        const int numThreads = 4;
+        const int numKeys = 4000;
+
+        IntTree tree;
+        std::vector<std::set<int>> expected(numThreads);
+        std::vector<int> wrongValues(numThreads);
+        std::vector<std::thread> threads;
+
+        // Thread t owns the keys k with k % numThreads == t, so it alone
+        // knows whether they should be in the tree
+        for (int t = 0; t < numThreads; t++)
+        {
+            threads.emplace_back([&, t] {
+                std::mt19937 rng(t + 1);
+                std::uniform_int_distribution<int> keyDist(
+                    0, numKeys / numThreads - 1);
+                std::uniform_int_distribution<int> opDist(0, 2);
+                for (int i = 0; i < 40000; i++)
+                {
+                    int key = keyDist(rng) * numThreads + t;
+                    switch (opDist(rng))
+                    {
+                    case 0:
+                        tree.insert(10 * key, key);
+                        expected[t].insert(key);
+                        break;
+                    case 1:
+                        tree.remove(key);
+                        expected[t].erase(key);
+                        break;
+                    default:
+                    {
+                        int value = 0;
+                        bool found = tree.find(key, value);
+                        bool kept = expected[t].count(key) == 1;
+                        if (found != kept || (found && value != 10 * key))
+                        {
+                            wrongValues[t]++;
+                        }
+                    }
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        THEN("Every thread found what it had left in the tree")
+        {
+            for (int t = 0; t < numThreads; t++)
+            {
+                REQUIRE(wrongValues[t] == 0);
+            }
+        }
+
+        THEN("The tree holds exactly the keys the threads left in it")
+        {
+            std::set<int> keys;
+            for (const std::set<int>& own : expected)
+            {
+                keys.insert(own.begin(), own.end());
+            }
+
+            std::vector<int> values;
+            for (int key : keys)
+            {
+                values.push_back(10 * key);
+            }
+            REQUIRE(printedValues(tree) == values);
+
+            for (int key = 0; key < numKeys; key++)
+            {
+                REQUIRE(tree.contains(key) == (keys.count(key) == 1));
+            }
+        }
+
+        THEN("The tree is still about as shallow as an AVL tree")
+        {
+            // Writers racing up the same path may each stop fixing
+            // heights early, so allow a few extra levels
+            int count = static_cast<int>(printedValues(tree).size());
+            REQUIRE(tree.getHeight() <= maxConcurrentHeight(count) + 4);
+        }
+    }
+}
@@ -0,0 +1,113 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: Epoch-based memory reclamation, for trees whose readers
+// take no locks.
+///
+
+#include <EpochReclaimer.h>
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+// Counts the objects of its type deleted so far
+struct Counted
+{
+    static std::atomic<int> deleted;
+
+    ~Counted()
+    {
+        deleted++;
+    }
+};
+
+std::atomic<int> Counted::deleted{0};
+
+// Collects often enough that anything which can be freed is
+void collectAll()
+{
+    for (int i = 0; i < 10; i++)
+    {
+        EpochReclaimer::collect();
+    }
+}
+
+SCENARIO("EpochReclaimer: Free retired objects only after the guards")
+{
+    GIVEN("Another thread holding a Guard")
+    {
+        std::promise<void> guarded;
+        std::promise<void> release;
+        std::thread reader([&] {
+            EpochReclaimer::Guard guard;
+            guarded.set_value();
+            release.get_future().wait();
+        });
+        guarded.get_future().wait();
+
+        // Anything left from an earlier run goes first
+        collectAll();
+        Counted::deleted = 0;
+
+        WHEN("An object is retired and collected while the guard is held")
+        {
+            EpochReclaimer::retire(new Counted);
+            collectAll();
+
+            THEN("It is not freed")
+            {
+                REQUIRE(Counted::deleted == 0);
+            }
+
+            AND_WHEN("The guard is dropped")
+            {
+                release.set_value();
+                reader.join();
+                collectAll();
+
+                THEN("It is freed")
+                {
+                    REQUIRE(Counted::deleted == 1);
+                }
+            }
+        }
+
+        if (reader.joinable())
+        {
+            release.set_value();
+            reader.join();
+        }
+        collectAll();
+    }
+
+    GIVEN("A Guard held by the retiring thread itself")
+    {
+        collectAll();
+        Counted::deleted = 0;
+
+        WHEN("An object is retired and collected inside it")
+        {
+            {
+                EpochReclaimer::Guard guard;
+                EpochReclaimer::retire(new Counted);
+                collectAll();
+
+                THEN("It is not freed while the guard is held")
+                {
+                    REQUIRE(Counted::deleted == 0);
+                }
+            }
+
+            THEN("It is freed once the guard is dropped")
+            {
+                collectAll();
+                REQUIRE(Counted::deleted == 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,170 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: Allocates the nodes of a tree from large slabs, reusing
+// freed nodes through a free list.
+///
+
+#include <NodeArena.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+// A node which counts how many of its kind have been destroyed, and can
+// be made to fail in its constructor
+struct TestNode
+{
+    static int destroyed;
+
+    int key;
+
+    explicit TestNode(int key, bool fail = false) : key{key}
+    {
+        if (fail)
+        {
+            throw std::runtime_error("TestNode: asked to fail");
+        }
+    }
+
+    ~TestNode()
+    {
+        destroyed++;
+    }
+};
+
+int TestNode::destroyed = 0;
+
+SCENARIO("NodeArena: Create and destroy nodes")
+{
+    GIVEN("An empty arena")
+    {
+        NodeArena<TestNode> arena;
+        TestNode::destroyed = 0;
+
+        THEN("It has no slabs")
+        {
+            REQUIRE(0 == arena.getSlabCount());
+        }
+
+        WHEN("A node is created")
+        {
+            TestNode* node = arena.create(7);
+
+            THEN("It holds its key, in the first slab")
+            {
+                REQUIRE(7 == node->key);
+                REQUIRE(1 == arena.getSlabCount());
+            }
+
+            AND_WHEN("It is destroyed and another node created")
+            {
+                arena.destroy(node);
+                TestNode* next = arena.create(8);
+
+                THEN("The destructor ran and the slot is reused")
+                {
+                    REQUIRE(1 == TestNode::destroyed);
+                    REQUIRE(next == node);
+                    REQUIRE(8 == next->key);
+                }
+            }
+
+            AND_WHEN("It is destroyed and a node fails to construct")
+            {
+                arena.destroy(node);
+                REQUIRE_THROWS_AS(arena.create(9, true),
+                                  std::runtime_error);
+
+                THEN("The slot goes back to be used by the next node")
+                {
+                    REQUIRE(arena.create(10) == node);
+                }
+            }
+        }
+
+        WHEN("Many nodes are created")
+        {
+            std::vector<TestNode*> created;
+            for (int i = 0; i < 10000; i++)
+            {
+                created.push_back(arena.create(i));
+            }
+
+            THEN("Each keeps its key")
+            {
+                for (int i = 0; i < 10000; i++)
+                {
+                    REQUIRE(i == created[i]->key);
+                }
+            }
+
+            THEN("They come from a few large slabs")
+            {
+                // 32 + 64 + ... + 4096 nodes in the first 8 slabs, then
+                // 4096 in each
+                REQUIRE(9 == arena.getSlabCount());
+            }
+
+            AND_WHEN("The arena is released")
+            {
+                arena.release();
+
+                THEN("Every slab is gone, and no destructor ran")
+                {
+                    REQUIRE(0 == arena.getSlabCount());
+                    REQUIRE(0 == TestNode::destroyed);
+                }
+            }
+        }
+    }
+
+    GIVEN("An arena with a node already created")
+    {
+        NodeArena<TestNode> arena;
+        arena.create(0);
+
+        WHEN("Room for 1000 more nodes is reserved")
+        {
+            arena.reserve(1000);
+            std::size_t slabs = arena.getSlabCount();
+
+            std::vector<TestNode*> created;
+            for (int i = 1; i <= 1000; i++)
+            {
+                created.push_back(arena.create(i));
+            }
+
+            THEN("They come from one new slab, side by side")
+            {
+                REQUIRE(2 == slabs);
+                REQUIRE(slabs == arena.getSlabCount());
+
+                auto address = [&](std::size_t i) {
+                    return reinterpret_cast<std::uintptr_t>(created[i]);
+                };
+                std::uintptr_t step = address(1) - address(0);
+                REQUIRE(step >= sizeof(TestNode));
+                for (std::size_t i = 1; i < created.size(); i++)
+                {
+                    REQUIRE(address(i) - address(i - 1) == step);
+                }
+            }
+
+            AND_WHEN("Another node is created")
+            {
+                arena.create(1001);
+
+                THEN("It comes from another new slab")
+                {
+                    REQUIRE(slabs + 1 == arena.getSlabCount());
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,224 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A persistent binary search tree, whose old versions stay
+// readable after it changes.
+///
+
+#include <PersistentTree.h>
+
+#include "TreeTestHelpers.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using IntPersistentTree = PersistentTree<int, int>;
+
+// Returns ten times each of the keys from first to last
+std::vector<int> valuesFor(int first, int last)
+{
+    std::vector<int> values;
+    for (int key = first; key <= last; key++)
+    {
+        values.push_back(10 * key);
+    }
+    return values;
+}
+
+SCENARIO("PersistentTree: Keep old snapshots unchanged by later writes")
+{
+    GIVEN("A tree of the keys 1 to 1000, and a snapshot of it")
+    {
+        auto tree = std::make_unique<IntPersistentTree>();
+        for (int key = 1; key <= 1000; key++)
+        {
+            tree->insert(10 * key, key);
+        }
+        IntPersistentTree::Snapshot before = tree->snapshot();
+
+        WHEN("Keys are removed from the tree and others added")
+        {
+            for (int key = 1; key <= 1000; key += 2)
+            {
+                tree->remove(key);
+            }
+            for (int key = 1001; key <= 1500; key++)
+            {
+                tree->insert(10 * key, key);
+            }
+
+            THEN("The tree shows the changes")
+            {
+                REQUIRE(1000 == tree->getCount());
+                REQUIRE_FALSE(tree->contains(1));
+                REQUIRE(tree->contains(1500));
+            }
+
+            THEN("The snapshot still holds exactly the keys 1 to 1000")
+            {
+                REQUIRE(1000 == before.getCount());
+                REQUIRE(printedValues(before) == valuesFor(1, 1000));
+                REQUIRE(*before.find(1) == 10);
+                REQUIRE_FALSE(before.contains(1500));
+                REQUIRE(*before.findMax() == 10000);
+            }
+
+            AND_WHEN("A second snapshot is taken and the tree emptied")
+            {
+                IntPersistentTree::Snapshot after = tree->snapshot();
+                tree->makeEmpty();
+
+                THEN("Each snapshot keeps its own version")
+                {
+                    REQUIRE(tree->isEmpty());
+                    REQUIRE(printedValues(before) == valuesFor(1, 1000));
+                    REQUIRE(1000 == after.getCount());
+                    REQUIRE(*after.findMin() == 20);
+                    REQUIRE(*after.findMax() == 15000);
+                }
+            }
+        }
+
+        WHEN("The tree is destroyed")
+        {
+            tree.reset();
+
+            THEN("The snapshot keeps its nodes alive")
+            {
+                REQUIRE(printedValues(before) == valuesFor(1, 1000));
+            }
+        }
+
+        WHEN("A new tree is started from the snapshot and changed")
+        {
+            IntPersistentTree branch(before);
+            branch.remove(500);
+            branch.insert(0, 0);
+
+            THEN("Neither the snapshot nor the first tree changes")
+            {
+                REQUIRE(printedValues(before) == valuesFor(1, 1000));
+                REQUIRE(tree->contains(500));
+                REQUIRE_FALSE(tree->contains(0));
+                REQUIRE(1000 == branch.getCount());
+            }
+        }
+    }
+}
+
+SCENARIO("PersistentTree: Random changes match a std::map")
+{
+    GIVEN("A tree and a map changed by the same random operations")
+    {
+        IntPersistentTree tree;
+        std::map<int, int> expected;
+
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(1, 2000);
+        std::uniform_int_distribution<int> opDist(0, 2);
+
+        for (int i = 0; i < 20000; i++)
+        {
+            int key = keyDist(rng);
+            switch (opDist(rng))
+            {
+            case 0:
+            {
+                bool inserted = expected.emplace(key, 10 * key).second;
+                REQUIRE(tree.insert(10 * key, key) == inserted);
+                break;
+            }
+            case 1:
+                expected.erase(key);
+                tree.remove(key);
+                break;
+            default:
+                REQUIRE(tree.contains(key) == (expected.count(key) == 1));
+            }
+        }
+
+        THEN("They hold the same values, in order")
+        {
+            std::vector<int> values;
+            for (auto& [key, value] : expected)
+            {
+                values.push_back(value);
+            }
+            REQUIRE(printedValues(tree.snapshot()) == values);
+            REQUIRE(static_cast<int>(expected.size()) == tree.getCount());
+        }
+    }
+}
+
+SCENARIO("PersistentTree: Read snapshots while another thread writes")
+{
+    GIVEN("A tree of the even keys 2 to 2000")
+    {
+        IntPersistentTree tree;
+        for (int key = 2; key <= 2000; key += 2)
+        {
+            tree.insert(10 * key, key);
+        }
+
+        WHEN("Readers check snapshots while a writer adds the odd keys")
+        {
+            std::atomic<bool> writing{true};
+            std::atomic<int> badSnapshots{0};
+
+            std::thread writer([&] {
+                for (int key = 1; key < 2000; key += 2)
+                {
+                    tree.insert(10 * key, key);
+                }
+                writing = false;
+            });
+
+            // Each snapshot must hold every even key, and the odd keys
+            // added so far with no gaps, since they go in in order
+            std::vector<std::thread> readers;
+            for (int r = 0; r < 2; r++)
+            {
+                readers.emplace_back([&] {
+                    do
+                    {
+                        auto snap = tree.snapshot();
+                        int odd = snap.getCount() - 1000;
+
+                        std::vector<int> expected;
+                        for (int key = 1; key <= 2000; key++)
+                        {
+                            if (key % 2 == 0 || key < 2 * odd)
+                            {
+                                expected.push_back(10 * key);
+                            }
+                        }
+                        if (printedValues(snap) != expected)
+                        {
+                            badSnapshots++;
+                        }
+                    } while (writing);
+                });
+            }
+
+            writer.join();
+            for (std::thread& reader : readers)
+            {
+                reader.join();
+            }
+
+            THEN("Every snapshot was one whole version of the tree")
+            {
+                REQUIRE(0 == badSnapshots);
+                REQUIRE(2000 == tree.getCount());
+            }
+        }
+    }
+}
@@ -0,0 +1,151 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A self-adjusting (splay) binary search tree.
+///
+
+#include <SplayTree.h>
+
+#include "TreeTestHelpers.h"
+
+#include <map>
+#include <random>
+#include <sstream>
+
+#include <catch2/catch.hpp>
+
+SCENARIO("SplayTree: Random operations match a std::map")
+{
+    GIVEN("A tree and a map changed by the same random operations")
+    {
+        SplayTree<int, int> tree;
+        std::map<int, int> expected;
+
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(1, 2000);
+        std::uniform_int_distribution<int> opDist(0, 2);
+
+        for (int i = 0; i < 50000; i++)
+        {
+            int key = keyDist(rng);
+            switch (opDist(rng))
+            {
+            case 0:
+            {
+                bool inserted = expected.emplace(key, 10 * key).second;
+                REQUIRE(tree.insert(10 * key, key) == inserted);
+                break;
+            }
+            case 1:
+                expected.erase(key);
+                tree.remove(key);
+                break;
+            default:
+            {
+                const int* value = tree.find(key);
+                REQUIRE((value != nullptr) == (expected.count(key) == 1));
+                if (value)
+                {
+                    REQUIRE(*value == 10 * key);
+                }
+            }
+            }
+        }
+
+        THEN("They hold the same values, in order")
+        {
+            std::ostringstream values;
+            for (auto& [key, value] : expected)
+            {
+                values << value << "\n";
+            }
+            REQUIRE(printed(tree) == values.str());
+        }
+
+        THEN("The smallest and largest values match")
+        {
+            if (!expected.empty())
+            {
+                REQUIRE(*tree.findMin() == expected.begin()->second);
+                REQUIRE(*tree.findMax() == expected.rbegin()->second);
+            }
+        }
+    }
+}
+
+SCENARIO("SplayTree: Keep found values in place while the tree moves")
+{
+    GIVEN("A tree of 1000 keys")
+    {
+        SplayTree<int, int> tree;
+        for (int key = 1; key <= 1000; key++)
+        {
+            tree.insert(10 * key, key);
+        }
+
+        WHEN("A value is found, and then many other keys")
+        {
+            const int* found = tree.find(500);
+            for (int key = 1; key <= 1000; key += 7)
+            {
+                tree.find(key);
+            }
+
+            THEN("The pointer still points to the same value")
+            {
+                REQUIRE(found == tree.find(500));
+                REQUIRE(*found == 5000);
+            }
+        }
+    }
+}
+
+SCENARIO("SplayTree: Handle a tree as deep as it is long")
+{
+    GIVEN("A tree of keys inserted in increasing order")
+    {
+        // Each new key becomes the root, with the old root as its left
+        // child, so the tree is one long chain to the left
+        const int count = 100000;
+        SplayTree<int, int> tree;
+        for (int key = 1; key <= count; key++)
+        {
+            tree.insert(10 * key, key);
+        }
+
+        WHEN("The key at the bottom of the chain is found")
+        {
+            const int* value = tree.find(1);
+
+            THEN("It is found with its value")
+            {
+                REQUIRE(value != nullptr);
+                REQUIRE(*value == 10);
+            }
+
+            AND_THEN("Every other key is still found")
+            {
+                for (int key = 1; key <= count; key++)
+                {
+                    REQUIRE(tree.contains(key));
+                }
+            }
+        }
+
+        WHEN("Every key is removed, smallest first")
+        {
+            for (int key = 1; key <= count; key++)
+            {
+                tree.remove(key);
+            }
+
+            THEN("The tree is empty")
+            {
+                REQUIRE(tree.isEmpty());
+                REQUIRE(tree.findMin() == nullptr);
+            }
+        }
+    }
+}
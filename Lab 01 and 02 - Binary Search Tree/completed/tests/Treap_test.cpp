@@ -0,0 +1,248 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: A treap, with split, join and range removal, and parallel
+// set operations.
+///
+
+#include <Treap.h>
+
+#include "TreeTestHelpers.h"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using IntTreap = Treap<int, int>;
+
+// Returns the keys of the treap, in order
+std::vector<int> treapKeys(const IntTreap& treap)
+{
+    std::vector<int> keys = printedValues(treap);
+    for (int& key : keys)
+    {
+        key /= 10;
+    }
+    return keys;
+}
+
+// Fills the treap and the set with the same count random keys, from 1 to
+// maxKey
+void fillRandom(IntTreap& treap, std::set<int>& keys, int count,
+                int maxKey, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> keyDist(1, maxKey);
+    while (static_cast<int>(keys.size()) < count)
+    {
+        int key = keyDist(rng);
+        bool inserted = keys.insert(key).second;
+        REQUIRE(treap.insert(10 * key, key) == inserted);
+    }
+}
+
+SCENARIO("Treap: Split, join and remove ranges like a std::set")
+{
+    std::mt19937 rng{std::random_device{}()};
+
+    GIVEN("A treap and a set of the same random keys")
+    {
+        IntTreap treap;
+        std::set<int> keys;
+        int count = GENERATE(0, 1, 10, 5000);
+        fillRandom(treap, keys, count, 4 * count + 1, rng);
+
+        THEN("They hold the same keys, in order")
+        {
+            REQUIRE(treapKeys(treap) ==
+                    std::vector<int>(keys.begin(), keys.end()));
+        }
+
+        WHEN("The treap is split at a random key")
+        {
+            std::uniform_int_distribution<int> keyDist(0, 4 * count + 2);
+            int at = keyDist(rng);
+            IntTreap upper = treap.split(at);
+
+            THEN("The keys below it stay, and the rest move out")
+            {
+                REQUIRE(treapKeys(treap) ==
+                        std::vector<int>(keys.begin(),
+                                         keys.lower_bound(at)));
+                REQUIRE(treapKeys(upper) ==
+                        std::vector<int>(keys.lower_bound(at),
+                                         keys.end()));
+            }
+
+            AND_WHEN("The halves are joined back together")
+            {
+                treap.join(upper);
+
+                THEN("The treap is whole again, and the other empty")
+                {
+                    REQUIRE(treapKeys(treap) ==
+                            std::vector<int>(keys.begin(), keys.end()));
+                    REQUIRE(upper.isEmpty());
+                }
+            }
+
+            AND_WHEN("The halves are joined the wrong way round")
+            {
+                THEN("The join is refused, and neither treap changes")
+                {
+                    if (!treap.isEmpty() && !upper.isEmpty())
+                    {
+                        REQUIRE_THROWS_AS(upper.join(treap),
+                                          std::invalid_argument);
+                        REQUIRE(treapKeys(treap) ==
+                                std::vector<int>(keys.begin(),
+                                                 keys.lower_bound(at)));
+                        REQUIRE(treapKeys(upper) ==
+                                std::vector<int>(keys.lower_bound(at),
+                                                 keys.end()));
+                    }
+                }
+            }
+        }
+
+        WHEN("Random ranges are removed")
+        {
+            std::uniform_int_distribution<int> keyDist(0, 4 * count + 2);
+            for (int i = 0; i < 20; i++)
+            {
+                int lo = keyDist(rng);
+                int hi = keyDist(rng);
+
+                int expected = 0;
+                if (!(hi < lo))
+                {
+                    auto first = keys.lower_bound(lo);
+                    auto last = keys.upper_bound(hi);
+                    expected = static_cast<int>(
+                        std::distance(first, last));
+                    keys.erase(first, last);
+                }
+                REQUIRE(treap.removeRange(lo, hi) == expected);
+            }
+
+            THEN("The treap holds the keys left in the set")
+            {
+                REQUIRE(treapKeys(treap) ==
+                        std::vector<int>(keys.begin(), keys.end()));
+            }
+        }
+    }
+}
+
+SCENARIO("Treap: Unite, intersect and subtract like std::set")
+{
+    std::mt19937 rng{std::random_device{}()};
+
+    GIVEN("Two treaps of random keys which partly overlap")
+    {
+        // The largest are big enough for the set operations to run in
+        // several threads
+        auto [mineCount, theirCount] = GENERATE(
+            std::make_pair(0, 100), std::make_pair(100, 0),
+            std::make_pair(1000, 50), std::make_pair(50, 1000),
+            std::make_pair(20000, 20000));
+        int maxKey = 2 * std::max(mineCount, theirCount);
+
+        IntTreap mine;
+        std::set<int> mineKeys;
+        fillRandom(mine, mineKeys, mineCount, maxKey, rng);
+
+        // Their values end in 1, to tell which treap a node came from
+        IntTreap theirs;
+        std::set<int> theirKeys;
+        std::uniform_int_distribution<int> keyDist(1, maxKey);
+        while (static_cast<int>(theirKeys.size()) < theirCount)
+        {
+            int key = keyDist(rng);
+            theirKeys.insert(key);
+            theirs.insert(10 * key + 1, key);
+        }
+
+        WHEN("Their keys are united into mine")
+        {
+            mine.unionWith(theirs);
+
+            THEN("Mine holds every key, with my value where both had it")
+            {
+                std::vector<int> expected;
+                std::set<int> all = mineKeys;
+                all.insert(theirKeys.begin(), theirKeys.end());
+                for (int key : all)
+                {
+                    expected.push_back(mineKeys.count(key) ? 10 * key
+                                                           : 10 * key + 1);
+                }
+                REQUIRE(printedValues(mine) == expected);
+                REQUIRE(theirs.isEmpty());
+            }
+        }
+
+        WHEN("Mine is intersected with theirs")
+        {
+            mine.intersectWith(theirs);
+
+            THEN("Mine holds only the keys in both, with my values")
+            {
+                std::vector<int> expected;
+                std::set_intersection(mineKeys.begin(), mineKeys.end(),
+                                      theirKeys.begin(), theirKeys.end(),
+                                      std::back_inserter(expected));
+                for (int& key : expected)
+                {
+                    key *= 10;
+                }
+                REQUIRE(printedValues(mine) == expected);
+                REQUIRE(theirs.isEmpty());
+            }
+        }
+
+        WHEN("Their keys are subtracted from mine")
+        {
+            mine.difference(theirs);
+
+            THEN("Mine holds only the keys they did not have")
+            {
+                std::vector<int> expected;
+                std::set_difference(mineKeys.begin(), mineKeys.end(),
+                                    theirKeys.begin(), theirKeys.end(),
+                                    std::back_inserter(expected));
+                REQUIRE(treapKeys(mine) == expected);
+                REQUIRE(theirs.isEmpty());
+            }
+        }
+
+        WHEN("Mine is united and intersected with itself")
+        {
+            mine.unionWith(mine);
+            mine.intersectWith(mine);
+
+            THEN("It is unchanged")
+            {
+                REQUIRE(treapKeys(mine) ==
+                        std::vector<int>(mineKeys.begin(),
+                                         mineKeys.end()));
+            }
+
+            AND_WHEN("It is subtracted from itself")
+            {
+                mine.difference(mine);
+
+                THEN("It is empty")
+                {
+                    REQUIRE(mine.isEmpty());
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Lab 02 - Binary Search Tree
+//
+// Description: Helpers shared by the tests of the trees.
+//
+// Most tests store each key with ten times itself as its value, so that
+// the values a tree prints show which keys it holds, in order.
+///
+
+#pragma once
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Returns what the tree, or anything else with printTree(out), prints.
+ */
+template <typename Tree> std::string printed(const Tree& tree)
+{
+    std::ostringstream out;
+    tree.printTree(out);
+    return out.str();
+}
+
+/*
+ * Returns the int values the tree prints, in order.
+ */
+template <typename Tree> std::vector<int> printedValues(const Tree& tree)
+{
+    std::istringstream in(printed(tree));
+    std::vector<int> values;
+    int value = 0;
+    while (in >> value)
+    {
+        values.push_back(value);
+    }
+    return values;
+}
+
+/*
+ * Returns the most levels an AVL tree of count nodes may have.
+ */
+inline double maxAvlHeight(int count)
+{
+    return 1.4405 * std::log2(count + 2.0) - 0.3277;
+}
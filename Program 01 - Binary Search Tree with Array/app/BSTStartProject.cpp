@@ -64,6 +64,10 @@ int main()
     cout << "Tree2 count: " << tree2.getCount() << endl;
     cout << "Tree2 size: " << tree2.getSize() << endl << endl;
 
+    // Remove a run of keys by leaving tombstones instead of shifting
+    // subtrees up for every key
+    tree2.setDeletionMode(DeletionMode::Tombstone);
+
     // for turn-in uncomment these lines
     for (int i = 101; i <= 110; ++i)
     {
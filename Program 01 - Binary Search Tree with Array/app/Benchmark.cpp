@@ -0,0 +1,179 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: Times lookups of random int keys in each kind of search
+// tree. std::map stands in for a pointer-based binary search tree.
+//
+// Usage: bst_bench [number of keys] [number of lookups]
+//
+// Layouts matter most once the keys outgrow the last level cache and the
+// pages the TLB can map, e.g. with 16000000 keys.
+///
+
+#include "BSTree.h"
+#include "BucketTree.h"
+#include "ImplicitSearchTree.h"
+#include "LearnedIndex.h"
+#include "StaticSearchTree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Calls lookup(key) for every key, and prints the average time per
+ * lookup along with the number of keys found (which also keeps the
+ * lookups from being optimized away).
+ */
+template <typename Lookup>
+void timeLookups(const std::string& name, const std::vector<int>& queries,
+                 Lookup lookup)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    long found = 0;
+    for (int key : queries)
+    {
+        found += lookup(key);
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> elapsed = stop - start;
+
+    std::cout << std::left << std::setw(28) << name << std::right
+              << std::setw(8) << std::fixed << std::setprecision(1)
+              << elapsed.count() / queries.size() << " ns/lookup  ("
+              << found << " found)\n";
+}
+
+int main(int argc, char* argv[])
+{
+    int numKeys = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+    int numQueries = (argc > 2) ? std::atoi(argv[2]) : 1000000;
+
+    // Use the even numbers as keys, in random order, so that searching
+    // for a random number finds a key about half of the time
+    std::mt19937 rng{42};
+    std::vector<int> keys(numKeys);
+    std::iota(keys.begin(), keys.end(), 0);
+    for (int& key : keys)
+    {
+        key *= 2;
+    }
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    std::vector<int> queries(numQueries);
+    std::uniform_int_distribution<int> queryDist(0, 2 * numKeys);
+    for (int& query : queries)
+    {
+        query = queryDist(rng);
+    }
+
+    std::cout << numKeys << " keys, " << numQueries
+              << " random lookups\n\n";
+
+    // Array tree, checked, one allocated Pair per node. Rebalancing
+    // growth keeps the array to a few times the number of keys.
+    BinarySearchTree<int, int, CheckedAccess, RebalancingGrowth>
+        arrayTree;
+    for (int key : keys)
+    {
+        arrayTree.insert(key, key);
+    }
+    timeLookups("array BST", queries,
+                [&](int key) { return arrayTree.contains(key); });
+
+    // Array tree, unchecked, keys and values inline
+    BinarySearchTree<int, int, UncheckedAccess, RebalancingGrowth,
+                     InlineStorage>
+        inlineTree;
+    for (int key : keys)
+    {
+        inlineTree.insert(key, key);
+    }
+    timeLookups("array BST (inline)", queries,
+                [&](int key) { return inlineTree.contains(key); });
+
+    // The same tree with a Bloom filter in front, which rejects most of
+    // the half of the lookups which miss
+    inlineTree.enableFilter();
+    timeLookups("array BST (inline, filter)", queries,
+                [&](int key) { return inlineTree.contains(key); });
+    std::cout << "    filter false positive rate: " << std::setprecision(2)
+              << 100 * inlineTree.getFilterStats().falsePositiveRate()
+              << "%\n";
+
+    // Array tree over buckets of up to 64 sorted keys
+    BucketTree<int, int> bucketTree;
+    for (int key : keys)
+    {
+        bucketTree.insert(key, key);
+    }
+    timeLookups("BucketTree", queries,
+                [&](int key) { return bucketTree.contains(key); });
+
+    // Pointer-based balanced tree
+    std::map<int, int> map;
+    for (int key : keys)
+    {
+        map.emplace(key, key);
+    }
+    timeLookups("std::map", queries,
+                [&](int key) { return map.count(key) > 0; });
+
+    // Binary search of a sorted array
+    std::vector<int> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    timeLookups("std::binary_search", queries, [&](int key) {
+        return std::binary_search(sorted.begin(), sorted.end(), key);
+    });
+
+    // The read-only trees are built from sorted pairs
+    std::vector<std::pair<int, int>> pairs;
+    pairs.reserve(sorted.size());
+    for (int key : sorted)
+    {
+        pairs.emplace_back(key, key);
+    }
+
+    // Complete binary trees in breadth-first and van Emde Boas order
+    auto eytzingerTree =
+        ImplicitSearchTree<int, int, EytzingerLayout>::fromSorted(
+            pairs.begin(), pairs.end());
+    timeLookups("Eytzinger layout", queries,
+                [&](int key) { return eytzingerTree.contains(key); });
+
+    auto vebTree = ImplicitSearchTree<int, int, VanEmdeBoasLayout>::
+        fromSorted(pairs.begin(), pairs.end());
+    timeLookups("van Emde Boas layout", queries,
+                [&](int key) { return vebTree.contains(key); });
+
+    // 16 keys per node
+    auto staticTree =
+        StaticSearchTree<int, int>::fromSorted(pairs.begin(), pairs.end());
+#ifdef __AVX2__
+    std::string staticName = "StaticSearchTree (AVX2)";
+#else
+    std::string staticName = "StaticSearchTree (scalar)";
+#endif
+    timeLookups(staticName, queries,
+                [&](int key) { return staticTree.contains(key); });
+
+    // One line per segment, then a search of 2 * 16 + 2 keys
+    auto learnedIndex =
+        LearnedIndex<int, int>::fromSorted(pairs.begin(), pairs.end());
+    timeLookups("LearnedIndex", queries,
+                [&](int key) { return learnedIndex.contains(key); });
+
+    return 0;
+}
@@ -1,29 +1,111 @@
 
+#pragma once
+
 #include <iostream>
 #include <ostream>
+#include <type_traits>
+#include <utility>
+
+
+/*
+ * True if values of type T can be written to an std::ostream.
+ */
+template <typename T, typename = void> struct IsPrintable : std::false_type
+{
+};
+
+template <typename T>
+struct IsPrintable<T, std::void_t<decltype(std::declval<std::ostream&>()
+                                           << std::declval<const T&>())>>
+    : std::true_type
+{
+};
 
 
+/*
+ * The value may be a pointer to an object held elsewhere, as in the
+ * original trees, or the object itself, held inline in the tree (which
+ * saves an allocation per node and a pointer chase per lookup). Inline
+ * values may be move-only.
+ */
 template <typename KeyComparable, typename Value> class BSTInterface
 {
-    // only allow pointer types for the value
-    static_assert(std::is_pointer<Value>::value, "Expected a pointer");
+  public:
+    // What findMin() and findMax() return: the value itself for pointer
+    // values, otherwise a pointer to the value in the tree. Both are
+    // nullptr if the tree is empty.
+    using ValueHandle =
+        std::conditional_t<std::is_pointer<Value>::value, Value,
+                           const Value*>;
+
+  protected:
+    /*
+     * Returns the handle findMin() and findMax() return for a value in
+     * the tree.
+     */
+    [[nodiscard]] static ValueHandle toHandle(const Value& value)
+    {
+        if constexpr (std::is_pointer<Value>::value)
+        {
+            return value;
+        }
+        else
+        {
+            return &value;
+        }
+    }
+
+    /*
+     * Prints a value to the stream out. Pointer values print the object
+     * they point to. Values which cannot be printed are shown as
+     * "<value>".
+     */
+    static void printValue(std::ostream& out, const Value& value)
+    {
+        using Item = std::remove_pointer_t<Value>;
+        if constexpr (!IsPrintable<Item>::value)
+        {
+            out << "<value>";
+        }
+        else if constexpr (std::is_pointer<Value>::value)
+        {
+            out << *value;
+        }
+        else
+        {
+            out << value;
+        }
+    }
 
-  private:
   public:
     BSTInterface() = default;
     BSTInterface(const BSTInterface& rhs) = default;
     BSTInterface(BSTInterface&& rhs) noexcept = default;
     virtual ~BSTInterface() = default;
 
-    [[nodiscard]] virtual const Value findMin() const = 0;
-    [[nodiscard]] virtual const Value findMax() const = 0;
+    [[nodiscard]] virtual ValueHandle findMin() const = 0;
+    [[nodiscard]] virtual ValueHandle findMax() const = 0;
     [[nodiscard]] virtual bool
     contains(const KeyComparable& key) const = 0;
-    [[nodiscard]] virtual bool find(const KeyComparable& key,
-                                    Value& itemFound) const = 0;
+    [[nodiscard]] virtual const Value*
+    find(const KeyComparable& key) const = 0;
     [[nodiscard]] virtual bool isEmpty() const = 0;
     virtual void printTree(std::ostream& out = std::cout) const = 0;
     virtual void makeEmpty() = 0;
     virtual bool insert(Value item, KeyComparable key) = 0;
     virtual void remove(const KeyComparable& key) = 0;
-};
\ No newline at end of file
+
+    /*
+     * Copies the value with the given key into itemFound.
+     * Returns true if it was found, false otherwise.
+     */
+    bool find(const KeyComparable& key, Value& itemFound) const
+    {
+        const Value* found = find(key);
+        if (found)
+        {
+            itemFound = *found;
+        }
+        return found != nullptr;
+    }
+};
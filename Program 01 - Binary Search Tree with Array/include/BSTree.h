@@ -5,8 +5,9 @@
 //
 // Description: A Binary Search Tree which is backed by an array.
 //
-// The tree holds nodes where the key is any type and the value is a
-// pointer.
+// The tree holds nodes where the key is any type and the value is either
+// a pointer or, to save an allocation and a pointer chase, the object
+// itself held inline (which may be move-only, see emplace()).
 //
 // The tree has functions to find the value associated with the minimum or
 // maximum key or any given key. The tree can also be printed as values
@@ -16,68 +17,122 @@
 // needs to grow (which requires copying the entire array to a new, larger
 // array). Deletions may be moderately slow, as any children of the deleted
 // node may need to be shifted up the array.
+//
+// The tree can be walked in order with bidirectional iterators, which
+// move between nodes using only index arithmetic (the parent of index i
+// is i / 2), so no recursion or auxiliary stack is needed.
+//
+// Optionally, the tree keeps the size of every subtree in a second array
+// indexed like the first. This costs one int per slot, but allows rank,
+// select and range count queries in O(log n).
+//
+// Since the array already encodes the shape of the tree, it can be saved
+// to a file as is and memory-mapped later (see MappedBSTree.h), which
+// avoids re-inserting every value on startup.
+//
+// In tombstone deletion mode, removing a key only marks its node as
+// deleted, which is O(log n). Once too many nodes are tombstones, the
+// whole tree is rebuilt into a balanced shape without them, so a burst of
+// deletions costs amortized O(log n) each instead of shifting subtrees.
+//
+// How the tree checks its indices, grows its array and stores its nodes
+// are chosen at compile time with policies (see BSTreePolicies.h). The
+// defaults check every access and match the original behavior; a
+// production build may use, for example,
+//     BinarySearchTree<Key, Value, UncheckedAccess, GeometricGrowth,
+//                      InlineStorage>
+// where a search compiles down to a tight loop over the key array.
+//
+// Optionally, a Bloom filter sits in front of find() and contains() (see
+// enableFilter()), so most searches for missing keys return after reading
+// one cache line instead of walking the tree.
 ///
 
-#include "BSTInterface.h"
+#pragma once
 
+#include "BSTInterface.h"
+#include "BSTreePolicies.h"
+#include "BloomFilter.h"
+#include "MappedBSTree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * How BinarySearchTree::remove() deletes nodes.
+ *   Shift:     Delete the node and shift its subtrees up.
+ *   Tombstone: Mark the node as deleted and rebuild the tree later.
+ */
+enum class DeletionMode
+{
+    Shift,
+    Tombstone
+};
 
-template <typename KeyComparable, typename Value>
+template <typename KeyComparable, typename Value,
+          typename Checking = CheckedAccess, typename Growth = ExactGrowth,
+          template <typename, typename> class StoragePolicy = PairStorage>
 class BinarySearchTree : BSTInterface<KeyComparable, Value>
 {
+    using Base = BSTInterface<KeyComparable, Value>;
+
   public:
+    using typename Base::ValueHandle;
+
     inline static int DEFAULT_SIZE = 25;
+    inline static double DEFAULT_TOMBSTONE_RATIO = 0.5;
 
   private:
-    /*
-     * Private Node Class
-     */
-    class Pair
-    {
-      public:
-        KeyComparable key;
-        Value value;
+    using Storage = StoragePolicy<KeyComparable, Value>;
 
-        // Initialize class members from constructor arguments
-        // by using a member initializer list.
-        // This method uses direct initialization, which is more
-        // efficient than using assignment operators inside the
-        // constructor body.
-        Pair(KeyComparable& key, Value& value) : value{value}, key{key}
-        {
-        }
-    };
+    // a node taken out of the array while rebuilding
+    using Entry = typename Storage::Entry;
+
+    using Filter = BloomFilter<KeyComparable>;
 
     // number of values stored in the tree
     int count = 0;
 
+    // number of removed nodes still held in the tree
+    int tombstones = 0;
+
+    // how remove() deletes nodes
+    DeletionMode deletionMode = DeletionMode::Shift;
+
+    // the fraction of nodes which may be tombstones before rebuilding
+    double maxTombstoneRatio = DEFAULT_TOMBSTONE_RATIO;
+
     // capacity of array holding the tree
     int size = DEFAULT_SIZE;
 
-    // the array that holds the pairs
-    Pair** root = createTree();
+    // the array that holds the nodes
+    Storage storage{DEFAULT_SIZE};
 
-    /*
-     * Return a newly created pointer to an array of Pairs of given size
-     * (or default) for a new tree.
-     */
-    static auto createTree(int capacity = DEFAULT_SIZE)
-    {
-        return new Pair*[capacity]();
-    }
+    // the number of nodes in the subtree at each index of the array, or
+    // nullptr if subtree sizes are not tracked
+    int* sizes = nullptr;
+
+    // a filter of the keys in the tree, asked before searching for a key,
+    // or nullptr if there is none
+    std::unique_ptr<Filter> filter;
 
     /*
-     * Delete the current tree.
+     * Return a newly created array of subtree sizes of the given capacity
+     * if subtree sizes are tracked, otherwise nullptr.
      */
-    void deleteTree()
+    [[nodiscard]] int* createSizes(int capacity = DEFAULT_SIZE) const
     {
-        for (size_t i = 1; i < this->size; i++)
-        {
-            deleteNodeAt(i, /* doShift */ false);
-        }
-
-        delete[] this->root;
+        return this->sizes ? new int[capacity]() : nullptr;
     }
 
     /*
@@ -96,6 +151,27 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
         return 2 * index + 1;
     }
 
+    /*
+     * Returns the index of the parent of a given index.
+     * The parent of the root is 0, which is not a valid index.
+     */
+    [[nodiscard]] static int getParent(int index) noexcept
+    {
+        return index / 2;
+    }
+
+    /*
+     * Returns true if the given index is in the subtree at root.
+     */
+    [[nodiscard]] static bool isInSubtree(int index, int root) noexcept
+    {
+        while (index > root)
+        {
+            index = getParent(index);
+        }
+        return index == root;
+    }
+
     /*
      * Returns true if the given index is in the range of [1, size),
      * false otherwise. Note: This structure is 1-indexed, so 0 is not
@@ -108,17 +184,12 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
 
     /*
      * Asserts that the given index is valid.
-     * If it is invalid, a std::out_of_range exception is thrown.
+     * With CheckedAccess, a std::out_of_range exception is thrown if it
+     * is invalid.
      */
     void assertValidIndex(int idx) const
     {
-        if (!isValidIndex(idx))
-        {
-            // FAIL: Invalid index
-            auto msg =
-                std::string("Invalid index: ") + std::to_string(idx);
-            throw std::out_of_range(msg);
-        }
+        Checking::checkIndex(isValidIndex(idx), idx);
     }
 
     /*
@@ -127,35 +198,66 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
      */
     [[nodiscard]] bool hasNodeAt(int index) const noexcept
     {
-        return isValidIndex(index) && this->root[index];
+        return isValidIndex(index) && this->storage.isOccupied(index);
+    }
+
+    /*
+     * Returns true if there is a node at the given index which has not
+     * been removed, false otherwise.
+     */
+    [[nodiscard]] bool isLiveAt(int index) const noexcept
+    {
+        return hasNodeAt(index) && !this->storage.isTombstone(index);
     }
 
     /*
      * Asserts that there must be a non-empty node at the given index.
-     * Throws std::invalid_argument if the index is invalid or if the node
-     * is empty
+     * With CheckedAccess, throws std::invalid_argument if the index is
+     * invalid or if the node is empty
      */
     void assertHasNodeAt(int index) const
     {
-        if (!hasNodeAt(index))
+        Checking::checkNode(hasNodeAt(index), index);
+    }
+
+    /*
+     * Asserts that subtree sizes are tracked by this tree.
+     * Throws std::logic_error if they are not.
+     */
+    void assertHasSizes() const
+    {
+        if (!this->sizes)
         {
-            // FAIL: Empty node
-            auto msg = std::string("Node is empty, Index: ") +
-                       std::to_string(index);
-            throw std::invalid_argument(msg);
+            // FAIL: Order statistics are disabled
+            throw std::logic_error("Subtree sizes are not tracked");
         }
     }
 
     /*
-     * Returns a pointer to the Pair at the given index.
-     * Throws std::out_of_range if index is invalid.
-     * Throws std::invalid_argument if Node at the given index is
-     * empty.
+     * Returns the number of nodes in the subtree at the given index.
+     * Indices past the end of the array hold empty subtrees.
      */
-    [[nodiscard]] Pair* getNodeAt(int index) const
+    [[nodiscard]] int getSizeAt(int index) const noexcept
     {
-        assertHasNodeAt(index);
-        return this->root[index];
+        return isValidIndex(index) ? this->sizes[index] : 0;
+    }
+
+    /*
+     * Adds delta to the subtree size of the given index and its ancestors
+     * up to, but not including, the ancestor stop [default: past the
+     * root]. Does nothing if subtree sizes are not tracked.
+     */
+    void adjustSizes(int index, int delta, int stop = 0) noexcept
+    {
+        if (!this->sizes)
+        {
+            return; // RETURN: Not tracking sizes
+        }
+
+        for (; index != stop && index >= 1; index = getParent(index))
+        {
+            this->sizes[index] += delta;
+        }
     }
 
     /*
@@ -164,21 +266,22 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
      * Throws std::invalid_argument if Node at the given index is
      * empty.
      */
-    [[nodiscard]] KeyComparable getKeyAt(int index) const
+    [[nodiscard]] const KeyComparable& getKeyAt(int index) const
     {
-        return getNodeAt(index)->key;
+        assertHasNodeAt(index);
+        return this->storage.key(index);
     }
 
     /*
      * Returns the value at the given index.
-     * Note: The value is a pointer to an underlying value.
      * Throws std::out_of_range if index is invalid.
      * Throws std::invalid_argument if Node at the given index is
      * empty.
      */
-    [[nodiscard]] Value getValueAt(int index) const
+    [[nodiscard]] const Value& getValueAt(int index) const
     {
-        return getNodeAt(index)->value;
+        assertHasNodeAt(index);
+        return this->storage.value(index);
     }
 
     /*
@@ -199,12 +302,19 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
             return; // RETURN: Nothing to delete
         }
 
-        // Delete the node
-        delete this->root[index];
-        this->root[index] = nullptr;
+        // Update counts. Tombstones are not counted in subtree sizes.
+        if (this->storage.isTombstone(index))
+        {
+            this->tombstones--;
+        }
+        else
+        {
+            this->count--;
+            adjustSizes(index, -1);
+        }
 
-        // Update count
-        this->count--;
+        // Delete the node
+        this->storage.erase(index);
 
         // If shifting, shift children up
         if (doShift)
@@ -228,7 +338,14 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
         auto swapNodes = [&](int newIndex) {
             if (hasNodeAt(newIndex))
             {
-                std::swap(this->root[index], this->root[newIndex]);
+                // The moved node leaves the subtrees between its old and
+                // new slots
+                if (isLiveAt(newIndex))
+                {
+                    adjustSizes(newIndex, -1, index);
+                }
+
+                this->storage.move(newIndex, index);
                 shift(newIndex);
                 return true; // SUCCESS: Nodes swapped
             }
@@ -243,99 +360,279 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
     }
 
     /*
-     * Assigns a (key, value) Pair to the node at the given index.
-     * Will delete any existing data.
-     * Throws std::out_of_range if index is invalid.
+     * Marks the node at the given index as removed, leaving it in place
+     * so the rest of the tree is undisturbed. Rebuilds the tree if too
+     * many nodes are tombstones.
      */
-    void setNode(KeyComparable key, Value value, int index)
+    void markTombstone(int index)
     {
-        assertValidIndex(index);
+        assertHasNodeAt(index);
+        this->storage.setTombstone(index, true);
+        this->count--;
+        this->tombstones++;
+        adjustSizes(index, -1);
 
-        // Delete any existing data
-        deleteNodeAt(index, false);
+        double ratio = static_cast<double>(this->tombstones) /
+                       (this->count + this->tombstones);
+        if (ratio > this->maxTombstoneRatio)
+        {
+            compact();
+        }
+    }
 
-        // Set the replacement node
-        this->root[index] = new Pair(key, value);
+    /*
+     * Takes every node in the subtree at the given index out of the
+     * array, in order of keys. Tombstones are deleted rather than
+     * returned.
+     */
+    [[nodiscard]] std::vector<Entry> takeSubtree(int index)
+    {
+        // Find the nodes before emptying any slots, since the walk
+        // relies on the shape of the tree
+        std::vector<int> indices;
+        for (int i = hasNodeAt(index) ? findMin(index) : 0;
+             i != 0 && isInSubtree(i, index); i = nextIndex(i))
+        {
+            indices.push_back(i);
+        }
 
-        // Update count
-        this->count++;
+        std::vector<Entry> entries;
+        entries.reserve(indices.size());
+        for (int i : indices)
+        {
+            if (this->sizes)
+            {
+                this->sizes[i] = 0;
+            }
+
+            if (this->storage.isTombstone(i))
+            {
+                this->storage.erase(i);
+                this->tombstones--;
+            }
+            else
+            {
+                entries.push_back(this->storage.take(i));
+            }
+        }
+        return entries;
     }
 
     /*
-     * Prints the inorder the tree to the stream out
+     * Places the given nodes, which are sorted by key, into the subtree at
+     * the given index as a balanced tree. The middle node becomes the
+     * root of the subtree.
      */
-    void printTree(int index, std::ostream& out) const
+    void placeBalanced(std::vector<Entry>& entries, int lo, int hi,
+                       int index)
     {
-        if (!isValidIndex(index) || !hasNodeAt(index))
+        if (lo >= hi)
         {
-            return; // FAIL: No such node
+            return; // RETURN: No nodes left for this subtree
         }
 
-        // Print Left -> Current -> Right
-        printTree(getLeft(index), out);
-        out << *getValueAt(index) << "\n";
-        printTree(getRight(index), out);
+        int mid = lo + (hi - lo) / 2;
+        this->storage.put(index, std::move(entries[mid]));
+        if (this->sizes)
+        {
+            this->sizes[index] = hi - lo;
+        }
+
+        placeBalanced(entries, lo, mid, getLeft(index));
+        placeBalanced(entries, mid + 1, hi, getRight(index));
     }
 
     /*
-     * Grow array to a larger size
+     * Rebuilds the subtree at the given index as a balanced tree without
+     * any tombstones.
      */
-    void grow(size_t newSize = 0)
+    void rebuildSubtree(int index)
     {
-        // Check if we actually need to grow
-        if (newSize <= this->size)
+        auto entries = takeSubtree(index);
+        placeBalanced(entries, 0, static_cast<int>(entries.size()), index);
+    }
+
+    /*
+     * Returns the number of live nodes in the subtree at the given index.
+     */
+    [[nodiscard]] int countSubtree(int index) const
+    {
+        if (this->sizes)
         {
-            return; // RETURN: No need to grow
+            return getSizeAt(index);
         }
 
-        // Create a new array and copy the data from the current array
-        // into it
-        auto newRoot = createTree(newSize);
-        std::copy(this->root, this->root + this->size, newRoot);
+        int nodes = 0;
+        for (int i = hasNodeAt(index) ? findMin(index) : 0;
+             i != 0 && isInSubtree(i, index); i = nextIndex(i))
+        {
+            nodes += isLiveAt(i);
+        }
+        return nodes;
+    }
 
-        // Update the object properties
-        delete[] this->root;
-        this->root = newRoot;
-        this->size = newSize;
+    /*
+     * Returns the number of complete levels which fit in the array below
+     * and including the given index.
+     */
+    [[nodiscard]] int getLevelsBelow(int index) const noexcept
+    {
+        int levels = 0;
+        for (long long span = 1; (index + 1) * span <= this->size;
+             span *= 2)
+        {
+            levels++;
+        }
+        return levels;
     }
 
     /*
-     * Inserts the given key-value pair into the tree in sorted order
-     * below the given index. Returns true if added, false if not
-     * added.
+     * Returns the lowest ancestor of the given empty index whose subtree
+     * is sparse enough to be rebuilt as a balanced tree, or 0 if there is
+     * none and the array must grow.
+     *
+     * A subtree with room for L levels may hold up to half of its
+     * 2^L - 1 slots near the leaves, but only a quarter at the root. A
+     * rebuilt subtree thus leaves its descendants room to fill before
+     * it is rebuilt again, which keeps sorted insertions from rebuilding
+     * the same large subtree over and over (as in a packed-memory
+     * array).
      */
-    bool insert(KeyComparable key, Value& value, int index)
+    [[nodiscard]] int findScapegoat(int index) const
     {
-        // Expand the capacity as needed
-        // Note: This copies the array, so could be slow.
-        if (index >= this->size)
+        // live nodes in the subtree at child
+        int nodes = 0;
+
+        double rootLevels = getLevelsBelow(1);
+        for (int child = index, parent = getParent(index); parent >= 1;
+             child = parent, parent = getParent(parent))
         {
-            grow(index + 1);
+            int sibling = (child == getLeft(parent)) ? getRight(parent)
+                                                     : getLeft(parent);
+            nodes += isLiveAt(parent) + countSubtree(sibling);
+
+            // Any density under one half leaves the last level free for
+            // the new node once rebuilt
+            int levels = getLevelsBelow(parent);
+            double density = 0.5 - 0.25 * (levels / rootLevels);
+            if (nodes < std::ldexp(density, levels))
+            {
+                return parent; // SUCCESS: Rebuilding here makes room
+            }
         }
+        return 0; // FAIL: The array must grow
+    }
 
+    /*
+     * Assigns a (key, value) Pair to the node at the given index, with
+     * the value constructed from the given arguments.
+     * Will delete any existing data.
+     * Throws std::out_of_range if index is invalid.
+     */
+    template <typename... Args>
+    void setNode(int index, KeyComparable key, Args&&... args)
+    {
         assertValidIndex(index);
 
-        // If current index is empty, put the new node there
-        if (!hasNodeAt(index))
+        // Delete any existing data
+        deleteNodeAt(index, false);
+
+        // Set the replacement node
+        this->storage.emplace(index, std::move(key),
+                              std::forward<Args>(args)...);
+
+        // Update count
+        this->count++;
+        adjustSizes(index, +1);
+    }
+
+    /*
+     * Grow array to a larger size
+     */
+    void grow(int newSize = 0)
+    {
+        // Check if we actually need to grow
+        if (newSize <= this->size)
         {
-            setNode(key, value, index);
-            return true; // SUCCESS: Key added
+            return; // RETURN: No need to grow
         }
 
-        auto currentKey = getKeyAt(index);
+        // Move the nodes into a new, larger array
+        this->storage.resize(newSize);
 
+        // Subtree sizes live at the same indices, so grow them alongside
+        if (this->sizes)
+        {
+            auto newSizes = createSizes(newSize);
+            std::copy(this->sizes, this->sizes + this->size, newSizes);
+            delete[] this->sizes;
+            this->sizes = newSizes;
+        }
+
+        this->size = newSize;
+    }
+
+    /*
+     * Inserts the given key into the tree in sorted order, with the value
+     * constructed from the given arguments. Returns true if added, false
+     * if not added.
+     */
+    template <typename... Args>
+    bool insertNode(KeyComparable key, Args&&... args)
+    {
+        int index = findSlot(key);
+        return insertAt(index, std::move(key),
+                        std::forward<Args>(args)...);
+    }
+
+    /*
+     * Inserts the given key into the tree at index, the slot findSlot()
+     * returns for it, with the value constructed from the given
+     * arguments. Sets index to where the node ends up, which differs if
+     * part of the tree is rebuilt to make room. Returns true if added,
+     * false if the key was already in the tree.
+     */
+    template <typename... Args>
+    bool insertAt(int& index, KeyComparable key, Args&&... args)
+    {
         // Check if key is already in the tree
-        if (key == currentKey)
+        if (hasNodeAt(index))
         {
-            return false; // FAIL: Key already exists
+            if (isLiveAt(index))
+            {
+                return false; // FAIL: Key already exists
+            }
+
+            // Revive a removed node in place
+            this->storage.value(index) =
+                Value(std::forward<Args>(args)...);
+            this->storage.setTombstone(index, false);
+            this->tombstones--;
+            this->count++;
+            adjustSizes(index, +1);
+            addToFilter(index);
+            return true; // SUCCESS: Key added
         }
 
-        // Use left branch for smaller keys
-        // Use right branch for larger keys
-        int newIndex =
-            (key < currentKey) ? getLeft(index) : getRight(index);
+        // Expand the capacity as needed
+        // Note: This copies the array, so could be slow.
+        if (index >= this->size)
+        {
+            if constexpr (Growth::REBALANCE)
+            {
+                int scapegoat = findScapegoat(index);
+                if (scapegoat)
+                {
+                    rebuildSubtree(scapegoat);
+                    index = findSlot(key);
+                }
+            }
+            grow(Growth::grownSize(this->size, index));
+        }
 
-        return insert(key, value, newIndex);
+        setNode(index, std::move(key), std::forward<Args>(args)...);
+        addToFilter(index);
+        return true; // SUCCESS: Key added
     }
 
     /*
@@ -377,106 +674,533 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
     }
 
     /*
-     * Search for the given key starting at the given index.
-     * Returns the index of the node or 0 if not found.
+     * Returns the index of the node with the given key, or of the empty
+     * slot where it would be inserted, searching the subtree at index
+     * [default: the whole tree]. The slot may be past the end of the
+     * array.
      */
-    [[nodiscard]] int find(const KeyComparable& key, const int index) const
+    [[nodiscard]] int findSlot(const KeyComparable& key,
+                               int index = 1) const noexcept
     {
-        if (!hasNodeAt(index))
+        while (hasNodeAt(index))
         {
-            return 0; // FAIL: Not found.
-        }
+            const KeyComparable& currentKey = this->storage.key(index);
+            if (key == currentKey)
+            {
+                break; // Found the key
+            }
 
-        auto currentKey = getKeyAt(index);
+            // The right child directly follows the left child, so step
+            // to it without a branch
+            index = getLeft(index) + (currentKey < key);
+        }
+        return index;
+    }
 
-        // Check current node
-        if (currentKey == key)
+    /*
+     * Returns the slot for the given key as findSlot() does, but
+     * searching from the node at hint, which should hold a smaller key,
+     * instead of from the root. Climbs from the hint only as far as it
+     * must to reach a subtree which holds the key, so a key just after
+     * the hint is found in a step or two. A hint which holds no node or
+     * a larger key is no help, and the search starts from the root.
+     */
+    [[nodiscard]] int findSlotAfter(int hint,
+                                    const KeyComparable& key) const
+    {
+        if (!hasNodeAt(hint) || !(this->storage.key(hint) < key))
         {
-            return index; // SUCCESS: Found the key.
+            return findSlot(key); // RETURN: No help from the hint
         }
 
-        // Search left or right subtrees
-        int newIndex =
-            (key < currentKey) ? getLeft(index) : getRight(index);
+        // The key is in the right subtree of the hint, unless it is not
+        // below the nearest ancestor whose left subtree holds the hint.
+        // That ancestor is found by dropping the right steps (the
+        // trailing 1 bits of the index) and then the left step.
+        int from = hint;
+        while (true)
+        {
+            int above = from;
+            while (above & 1)
+            {
+                above = getParent(above);
+            }
+            above = getParent(above);
 
-        return find(key, newIndex);
+            if (above == 0 || key < this->storage.key(above))
+            {
+                break; // Found the subtree
+            }
+            if (key == this->storage.key(above))
+            {
+                return above; // SUCCESS: Found the key
+            }
+            from = above;
+        }
+        return findSlot(key, getRight(from));
     }
 
-
-  public:
     /*
-     * CONSTRUCTOR
+     * Search for the given key.
+     * Returns the index of the node or 0 if not found.
      */
-    BinarySearchTree() = default;
+    [[nodiscard]] int findIndex(const KeyComparable& key) const noexcept
+    {
+        int index = findSlot(key);
+
+        // Skip removed nodes
+        return isLiveAt(index) ? index : 0;
+    }
 
     /*
-     * DESTRUCTOR
+     * Search for the given key, asking the filter first if there is one.
+     * Returns the index of the node or 0 if not found.
      */
-    ~BinarySearchTree() override
+    [[nodiscard]] int lookupIndex(const KeyComparable& key) const
     {
-        deleteTree();
+        if constexpr (IsHashable<KeyComparable>::value)
+        {
+            if (this->filter)
+            {
+                if (!this->filter->mayContain(key))
+                {
+                    return 0; // FAIL: Ruled out by the filter
+                }
+
+                int index = findIndex(key);
+                if (index < 1)
+                {
+                    this->filter->recordFalsePositive();
+                }
+                return index;
+            }
+        }
+        return findIndex(key);
     }
 
     /*
-     * Finds the node with the smallest element in the tree
+     * Refills the filter with the keys in the tree, sized for twice as
+     * many, if it is stale or too small (or if force is true).
      */
-    [[nodiscard]] const Value findMin() const override
+    void refreshFilter(bool force = false)
     {
-        int found = findLast(1, getLeft);
-        return hasNodeAt(found) ? getValueAt(found) : nullptr;
+        if constexpr (IsHashable<KeyComparable>::value)
+        {
+            if (!this->filter ||
+                !(force || this->filter->needsRebuild(this->count)))
+            {
+                return; // RETURN: Nothing to refresh
+            }
+
+            this->filter->reset(2 * this->count);
+            for (auto it = begin(); it != end(); ++it)
+            {
+                this->filter->add(it.key());
+            }
+        }
     }
 
     /*
-     * Finds the node with the largest element in the tree
+     * Adds the key at the given index to the filter, if there is one.
      */
-    [[nodiscard]] const Value findMax() const override
+    void addToFilter(int index)
     {
-        int found = findLast(1, getRight);
-        return hasNodeAt(found) ? getValueAt(found) : nullptr;
+        if constexpr (IsHashable<KeyComparable>::value)
+        {
+            if (this->filter)
+            {
+                this->filter->add(getKeyAt(index));
+                refreshFilter();
+            }
+        }
     }
 
     /*
-     * Finds the node with that the key
-     * updates the founditem refrerence if found
-     * returns true if it was found
-     * returns false if it was not
+     * Returns the index of the node which follows the given index in
+     * order, or 0 if it is the last node.
      */
-    bool find(const KeyComparable& key,
-              /* out */ Value& founditem) const override
+    [[nodiscard]] int nextIndex(int index) const
     {
-        int index = find(key, 1);
-        if (index < 1)
+        // The successor is the smallest node in the right subtree
+        int rIndex = getRight(index);
+        if (hasNodeAt(rIndex))
         {
-            return false; // FAIL: key not found
+            return findMin(rIndex);
         }
 
-        // extract value into the founditem outparam.
-        founditem = getValueAt(index);
-        return true; // SUCCESS
+        // Otherwise, climb while we are a right child. The parent of the
+        // first left child found is the successor.
+        while (index > 1 && index == getRight(getParent(index)))
+        {
+            index = getParent(index);
+        }
+        return getParent(index);
     }
 
     /*
-     * Returns true if the item is found in the tree
+     * Returns the index of the node which precedes the given index in
+     * order, or 0 if it is the first node.
      */
-    [[nodiscard]] bool contains(const KeyComparable& key) const override
+    [[nodiscard]] int prevIndex(int index) const
     {
-        return find(key, 1) > 0;
+        // The predecessor is the largest node in the left subtree
+        int lIndex = getLeft(index);
+        if (hasNodeAt(lIndex))
+        {
+            return findMax(lIndex);
+        }
+
+        // Otherwise, climb while we are a left child. The parent of the
+        // first right child found is the predecessor.
+        while (index > 1 && index == getLeft(getParent(index)))
+        {
+            index = getParent(index);
+        }
+        return getParent(index);
     }
 
     /*
-     * Returns true if tree has no nodes
+     * Returns the index of the first node whose key is not less than the
+     * given key, or 0 if there is no such node.
+     * If inclusive is false, returns the first node whose key is greater
+     * than the given key.
      */
-    [[nodiscard]] bool isEmpty() const override
+    [[nodiscard]] int findBound(const KeyComparable& key,
+                                bool inclusive) const
     {
-        return this->count == 0;
+        int found = 0;
+        int index = 1;
+        while (hasNodeAt(index))
+        {
+            const KeyComparable& currentKey = this->storage.key(index);
+
+            // Remember the candidate and look for a smaller one on the
+            // left, otherwise the bound must be on the right
+            bool isCandidate =
+                inclusive ? !(currentKey < key) : key < currentKey;
+            if (isCandidate)
+            {
+                found = index;
+                index = getLeft(index);
+            }
+            else
+            {
+                index = getRight(index);
+            }
+        }
+        return found;
     }
 
     /*
-     * Prints the inorder the tree to the stream out
+     * Returns the index of the first node at or after the given index
+     * which has not been removed, or 0 if there is none.
+     */
+    [[nodiscard]] int skipForward(int index) const
+    {
+        while (index != 0 && !isLiveAt(index))
+        {
+            index = nextIndex(index);
+        }
+        return index;
+    }
+
+    /*
+     * Returns the index of the last node at or before the given index
+     * which has not been removed, or 0 if there is none.
+     */
+    [[nodiscard]] int skipBackward(int index) const
+    {
+        while (index != 0 && !isLiveAt(index))
+        {
+            index = prevIndex(index);
+        }
+        return index;
+    }
+
+    /*
+     * Returns the number of nodes whose key is less than the given key.
+     * If inclusive is true, also counts a node whose key is equal.
+     */
+    [[nodiscard]] int countBelow(const KeyComparable& key,
+                                 bool inclusive) const
+    {
+        int below = 0;
+        int index = 1;
+        while (hasNodeAt(index))
+        {
+            const KeyComparable& currentKey = this->storage.key(index);
+
+            // If the current node counts, so does its whole left subtree
+            bool isBelow =
+                inclusive ? !(key < currentKey) : currentKey < key;
+            if (isBelow)
+            {
+                below += getSizeAt(getLeft(index)) + isLiveAt(index);
+                index = getRight(index);
+            }
+            else
+            {
+                index = getLeft(index);
+            }
+        }
+        return below;
+    }
+
+
+  public:
+    /*
+     * Bidirectional iterator over the tree in order of keys.
+     * Dereferencing yields the value; the key is available from key().
+     * Iterators are invalidated by any change to the tree.
+     */
+    class Iterator
+    {
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Value*;
+        using reference = const Value&;
+
+      private:
+        friend class BinarySearchTree;
+
+        const BinarySearchTree* tree = nullptr;
+
+        // index of the current node, 0 for end()
+        int index = 0;
+
+        Iterator(const BinarySearchTree* tree, int index)
+            : tree{tree}, index{index}
+        {
+        }
+
+      public:
+        Iterator() = default;
+
+        [[nodiscard]] const KeyComparable& key() const
+        {
+            return this->tree->getKeyAt(this->index);
+        }
+
+        reference operator*() const
+        {
+            return this->tree->getValueAt(this->index);
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        Iterator& operator++()
+        {
+            const auto* t = this->tree;
+            this->index = t->skipForward(t->nextIndex(this->index));
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator prev = *this;
+            ++*this;
+            return prev;
+        }
+
+        // Decrementing end() moves to the last node
+        Iterator& operator--()
+        {
+            const auto* t = this->tree;
+            this->index = t->skipBackward(
+                (this->index == 0) ? t->findLast(1, getRight)
+                                   : t->prevIndex(this->index));
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            Iterator prev = *this;
+            --*this;
+            return prev;
+        }
+
+        bool operator==(const Iterator& rhs) const
+        {
+            return this->tree == rhs.tree && this->index == rhs.index;
+        }
+
+        bool operator!=(const Iterator& rhs) const
+        {
+            return !(*this == rhs);
+        }
+    };
+
+    /*
+     * CONSTRUCTOR
+     */
+    BinarySearchTree() = default;
+
+    /*
+     * CONSTRUCTOR
+     * If trackSizes is true, subtree sizes are kept for rank(), select()
+     * and countRange().
+     */
+    explicit BinarySearchTree(bool trackSizes)
+    {
+        if (trackSizes)
+        {
+            this->sizes = new int[this->size]();
+        }
+    }
+
+    // The nodes are owned by exactly one tree
+    BinarySearchTree(const BinarySearchTree&) = delete;
+    BinarySearchTree& operator=(const BinarySearchTree&) = delete;
+
+    BinarySearchTree(BinarySearchTree&& rhs) noexcept
+        : count{std::exchange(rhs.count, 0)},
+          tombstones{std::exchange(rhs.tombstones, 0)},
+          deletionMode{rhs.deletionMode},
+          maxTombstoneRatio{rhs.maxTombstoneRatio},
+          size{std::exchange(rhs.size, 0)},
+          storage{std::move(rhs.storage)},
+          sizes{std::exchange(rhs.sizes, nullptr)},
+          filter{std::move(rhs.filter)}
+    {
+    }
+
+    BinarySearchTree& operator=(BinarySearchTree&& rhs) noexcept
+    {
+        std::swap(this->count, rhs.count);
+        std::swap(this->tombstones, rhs.tombstones);
+        std::swap(this->deletionMode, rhs.deletionMode);
+        std::swap(this->maxTombstoneRatio, rhs.maxTombstoneRatio);
+        std::swap(this->size, rhs.size);
+        std::swap(this->storage, rhs.storage);
+        std::swap(this->sizes, rhs.sizes);
+        std::swap(this->filter, rhs.filter);
+        return *this;
+    }
+
+    /*
+     * DESTRUCTOR
+     */
+    ~BinarySearchTree() override
+    {
+        delete[] this->sizes;
+    }
+
+    /*
+     * Finds the node with the smallest element in the tree
+     */
+    [[nodiscard]] ValueHandle findMin() const override
+    {
+        return isEmpty() ? nullptr : Base::toHandle(*begin());
+    }
+
+    /*
+     * Finds the node with the largest element in the tree
+     */
+    [[nodiscard]] ValueHandle findMax() const override
+    {
+        return isEmpty() ? nullptr : Base::toHandle(*--end());
+    }
+
+    /*
+     * Finds the node with the key
+     * returns a pointer to its value in the tree if found
+     * returns nullptr if not
+     */
+    [[nodiscard]] const Value*
+    find(const KeyComparable& key) const override
+    {
+        int index = lookupIndex(key);
+        return (index < 1) ? nullptr : &getValueAt(index);
+    }
+
+    // find(key, founditem) copies the value out
+    using Base::find;
+
+    /*
+     * Returns true if the item is found in the tree
+     */
+    [[nodiscard]] bool contains(const KeyComparable& key) const override
+    {
+        return lookupIndex(key) > 0;
+    }
+
+    /*
+     * Returns true if tree has no nodes
+     */
+    [[nodiscard]] bool isEmpty() const override
+    {
+        return this->count == 0;
+    }
+
+    /*
+     * Prints the inorder the tree to the stream out
      */
     void printTree(std::ostream& out = std::cout) const override
     {
-        printTree(1, out);
+        for (const auto& value : *this)
+        {
+            Base::printValue(out, value);
+            out << "\n";
+        }
+    }
+
+    /*
+     * Returns an iterator to the node with the smallest key
+     */
+    [[nodiscard]] Iterator begin() const
+    {
+        return {this, hasNodeAt(1) ? skipForward(findMin(1)) : 0};
+    }
+
+    /*
+     * Returns an iterator past the node with the largest key
+     */
+    [[nodiscard]] Iterator end() const
+    {
+        return {this, 0};
+    }
+
+    /*
+     * Returns an iterator to the first node whose key is not less than
+     * the given key, or end() if there is none.
+     */
+    [[nodiscard]] Iterator lowerBound(const KeyComparable& key) const
+    {
+        return {this,
+                skipForward(findBound(key, /* inclusive */ true))};
+    }
+
+    /*
+     * Returns an iterator to the first node whose key is greater than the
+     * given key, or end() if there is none.
+     */
+    [[nodiscard]] Iterator upperBound(const KeyComparable& key) const
+    {
+        return {this,
+                skipForward(findBound(key, /* inclusive */ false))};
+    }
+
+    /*
+     * Calls visitor(key, value) in order for every node whose key is in
+     * the range [lo, hi]. Returns the number of nodes visited.
+     */
+    template <typename Visitor>
+    int rangeScan(const KeyComparable& lo, const KeyComparable& hi,
+                  Visitor visitor) const
+    {
+        int visited = 0;
+        for (auto it = lowerBound(lo); it != end() && !(hi < it.key());
+             ++it)
+        {
+            visitor(it.key(), *it);
+            visited++;
+        }
+        return visited;
     }
 
     /*
@@ -485,9 +1209,16 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
      */
     void makeEmpty() override
     {
-        deleteTree();
-        this->root = createTree();
+        this->storage = Storage(DEFAULT_SIZE);
+
+        int* newSizes = createSizes();
+        delete[] this->sizes;
+        this->sizes = newSizes;
+
         this->size = DEFAULT_SIZE;
+        this->count = 0;
+        this->tombstones = 0;
+        refreshFilter(/* force */ true);
     }
 
     /*
@@ -498,7 +1229,49 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
      */
     bool insert(Value value, KeyComparable key) override
     {
-        return insert(key, value, 1);
+        return insertNode(std::move(key), std::move(value));
+    }
+
+    /*
+     * Inserts a node into the tree, constructing its value in place from
+     * the given arguments. Returns true if added, false if the key was
+     * already in the tree.
+     */
+    template <typename... Args>
+    bool emplace(KeyComparable key, Args&&... args)
+    {
+        return insertNode(std::move(key), std::forward<Args>(args)...);
+    }
+
+    /*
+     * Inserts a node into the tree, searching from the hint (an iterator
+     * to a node with a smaller key, such as the one returned by the last
+     * insert) instead of from the root. See findSlotAfter().
+     * Returns an iterator to the node with the key, whether it was added
+     * or was already in the tree.
+     */
+    Iterator insertHint(Iterator hint, KeyComparable key, Value value)
+    {
+        int index = findSlotAfter(hint.index, key);
+        insertAt(index, std::move(key), std::move(value));
+        return {this, index};
+    }
+
+    /*
+     * Inserts every (key, value) pair of the run, in order, each one
+     * searched for from the last (see insertHint()). The run should be
+     * sorted by key, or nearly so. Returns the number of items inserted.
+     */
+    template <typename Range> int insertSortedRun(const Range& run)
+    {
+        int inserted = 0;
+        int index = 0;
+        for (const auto& [key, value] : run)
+        {
+            index = findSlotAfter(index, key);
+            inserted += insertAt(index, key, value);
+        }
+        return inserted;
     }
 
     /*
@@ -506,12 +1279,288 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
      */
     void remove(const KeyComparable& key) override
     {
-        int index = find(key, 1);
+        int index = findIndex(key);
         if (index < 1)
         {
             return; // Key not found.
         }
-        deleteNodeAt(index, true);
+
+        if (this->deletionMode == DeletionMode::Tombstone)
+        {
+            markTombstone(index);
+        }
+        else
+        {
+            deleteNodeAt(index, true);
+        }
+
+        // The key's bits stay set in the filter until it is rebuilt
+        if constexpr (IsHashable<KeyComparable>::value)
+        {
+            if (this->filter)
+            {
+                this->filter->recordRemoval();
+                refreshFilter();
+            }
+        }
+    }
+
+    /*
+     * Sets how remove() deletes nodes.
+     */
+    void setDeletionMode(DeletionMode mode) noexcept
+    {
+        this->deletionMode = mode;
+    }
+
+    /*
+     * Sets the fraction of nodes which may be tombstones before the tree
+     * is rebuilt [default: 0.5].
+     */
+    void setMaxTombstoneRatio(double ratio) noexcept
+    {
+        this->maxTombstoneRatio = ratio;
+    }
+
+    /*
+     * Returns the number of removed nodes still held in the tree.
+     */
+    [[nodiscard]] int getTombstoneCount() const noexcept
+    {
+        return this->tombstones;
+    }
+
+    /*
+     * Rebuilds the tree as a balanced tree without any tombstones. The
+     * array shrinks to the smallest size which holds the balanced tree,
+     * but never below the default size.
+     */
+    void compact()
+    {
+        // Take the remaining nodes out in order, freeing the tombstones
+        auto entries = takeSubtree(1);
+
+        // A balanced tree of n nodes needs indices up to 2^height - 1
+        int newSize = 1;
+        while (newSize <= this->count)
+        {
+            newSize *= 2;
+        }
+        newSize = std::max(newSize, DEFAULT_SIZE);
+
+        this->storage.resize(newSize);
+        auto newSizes = createSizes(newSize);
+        delete[] this->sizes;
+        this->sizes = newSizes;
+        this->size = newSize;
+
+        placeBalanced(entries, 0, static_cast<int>(entries.size()), 1);
+    }
+
+    /*
+     * Puts a Bloom filter of about bitsPerKey bits per key [default: 10]
+     * in front of find() and contains(), so that most searches for
+     * missing keys return without walking the tree. The filter follows
+     * insertions, and is rebuilt from the tree once it is outgrown or a
+     * quarter of its keys have been removed.
+     */
+    void enableFilter(double bitsPerKey = Filter::DEFAULT_BITS_PER_KEY)
+    {
+        static_assert(IsHashable<KeyComparable>::value,
+                      "Expected a key which std::hash can hash");
+
+        this->filter =
+            std::make_unique<Filter>(2 * this->count, bitsPerKey);
+        refreshFilter(/* force */ true);
+    }
+
+    /*
+     * Removes the filter, if there is one.
+     */
+    void disableFilter() noexcept
+    {
+        this->filter.reset();
+    }
+
+    [[nodiscard]] bool hasFilter() const noexcept
+    {
+        return this->filter != nullptr;
+    }
+
+    /*
+     * Returns how the filter has answered searches since it was enabled,
+     * or all zeros if there is no filter.
+     */
+    [[nodiscard]] BloomFilterStats getFilterStats() const
+    {
+        if (!this->filter)
+        {
+            return {}; // RETURN: No filter
+        }
+        return this->filter->getStats();
+    }
+
+    /*
+     * Returns true if subtree sizes are tracked, so that rank(), select()
+     * and countRange() may be used.
+     */
+    [[nodiscard]] bool hasOrderStatistics() const noexcept
+    {
+        return this->sizes != nullptr;
+    }
+
+    /*
+     * Returns the number of keys in the tree which are less than the
+     * given key.
+     * Throws std::logic_error if subtree sizes are not tracked.
+     */
+    [[nodiscard]] int rank(const KeyComparable& key) const
+    {
+        assertHasSizes();
+        return countBelow(key, /* inclusive */ false);
+    }
+
+    /*
+     * Returns an iterator to the node with the k-th smallest key,
+     * counting from 0, or end() if k is out of range.
+     * Throws std::logic_error if subtree sizes are not tracked.
+     */
+    [[nodiscard]] Iterator select(int k) const
+    {
+        assertHasSizes();
+
+        if (k < 0 || k >= this->count)
+        {
+            return end(); // FAIL: No such node
+        }
+
+        // Skip whole left subtrees until the k-th node is found.
+        // Tombstones are not counted.
+        int index = 1;
+        while (true)
+        {
+            int leftSize = getSizeAt(getLeft(index));
+            int live = isLiveAt(index);
+            if (k < leftSize)
+            {
+                index = getLeft(index);
+            }
+            else if (k == leftSize && live)
+            {
+                return {this, index}; // SUCCESS: Found the node
+            }
+            else
+            {
+                k -= leftSize + live;
+                index = getRight(index);
+            }
+        }
+    }
+
+    /*
+     * Returns the number of keys in the range [lo, hi].
+     * Throws std::logic_error if subtree sizes are not tracked.
+     */
+    [[nodiscard]] int countRange(const KeyComparable& lo,
+                                 const KeyComparable& hi) const
+    {
+        assertHasSizes();
+
+        if (hi < lo)
+        {
+            return 0; // RETURN: Empty range
+        }
+        return countBelow(hi, /* inclusive */ true) -
+               countBelow(lo, /* inclusive */ false);
+    }
+
+    /*
+     * Saves the tree to the file at the given path, so it can be opened
+     * with openMapped(). The keys and the values (or the objects they
+     * point to) must be trivially copyable.
+     * Throws std::runtime_error if the file cannot be written.
+     */
+    void saveTo(const std::string& path) const
+    {
+        using Item = std::remove_pointer_t<Value>;
+        static_assert(std::is_trivially_copyable<KeyComparable>::value,
+                      "Expected a trivially copyable key");
+        static_assert(std::is_trivially_copyable<Item>::value,
+                      "Expected trivially copyable items");
+
+        auto header = BSTFileHeader::create(
+            sizeof(KeyComparable), sizeof(Item), this->size, this->count);
+        header.minIndex = begin().index;
+        header.maxIndex = isEmpty() ? 0 : (--end()).index;
+
+        // Lay out each region in memory, then write the file in one pass
+        auto words = BSTFileHeader::bitmapWords(this->size);
+        std::vector<KeyComparable> keys(this->size);
+        std::vector<std::uint64_t> occupied(words);
+        std::vector<std::uint64_t> live(words);
+        std::vector<Item> items(this->size);
+        for (int i = 1; i < this->size; i++)
+        {
+            if (hasNodeAt(i))
+            {
+                auto bit = std::uint64_t{1} << (i % 64);
+                keys[i] = getKeyAt(i);
+                occupied[i / 64] |= bit;
+                if (isLiveAt(i))
+                {
+                    live[i / 64] |= bit;
+                }
+                if constexpr (std::is_pointer<Value>::value)
+                {
+                    if (getValueAt(i))
+                    {
+                        items[i] = *getValueAt(i);
+                    }
+                }
+                else
+                {
+                    items[i] = getValueAt(i);
+                }
+            }
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        auto writeRegion = [&](std::uint64_t offset, const void* data,
+                               std::size_t bytes) {
+            // Pad up to the start of the region
+            auto padding =
+                offset - static_cast<std::uint64_t>(file.tellp());
+            file.write(std::string(padding, '\0').data(), padding);
+            file.write(static_cast<const char*>(data), bytes);
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeRegion(header.keysOffset, keys.data(),
+                    keys.size() * sizeof(KeyComparable));
+        writeRegion(header.occupiedOffset, occupied.data(),
+                    occupied.size() * sizeof(std::uint64_t));
+        writeRegion(header.liveOffset, live.data(),
+                    live.size() * sizeof(std::uint64_t));
+        writeRegion(header.valuesOffset, items.data(),
+                    items.size() * sizeof(Item));
+
+        if (!file)
+        {
+            throw std::runtime_error("Unable to write file: " + path);
+        }
+    }
+
+    /*
+     * Maps a tree saved with saveTo() read-only into memory. It may be
+     * queried immediately, with values pointing into the mapping.
+     * Throws std::runtime_error if the file cannot be mapped.
+     */
+    [[nodiscard]] static MappedBinarySearchTree<
+        KeyComparable, std::remove_pointer_t<Value>>
+    openMapped(const std::string& path)
+    {
+        return MappedBinarySearchTree<KeyComparable,
+                                      std::remove_pointer_t<Value>>(path);
     }
 
     int getSize()
@@ -538,7 +1587,12 @@ class BinarySearchTree : BSTInterface<KeyComparable, Value>
             out << "[" << i << ": ";
             if (hasNodeAt(i))
             {
-                out << getKeyAt(i) << ", " << *getValueAt(i);
+                out << getKeyAt(i) << ", ";
+                Base::printValue(out, getValueAt(i));
+                if (this->storage.isTombstone(i))
+                {
+                    out << " (removed)";
+                }
             }
             out << "] ";
         }
@@ -0,0 +1,522 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: Policies which configure BinarySearchTree at compile time.
+//
+// Checking policies decide what happens when the tree reaches an invalid
+// index or an empty node:
+//   CheckedAccess:      throw an exception (default)
+//   DebugCheckedAccess: assert() in debug builds, nothing with NDEBUG
+//   UncheckedAccess:    nothing, for trusted production builds
+//
+// Growth policies decide what happens when an insertion falls past the
+// end of the array:
+//   ExactGrowth:       grow just enough to hold the new node (default)
+//   GeometricGrowth:   double the array until the new node fits
+//   RebalancingGrowth: rebuild the lowest enclosing subtree which is
+//                      sparse enough as a balanced tree, and only double
+//                      the array once the whole tree is a quarter full
+//
+// Storage policies decide how the nodes are held in the array:
+//   PairStorage:   an array of pointers to separately allocated pairs
+//                  (default)
+//   InlineStorage: parallel arrays of keys, values and node states, so a
+//                  search reads only the keys, with no pointer to follow
+///
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+/* ***
+ * *** CHECKING POLICIES
+ * ***/
+
+/*
+ * Throws std::out_of_range for invalid indices and std::invalid_argument
+ * for empty nodes. The messages are only built once a check has failed.
+ */
+struct CheckedAccess
+{
+    static void checkIndex(bool isValid, int index)
+    {
+        if (!isValid)
+        {
+            throwInvalidIndex(index);
+        }
+    }
+
+    static void checkNode(bool hasNode, int index)
+    {
+        if (!hasNode)
+        {
+            throwEmptyNode(index);
+        }
+    }
+
+  private:
+    [[noreturn]] static void throwInvalidIndex(int index)
+    {
+        // FAIL: Invalid index
+        throw std::out_of_range(std::string("Invalid index: ") +
+                                std::to_string(index));
+    }
+
+    [[noreturn]] static void throwEmptyNode(int index)
+    {
+        // FAIL: Empty node
+        throw std::invalid_argument(std::string("Node is empty, Index: ") +
+                                    std::to_string(index));
+    }
+};
+
+/*
+ * Asserts indices and nodes are valid in debug builds only.
+ */
+struct DebugCheckedAccess
+{
+    static void checkIndex(bool isValid, int /* index */) noexcept
+    {
+        assert(isValid && "Invalid index");
+        (void)isValid;
+    }
+
+    static void checkNode(bool hasNode, int /* index */) noexcept
+    {
+        assert(hasNode && "Node is empty");
+        (void)hasNode;
+    }
+};
+
+/*
+ * Does not check indices or nodes at all.
+ */
+struct UncheckedAccess
+{
+    static void checkIndex(bool /* isValid */, int /* index */) noexcept
+    {
+    }
+
+    static void checkNode(bool /* hasNode */, int /* index */) noexcept
+    {
+    }
+};
+
+
+/* ***
+ * *** GROWTH POLICIES
+ * ***/
+
+/*
+ * Grows the array just enough to hold the given index.
+ */
+struct ExactGrowth
+{
+    static constexpr bool REBALANCE = false;
+
+    [[nodiscard]] static int grownSize(int /* size */, int index) noexcept
+    {
+        return index + 1;
+    }
+};
+
+/*
+ * Doubles the array until it holds the given index.
+ */
+struct GeometricGrowth
+{
+    static constexpr bool REBALANCE = false;
+
+    [[nodiscard]] static int grownSize(int size, int index) noexcept
+    {
+        int newSize = size < 1 ? 1 : size;
+        while (newSize <= index)
+        {
+            newSize *= 2;
+        }
+        return newSize;
+    }
+};
+
+/*
+ * Rebuilds part of the tree to make room before doubling the array.
+ */
+struct RebalancingGrowth : GeometricGrowth
+{
+    static constexpr bool REBALANCE = true;
+};
+
+
+/* ***
+ * *** STORAGE POLICIES
+ * ***/
+
+/*
+ * Holds each node as a separately allocated (key, value) Pair, with the
+ * array holding a pointer to each. Moving a node only moves its pointer.
+ */
+template <typename KeyComparable, typename Value> class PairStorage
+{
+  private:
+    /*
+     * Private Node Class
+     */
+    class Pair
+    {
+      public:
+        KeyComparable key;
+        Value value;
+
+        // true if the node has been removed but is kept in place
+        bool isTombstone = false;
+
+        // Initialize class members from constructor arguments
+        // by using a member initializer list.
+        // This method uses direct initialization, which is more
+        // efficient than using assignment operators inside the
+        // constructor body.
+        template <typename... Args>
+        explicit Pair(KeyComparable key, Args&&... args)
+            : key{std::move(key)}, value(std::forward<Args>(args)...)
+        {
+        }
+    };
+
+    Pair** slots = nullptr;
+    int capacity = 0;
+
+  public:
+    // A node taken out of the array by take()
+    using Entry = std::unique_ptr<Pair>;
+
+    explicit PairStorage(int capacity)
+        : slots{new Pair*[capacity]()}, capacity{capacity}
+    {
+    }
+
+    PairStorage(const PairStorage&) = delete;
+    PairStorage& operator=(const PairStorage&) = delete;
+
+    PairStorage(PairStorage&& rhs) noexcept
+        : slots{std::exchange(rhs.slots, nullptr)},
+          capacity{std::exchange(rhs.capacity, 0)}
+    {
+    }
+
+    PairStorage& operator=(PairStorage&& rhs) noexcept
+    {
+        std::swap(this->slots, rhs.slots);
+        std::swap(this->capacity, rhs.capacity);
+        return *this;
+    }
+
+    ~PairStorage()
+    {
+        for (int i = 0; i < this->capacity; i++)
+        {
+            delete this->slots[i];
+        }
+        delete[] this->slots;
+    }
+
+    [[nodiscard]] int getCapacity() const noexcept
+    {
+        return this->capacity;
+    }
+
+    [[nodiscard]] bool isOccupied(int i) const noexcept
+    {
+        return this->slots[i] != nullptr;
+    }
+
+    [[nodiscard]] bool isTombstone(int i) const noexcept
+    {
+        return this->slots[i]->isTombstone;
+    }
+
+    void setTombstone(int i, bool isTombstone) noexcept
+    {
+        this->slots[i]->isTombstone = isTombstone;
+    }
+
+    [[nodiscard]] const KeyComparable& key(int i) const noexcept
+    {
+        return this->slots[i]->key;
+    }
+
+    [[nodiscard]] Value& value(int i) noexcept
+    {
+        return this->slots[i]->value;
+    }
+
+    [[nodiscard]] const Value& value(int i) const noexcept
+    {
+        return this->slots[i]->value;
+    }
+
+    /*
+     * Creates a node in the empty slot i, constructing the value from
+     * the given arguments.
+     */
+    template <typename... Args>
+    void emplace(int i, KeyComparable key, Args&&... args)
+    {
+        this->slots[i] =
+            new Pair(std::move(key), std::forward<Args>(args)...);
+    }
+
+    /*
+     * Destroys the node in slot i.
+     */
+    void erase(int i) noexcept
+    {
+        delete this->slots[i];
+        this->slots[i] = nullptr;
+    }
+
+    /*
+     * Moves the node in slot from into the empty slot to.
+     */
+    void move(int from, int to) noexcept
+    {
+        std::swap(this->slots[from], this->slots[to]);
+    }
+
+    /*
+     * Takes the node out of slot i, leaving it empty.
+     */
+    [[nodiscard]] Entry take(int i) noexcept
+    {
+        return Entry(std::exchange(this->slots[i], nullptr));
+    }
+
+    /*
+     * Puts a node taken with take() into the empty slot i.
+     */
+    void put(int i, Entry entry) noexcept
+    {
+        this->slots[i] = entry.release();
+    }
+
+    /*
+     * Changes the capacity, keeping the nodes in place. Any slots past
+     * the new capacity must be empty.
+     */
+    void resize(int newCapacity)
+    {
+        auto newSlots = new Pair*[newCapacity]();
+        std::copy(this->slots,
+                  this->slots + std::min(this->capacity, newCapacity),
+                  newSlots);
+
+        delete[] this->slots;
+        this->slots = newSlots;
+        this->capacity = newCapacity;
+    }
+};
+
+/*
+ * Holds the keys, values and node states in three parallel arrays, so
+ * nodes need no allocation of their own and a search touches only the
+ * key array. Keys and values are constructed in place when a node is
+ * created, so they need not be default constructible.
+ */
+template <typename KeyComparable, typename Value> class InlineStorage
+{
+  private:
+    enum State : unsigned char
+    {
+        EMPTY,
+        LIVE,
+        TOMBSTONE
+    };
+
+    KeyComparable* keys = nullptr;
+    Value* values = nullptr;
+    State* states = nullptr;
+    int capacity = 0;
+
+    /*
+     * Allocates uninitialized arrays for the given capacity.
+     */
+    void allocate(int newCapacity)
+    {
+        this->keys = std::allocator<KeyComparable>{}.allocate(newCapacity);
+        this->values = std::allocator<Value>{}.allocate(newCapacity);
+        this->states = new State[newCapacity]();
+        this->capacity = newCapacity;
+    }
+
+    /*
+     * Destroys every node and frees the arrays.
+     */
+    void release() noexcept
+    {
+        for (int i = 0; i < this->capacity; i++)
+        {
+            if (isOccupied(i))
+            {
+                erase(i);
+            }
+        }
+
+        std::allocator<KeyComparable>{}.deallocate(this->keys,
+                                                   this->capacity);
+        std::allocator<Value>{}.deallocate(this->values, this->capacity);
+        delete[] this->states;
+    }
+
+  public:
+    // A node taken out of the arrays by take()
+    struct Entry
+    {
+        KeyComparable key;
+        Value value;
+    };
+
+    explicit InlineStorage(int capacity)
+    {
+        allocate(capacity);
+    }
+
+    InlineStorage(const InlineStorage&) = delete;
+    InlineStorage& operator=(const InlineStorage&) = delete;
+
+    InlineStorage(InlineStorage&& rhs) noexcept
+        : keys{std::exchange(rhs.keys, nullptr)},
+          values{std::exchange(rhs.values, nullptr)},
+          states{std::exchange(rhs.states, nullptr)},
+          capacity{std::exchange(rhs.capacity, 0)}
+    {
+    }
+
+    InlineStorage& operator=(InlineStorage&& rhs) noexcept
+    {
+        std::swap(this->keys, rhs.keys);
+        std::swap(this->values, rhs.values);
+        std::swap(this->states, rhs.states);
+        std::swap(this->capacity, rhs.capacity);
+        return *this;
+    }
+
+    ~InlineStorage()
+    {
+        release();
+    }
+
+    [[nodiscard]] int getCapacity() const noexcept
+    {
+        return this->capacity;
+    }
+
+    [[nodiscard]] bool isOccupied(int i) const noexcept
+    {
+        return this->states[i] != EMPTY;
+    }
+
+    [[nodiscard]] bool isTombstone(int i) const noexcept
+    {
+        return this->states[i] == TOMBSTONE;
+    }
+
+    void setTombstone(int i, bool isTombstone) noexcept
+    {
+        this->states[i] = isTombstone ? TOMBSTONE : LIVE;
+    }
+
+    [[nodiscard]] const KeyComparable& key(int i) const noexcept
+    {
+        return this->keys[i];
+    }
+
+    [[nodiscard]] Value& value(int i) noexcept
+    {
+        return this->values[i];
+    }
+
+    [[nodiscard]] const Value& value(int i) const noexcept
+    {
+        return this->values[i];
+    }
+
+    /*
+     * Creates a node in the empty slot i, constructing the value from
+     * the given arguments.
+     */
+    template <typename... Args>
+    void emplace(int i, KeyComparable key, Args&&... args)
+    {
+        ::new (static_cast<void*>(this->values + i))
+            Value(std::forward<Args>(args)...);
+        ::new (static_cast<void*>(this->keys + i))
+            KeyComparable(std::move(key));
+        this->states[i] = LIVE;
+    }
+
+    /*
+     * Destroys the node in slot i.
+     */
+    void erase(int i) noexcept
+    {
+        std::destroy_at(this->keys + i);
+        std::destroy_at(this->values + i);
+        this->states[i] = EMPTY;
+    }
+
+    /*
+     * Moves the node in slot from into the empty slot to.
+     */
+    void move(int from, int to)
+    {
+        bool isTombstone = this->isTombstone(from);
+        emplace(to, std::move(this->keys[from]),
+                std::move(this->values[from]));
+        setTombstone(to, isTombstone);
+        erase(from);
+    }
+
+    /*
+     * Takes the node out of slot i, leaving it empty.
+     */
+    [[nodiscard]] Entry take(int i)
+    {
+        Entry entry{std::move(this->keys[i]), std::move(this->values[i])};
+        erase(i);
+        return entry;
+    }
+
+    /*
+     * Puts a node taken with take() into the empty slot i.
+     */
+    void put(int i, Entry entry)
+    {
+        emplace(i, std::move(entry.key), std::move(entry.value));
+    }
+
+    /*
+     * Changes the capacity, keeping the nodes in place. Any slots past
+     * the new capacity must be empty.
+     */
+    void resize(int newCapacity)
+    {
+        InlineStorage resized(newCapacity);
+        for (int i = 0; i < std::min(this->capacity, newCapacity); i++)
+        {
+            if (isOccupied(i))
+            {
+                resized.emplace(i, std::move(this->keys[i]),
+                                std::move(this->values[i]));
+                resized.setTombstone(i, isTombstone(i));
+            }
+        }
+        *this = std::move(resized);
+    }
+};
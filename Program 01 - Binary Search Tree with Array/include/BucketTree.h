@@ -0,0 +1,449 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: A search tree whose bottom levels are replaced by sorted
+// buckets of up to 64 keys.
+//
+// A binary tree of a million keys is twenty levels deep, and every level
+// is a dependent load. Here the keys are kept in small sorted buckets,
+// and the tree only holds one separator key per bucket, so it is about
+// five levels shallower and has 30-60 times fewer nodes. The tree is the
+// array tree with rebalancing growth, holding the buckets inline.
+//
+// A bucket is searched by counting its keys less than the search key
+// (see SimdSearch.h), which is a linear scan without branches: a few
+// vector instructions for int keys. A full bucket splits in half; a
+// bucket under a quarter full merges with its neighbor, or takes keys
+// from it if both together would not fit in one.
+///
+
+#pragma once
+
+#include "BSTInterface.h"
+#include "BSTree.h"
+#include "SimdSearch.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+template <typename KeyComparable, typename Value>
+class BucketTree : public BSTInterface<KeyComparable, Value>
+{
+    using Base = BSTInterface<KeyComparable, Value>;
+
+  public:
+    using typename Base::ValueHandle;
+
+    // the most keys a bucket holds
+    static constexpr int BUCKET_KEYS = 64;
+
+    // a bucket with fewer keys is merged with its neighbor
+    static constexpr int MIN_BUCKET_KEYS = BUCKET_KEYS / 4;
+
+  private:
+    /*
+     * Sorted keys, and their values in the same order. The slots past
+     * the last key hold copies of it, so the whole bucket may be scanned.
+     */
+    struct alignas(64) Bucket
+    {
+        std::array<KeyComparable, BUCKET_KEYS> keys{};
+        std::vector<Value> values;
+        int count = 0;
+
+        /*
+         * Returns the position of the first key which is not less than
+         * the given key, or count if there is none.
+         */
+        [[nodiscard]] int rankOf(const KeyComparable& key) const noexcept
+        {
+            return std::min(countLess<BUCKET_KEYS>(this->keys.data(), key),
+                            this->count);
+        }
+
+        [[nodiscard]] bool hasKeyAt(int rank,
+                                    const KeyComparable& key) const
+        {
+            return rank < this->count && !(key < this->keys[rank]);
+        }
+
+        /*
+         * Copies the last key into the slots past it.
+         */
+        void pad()
+        {
+            if (this->count > 0)
+            {
+                std::fill(this->keys.begin() + this->count,
+                          this->keys.end(), this->keys[this->count - 1]);
+            }
+        }
+
+        template <typename... Args>
+        void insertAt(int rank, KeyComparable key, Args&&... args)
+        {
+            std::move_backward(this->keys.begin() + rank,
+                               this->keys.begin() + this->count,
+                               this->keys.begin() + this->count + 1);
+            this->keys[rank] = std::move(key);
+            this->values.emplace(this->values.begin() + rank,
+                                 std::forward<Args>(args)...);
+            this->count++;
+            pad();
+        }
+
+        void eraseAt(int rank)
+        {
+            std::move(this->keys.begin() + rank + 1,
+                      this->keys.begin() + this->count,
+                      this->keys.begin() + rank);
+            this->values.erase(this->values.begin() + rank);
+            this->count--;
+            pad();
+        }
+
+        /*
+         * Moves the keys from the given rank on to the end of the next
+         * bucket, which must have room for them.
+         */
+        void moveTail(int rank, Bucket& next)
+        {
+            int moved = this->count - rank;
+            std::move_backward(next.keys.begin(),
+                               next.keys.begin() + next.count,
+                               next.keys.begin() + next.count + moved);
+            std::move(this->keys.begin() + rank,
+                      this->keys.begin() + this->count, next.keys.begin());
+            next.values.insert(
+                next.values.begin(),
+                std::make_move_iterator(this->values.begin() + rank),
+                std::make_move_iterator(this->values.end()));
+            next.count += moved;
+            next.pad();
+
+            this->values.erase(this->values.begin() + rank,
+                               this->values.end());
+            this->count = rank;
+            pad();
+        }
+
+        /*
+         * Moves the first keys of the next bucket, up to the given rank,
+         * to the end of this bucket, which must have room for them.
+         */
+        void takeHead(Bucket& next, int rank)
+        {
+            std::move(next.keys.begin(), next.keys.begin() + rank,
+                      this->keys.begin() + this->count);
+            this->values.insert(
+                this->values.end(),
+                std::make_move_iterator(next.values.begin()),
+                std::make_move_iterator(next.values.begin() + rank));
+            this->count += rank;
+            pad();
+
+            std::move(next.keys.begin() + rank,
+                      next.keys.begin() + next.count, next.keys.begin());
+            next.values.erase(next.values.begin(),
+                              next.values.begin() + rank);
+            next.count -= rank;
+            next.pad();
+        }
+    };
+
+    // Buckets by separator key. A bucket holds the keys from its
+    // separator up to the next bucket's. A separator is never greater
+    // than the keys of its bucket, so splitting a bucket never puts a
+    // separator out of order.
+    using Index = BinarySearchTree<KeyComparable, std::unique_ptr<Bucket>,
+                                   CheckedAccess, RebalancingGrowth,
+                                   InlineStorage>;
+    using IndexIterator = typename Index::Iterator;
+
+    Index index;
+
+    // number of keys in the tree
+    int count = 0;
+
+    /*
+     * Returns the bucket whose keys would include the given key, or the
+     * first bucket if the key is less than every separator. The index
+     * must not be empty.
+     */
+    [[nodiscard]] IndexIterator findBucket(const KeyComparable& key) const
+    {
+        auto it = this->index.upperBound(key);
+        if (it == this->index.begin())
+        {
+            return it; // RETURN: Before every separator
+        }
+        return --it;
+    }
+
+    /*
+     * Moves the first bucket to a smaller separator.
+     */
+    void lowerFirstSeparator(const KeyComparable& separator)
+    {
+        auto first = this->index.begin();
+        KeyComparable old = first.key();
+        auto moved = std::make_unique<Bucket>(std::move(**first));
+        this->index.remove(old);
+        this->index.emplace(separator, std::move(moved));
+    }
+
+    /*
+     * Splits a full bucket in half, adding the upper half to the index.
+     */
+    void split(Bucket& bucket)
+    {
+        auto upper = std::make_unique<Bucket>();
+        bucket.moveTail(BUCKET_KEYS / 2, *upper);
+
+        KeyComparable separator = upper->keys[0];
+        this->index.emplace(std::move(separator), std::move(upper));
+    }
+
+    /*
+     * Merges the bucket with a neighbor, or evens out their keys if both
+     * together would not fit in one bucket.
+     */
+    void merge(IndexIterator it)
+    {
+        // Pair the bucket with the next one, or the previous one if it is
+        // the last
+        auto next = it;
+        if (++next == this->index.end())
+        {
+            if (it == this->index.begin())
+            {
+                return; // RETURN: The only bucket
+            }
+            next = it;
+            --it;
+        }
+
+        Bucket& left = **it;
+        Bucket& right = **next;
+        KeyComparable separator = next.key();
+
+        if (left.count + right.count <= BUCKET_KEYS)
+        {
+            left.takeHead(right, right.count);
+            this->index.remove(separator);
+            return; // SUCCESS: Merged
+        }
+
+        // Move keys across until both are about half full, then move
+        // the right bucket to its new separator
+        int half = (left.count + right.count) / 2;
+        if (left.count < half)
+        {
+            left.takeHead(right, half - left.count);
+        }
+        else
+        {
+            left.moveTail(half, right);
+        }
+
+        auto moved = std::make_unique<Bucket>(std::move(right));
+        this->index.remove(separator);
+        KeyComparable newSeparator = moved->keys[0];
+        this->index.emplace(std::move(newSeparator), std::move(moved));
+    }
+
+    /*
+     * Inserts a key with the value constructed from the given arguments.
+     * Returns true if added, false if the key was already in the tree.
+     */
+    template <typename... Args>
+    bool insertKey(KeyComparable key, Args&&... args)
+    {
+        if (this->index.isEmpty())
+        {
+            this->index.emplace(key, std::make_unique<Bucket>());
+        }
+
+        auto it = findBucket(key);
+        Bucket* bucket = it->get();
+        int rank = bucket->rankOf(key);
+        if (bucket->hasKeyAt(rank, key))
+        {
+            return false; // FAIL: Key already exists
+        }
+
+        if (key < it.key())
+        {
+            // A new smallest key
+            lowerFirstSeparator(key);
+            it = findBucket(key);
+            bucket = it->get();
+        }
+
+        if (bucket->count == BUCKET_KEYS)
+        {
+            split(*bucket);
+            it = findBucket(key);
+            bucket = it->get();
+            rank = bucket->rankOf(key);
+        }
+
+        bucket->insertAt(rank, std::move(key),
+                         std::forward<Args>(args)...);
+        this->count++;
+        return true; // SUCCESS: Key added
+    }
+
+  public:
+    /*
+     * Finds the value with the smallest key in the tree
+     */
+    [[nodiscard]] ValueHandle findMin() const override
+    {
+        if (isEmpty())
+        {
+            return nullptr; // FAIL: No keys
+        }
+        return Base::toHandle((*this->index.begin())->values.front());
+    }
+
+    /*
+     * Finds the value with the largest key in the tree
+     */
+    [[nodiscard]] ValueHandle findMax() const override
+    {
+        if (isEmpty())
+        {
+            return nullptr; // FAIL: No keys
+        }
+        return Base::toHandle((*--this->index.end())->values.back());
+    }
+
+    /*
+     * Finds the node with the key
+     * returns a pointer to its value in the tree if found
+     * returns nullptr if not
+     */
+    [[nodiscard]] const Value*
+    find(const KeyComparable& key) const override
+    {
+        if (isEmpty())
+        {
+            return nullptr; // FAIL: No keys
+        }
+
+        const Bucket& bucket = **findBucket(key);
+        int rank = bucket.rankOf(key);
+        if (!bucket.hasKeyAt(rank, key))
+        {
+            return nullptr; // FAIL: key not found
+        }
+        return &bucket.values[rank];
+    }
+
+    // find(key, founditem) copies the value out
+    using Base::find;
+
+    /*
+     * Returns true if the key is found in the tree
+     */
+    [[nodiscard]] bool contains(const KeyComparable& key) const override
+    {
+        return find(key) != nullptr;
+    }
+
+    /*
+     * Returns true if tree has no keys
+     */
+    [[nodiscard]] bool isEmpty() const override
+    {
+        return this->count == 0;
+    }
+
+    /*
+     * Prints the values in order of keys to the stream out
+     */
+    void printTree(std::ostream& out = std::cout) const override
+    {
+        for (const auto& bucket : this->index)
+        {
+            for (const auto& value : bucket->values)
+            {
+                Base::printValue(out, value);
+                out << "\n";
+            }
+        }
+    }
+
+    /*
+     * Removes all keys from the tree.
+     */
+    void makeEmpty() override
+    {
+        this->index.makeEmpty();
+        this->count = 0;
+    }
+
+    /*
+     * Inserts a key and its value into the tree
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in tree)
+     */
+    bool insert(Value value, KeyComparable key) override
+    {
+        return insertKey(std::move(key), std::move(value));
+    }
+
+    /*
+     * Inserts a key into the tree, constructing its value in place from
+     * the given arguments. Returns true if added, false if the key was
+     * already in the tree.
+     */
+    template <typename... Args>
+    bool emplace(KeyComparable key, Args&&... args)
+    {
+        return insertKey(std::move(key), std::forward<Args>(args)...);
+    }
+
+    /*
+     * Removes the key from the tree, if it is there
+     */
+    void remove(const KeyComparable& key) override
+    {
+        if (isEmpty())
+        {
+            return; // RETURN: No keys
+        }
+
+        auto it = findBucket(key);
+        Bucket& bucket = **it;
+        int rank = bucket.rankOf(key);
+        if (!bucket.hasKeyAt(rank, key))
+        {
+            return; // RETURN: Key not found
+        }
+
+        bucket.eraseAt(rank);
+        this->count--;
+
+        if (bucket.count < MIN_BUCKET_KEYS)
+        {
+            merge(it);
+        }
+    }
+
+    [[nodiscard]] int getCount() const noexcept
+    {
+        return this->count;
+    }
+
+    [[nodiscard]] int getBucketCount()
+    {
+        return this->index.getCount();
+    }
+};
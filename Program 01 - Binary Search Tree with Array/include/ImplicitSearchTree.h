@@ -0,0 +1,337 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: A read-only, complete binary search tree stored in an
+// array in the order chosen by a layout (see TreeLayouts.h).
+//
+// The array tree stores node i at index i, which is the breadth-first
+// layout. Once the tree is deeper than about 10 levels, each step down
+// reads a new cache line, and eventually a new page. This tree holds the
+// same kind of implicit tree, but built once from sorted keys, so it is
+// complete and may be laid out in van Emde Boas order (the default),
+// where nodes near each other in the tree are near each other in memory
+// at every scale.
+//
+// The last level is filled out with copies of the largest key, which the
+// search never reports as found. Every search walks the full height, so
+// the node it ends at encodes its path, and the last node where it went
+// left holds the lower bound.
+///
+
+#pragma once
+
+#include "BSTInterface.h"
+#include "SortedIterator.h"
+#include "TreeLayouts.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template <typename KeyComparable, typename Value,
+          typename Layout = VanEmdeBoasLayout>
+class ImplicitSearchTree : public BSTInterface<KeyComparable, Value>
+{
+    using Base = BSTInterface<KeyComparable, Value>;
+
+  public:
+    using typename Base::ValueHandle;
+
+    // Iterates over the values in order of keys
+    using Iterator = SortedIterator<KeyComparable, Value>;
+
+  private:
+    // keys in layout order, filling a complete tree
+    std::vector<KeyComparable> nodes;
+
+    // keys and values in sorted order
+    std::vector<KeyComparable> keys;
+    std::vector<Value> values;
+
+    // number of levels in the tree
+    int height = 0;
+
+    Layout layout;
+
+    /*
+     * Returns the number of the node at the given position in sorted
+     * order.
+     */
+    [[nodiscard]] int getNodeAt(int rank) const noexcept
+    {
+        // In sorted order counting from 1, the node at depth d is an odd
+        // multiple of 2^(height - 1 - d). k is never 0, so it has a
+        // lowest set bit.
+        auto k = static_cast<unsigned>(rank + 1);
+        int zeros = __builtin_ctz(k);
+        int depth = this->height - 1 - zeros;
+        return static_cast<int>((1u << depth) + (k >> (zeros + 1)));
+    }
+
+    /*
+     * Returns the position in sorted order of node i.
+     */
+    [[nodiscard]] int getRankOf(int i) const noexcept
+    {
+        int depth = getDepth(i);
+        int offset = i - (1 << depth);
+        return ((2 * offset + 1) << (this->height - 1 - depth)) - 1;
+    }
+
+    /*
+     * Lays out the sorted keys as a complete tree.
+     * Throws std::length_error if there are too many keys.
+     */
+    void build()
+    {
+        int count = getCount();
+        this->height = 0;
+        while (this->height < MAX_TREE_HEIGHT &&
+               (1 << this->height) - 1 < count)
+        {
+            this->height++;
+        }
+        if ((1 << this->height) - 1 < count)
+        {
+            // FAIL: Too many keys
+            throw std::length_error("Too many keys for the tree");
+        }
+        this->layout = Layout(this->height);
+
+        // Fill out the last level with the largest key
+        auto slots = static_cast<std::size_t>((1 << this->height) - 1);
+        this->nodes.assign(slots, count ? this->keys.back()
+                                        : KeyComparable{});
+        for (int rank = 0; rank < count; rank++)
+        {
+            int position = this->layout.positionOf(getNodeAt(rank));
+            this->nodes[position] = this->keys[rank];
+        }
+    }
+
+    /*
+     * Returns the node holding the first key which is not less than the
+     * given key, if there is one.
+     */
+    [[nodiscard]] LayoutBound findNode(const KeyComparable& key) const
+    {
+        if (isEmpty())
+        {
+            return {}; // RETURN: No keys
+        }
+        return this->layout.descend(this->nodes.data(), key);
+    }
+
+    /*
+     * Returns the position in sorted order of the first key which is not
+     * less than the given key, or the number of keys if there is none.
+     */
+    [[nodiscard]] int findBound(const KeyComparable& key) const
+    {
+        LayoutBound bound = findNode(key);
+        if (bound.node == 0)
+        {
+            return getCount(); // RETURN: Every key is less
+        }
+
+        // A copy of the largest key is never found before the original
+        return std::min(getRankOf(bound.node), getCount());
+    }
+
+    /*
+     * Returns true if the node found for the key holds the key. Its key
+     * was read during the search, so this does not touch another line.
+     */
+    [[nodiscard]] bool isMatch(const LayoutBound& bound,
+                               const KeyComparable& key) const
+    {
+        return bound.node != 0 && !(key < this->nodes[bound.position]);
+    }
+
+    /*
+     * Returns an iterator to the key at the given position in sorted
+     * order.
+     */
+    [[nodiscard]] Iterator iteratorAt(int rank) const
+    {
+        return {this->keys.data(), this->values.data(), rank};
+    }
+
+    ImplicitSearchTree() = default;
+
+  public:
+    /*
+     * Builds a tree from the (key, value) pairs in the range [first,
+     * last), which must be sorted by key without duplicates.
+     * Throws std::invalid_argument if they are not.
+     */
+    template <typename InputIt>
+    [[nodiscard]] static ImplicitSearchTree fromSorted(InputIt first,
+                                                       InputIt last)
+    {
+        ImplicitSearchTree tree;
+        for (; first != last; ++first)
+        {
+            const auto& [key, value] = *first;
+            if (!tree.keys.empty() && !(tree.keys.back() < key))
+            {
+                // FAIL: Out of order
+                throw std::invalid_argument(
+                    "Keys must be sorted without duplicates");
+            }
+            tree.keys.push_back(key);
+            tree.values.push_back(value);
+        }
+
+        tree.build();
+        return tree;
+    }
+
+    /*
+     * Builds a tree holding a copy of every key and value of the given
+     * tree, such as a BinarySearchTree, which is walked in order.
+     */
+    template <typename Tree>
+    [[nodiscard]] static ImplicitSearchTree fromTree(const Tree& source)
+    {
+        ImplicitSearchTree tree;
+        for (auto it = source.begin(); it != source.end(); ++it)
+        {
+            tree.keys.push_back(it.key());
+            tree.values.push_back(*it);
+        }
+
+        tree.build();
+        return tree;
+    }
+
+    /*
+     * Finds the value with the smallest key in the tree
+     */
+    [[nodiscard]] ValueHandle findMin() const override
+    {
+        return isEmpty() ? nullptr : Base::toHandle(this->values.front());
+    }
+
+    /*
+     * Finds the value with the largest key in the tree
+     */
+    [[nodiscard]] ValueHandle findMax() const override
+    {
+        return isEmpty() ? nullptr : Base::toHandle(this->values.back());
+    }
+
+    /*
+     * Finds the node with the key
+     * returns a pointer to its value in the tree if found
+     * returns nullptr if not
+     */
+    [[nodiscard]] const Value*
+    find(const KeyComparable& key) const override
+    {
+        LayoutBound bound = findNode(key);
+        if (!isMatch(bound, key))
+        {
+            return nullptr; // FAIL: key not found
+        }
+        return &this->values[getRankOf(bound.node)];
+    }
+
+    // find(key, founditem) copies the value out
+    using Base::find;
+
+    /*
+     * Returns true if the key is found in the tree
+     */
+    [[nodiscard]] bool contains(const KeyComparable& key) const override
+    {
+        return isMatch(findNode(key), key);
+    }
+
+    /*
+     * Returns true if tree has no nodes
+     */
+    [[nodiscard]] bool isEmpty() const override
+    {
+        return this->keys.empty();
+    }
+
+    /*
+     * Prints the values in order of keys to the stream out
+     */
+    void printTree(std::ostream& out = std::cout) const override
+    {
+        for (const auto& value : this->values)
+        {
+            Base::printValue(out, value);
+            out << "\n";
+        }
+    }
+
+    /*
+     * Removes all keys from the tree.
+     */
+    void makeEmpty() override
+    {
+        this->keys.clear();
+        this->values.clear();
+        build();
+    }
+
+    /*
+     * The tree is read-only.
+     * Throws std::logic_error.
+     */
+    bool insert(Value /* item */, KeyComparable /* key */) override
+    {
+        throw std::logic_error("ImplicitSearchTree is read-only");
+    }
+
+    /*
+     * The tree is read-only.
+     * Throws std::logic_error.
+     */
+    void remove(const KeyComparable& /* key */) override
+    {
+        throw std::logic_error("ImplicitSearchTree is read-only");
+    }
+
+    /*
+     * Returns an iterator to the value with the smallest key
+     */
+    [[nodiscard]] Iterator begin() const
+    {
+        return iteratorAt(0);
+    }
+
+    /*
+     * Returns an iterator past the value with the largest key
+     */
+    [[nodiscard]] Iterator end() const
+    {
+        return iteratorAt(getCount());
+    }
+
+    /*
+     * Returns an iterator to the first value whose key is not less than
+     * the given key, or end() if there is none.
+     */
+    [[nodiscard]] Iterator lowerBound(const KeyComparable& key) const
+    {
+        return iteratorAt(findBound(key));
+    }
+
+    [[nodiscard]] int getCount() const noexcept
+    {
+        return static_cast<int>(this->keys.size());
+    }
+
+    [[nodiscard]] int getHeight() const noexcept
+    {
+        return this->height;
+    }
+};
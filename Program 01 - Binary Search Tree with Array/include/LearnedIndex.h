@@ -0,0 +1,361 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: A read-only index over sorted integer keys which predicts
+// the position of a key rather than comparing its way down a tree (a
+// learned index, in the style of the PGM-index).
+//
+// The sorted keys are split into segments, each with a line through its
+// first key which predicts the position of every key in the segment to
+// within epsilon places. A lookup picks the segment with a binary search
+// of the (few) segment starts, evaluates the line, and then searches
+// only the 2 * epsilon + 2 keys around the prediction.
+//
+// Dense, nearly sequential keys, like IDs, fit in a handful of segments;
+// the IDs 1-437 of csList.txt fit in one. Segments are found greedily: a
+// segment is extended while some slope through its first key keeps
+// every key so far within epsilon (the "shrinking cone").
+///
+
+#pragma once
+
+#include "BSTInterface.h"
+#include "SortedIterator.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename KeyComparable, typename Value>
+class LearnedIndex : public BSTInterface<KeyComparable, Value>
+{
+    static_assert(std::is_integral<KeyComparable>::value,
+                  "Expected an integer key");
+
+    using Base = BSTInterface<KeyComparable, Value>;
+
+  public:
+    using typename Base::ValueHandle;
+
+    // Iterates over the values in order of keys
+    using Iterator = SortedIterator<KeyComparable, Value>;
+
+    // largest error allowed in a predicted position, unless given
+    static constexpr int DEFAULT_EPSILON = 16;
+
+  private:
+    /*
+     * A line predicting the position of the keys from firstKey up to the
+     * first key of the next segment.
+     */
+    struct Segment
+    {
+        KeyComparable firstKey;
+        int firstRank;
+        double slope;
+    };
+
+    // keys and values in sorted order
+    std::vector<KeyComparable> keys;
+    std::vector<Value> values;
+
+    // segments in order of their first keys
+    std::vector<Segment> segments;
+
+    // the largest error allowed in a predicted position
+    int epsilon = DEFAULT_EPSILON;
+
+    explicit LearnedIndex(int epsilon) : epsilon{epsilon}
+    {
+        if (epsilon < 0)
+        {
+            // FAIL: Invalid error bound
+            throw std::invalid_argument("Epsilon must not be negative");
+        }
+    }
+
+    /*
+     * Returns the distance from one key to a larger key. The difference
+     * is taken as unsigned, so it cannot overflow.
+     */
+    [[nodiscard]] static double distance(KeyComparable from,
+                                         KeyComparable to) noexcept
+    {
+        using Unsigned = std::make_unsigned_t<KeyComparable>;
+        return static_cast<double>(static_cast<Unsigned>(
+            static_cast<Unsigned>(to) - static_cast<Unsigned>(from)));
+    }
+
+    /*
+     * Splits the sorted keys into as few segments as the greedy cone
+     * allows.
+     */
+    void fit()
+    {
+        this->segments.clear();
+
+        int count = getCount();
+        for (int start = 0; start < count;)
+        {
+            // The slopes which keep every key so far within epsilon
+            double lo = 0.0;
+            double hi = std::numeric_limits<double>::infinity();
+
+            int end = start + 1;
+            for (; end < count; end++)
+            {
+                double dx = distance(this->keys[start], this->keys[end]);
+                double dy = end - start;
+
+                // Stop once no slope fits this key as well
+                double keyLo = (dy - this->epsilon) / dx;
+                double keyHi = (dy + this->epsilon) / dx;
+                if (keyLo > hi || keyHi < lo)
+                {
+                    break;
+                }
+
+                lo = std::max(lo, keyLo);
+                hi = std::min(hi, keyHi);
+            }
+
+            double slope = (end - start > 1) ? (lo + hi) / 2 : 0.0;
+            this->segments.push_back({this->keys[start], start, slope});
+            start = end;
+        }
+    }
+
+    /*
+     * Returns the position in sorted order of the first key which is not
+     * less than the given key, or the number of keys if there is none.
+     */
+    [[nodiscard]] int findBound(const KeyComparable& key) const
+    {
+        if (isEmpty() || key < this->keys.front())
+        {
+            return 0; // RETURN: Before every key
+        }
+
+        // Find the last segment starting at or before the key
+        auto next = std::upper_bound(
+            this->segments.begin(), this->segments.end(), key,
+            [](const KeyComparable& k, const Segment& segment) {
+                return k < segment.firstKey;
+            });
+        const Segment& segment = *(next - 1);
+        int segmentEnd =
+            (next == this->segments.end()) ? getCount() : next->firstRank;
+
+        // Predict the position, which may be past the segment for keys
+        // between segments
+        double predicted =
+            segment.firstRank +
+            segment.slope * distance(segment.firstKey, key);
+        int position = static_cast<int>(
+            std::min(predicted, static_cast<double>(segmentEnd)));
+
+        // Search the window around the prediction. The extra place on
+        // each side covers rounding of the prediction.
+        int lo = std::max(segment.firstRank, position - this->epsilon - 1);
+        int hi = std::min(segmentEnd, position + this->epsilon + 1);
+        auto begin = this->keys.begin();
+        return static_cast<int>(
+            std::lower_bound(begin + lo, begin + hi, key) - begin);
+    }
+
+    /*
+     * Returns an iterator to the key at the given position in sorted
+     * order.
+     */
+    [[nodiscard]] Iterator iteratorAt(int rank) const
+    {
+        return {this->keys.data(), this->values.data(), rank};
+    }
+
+  public:
+    /*
+     * Builds an index from the (key, value) pairs in the range [first,
+     * last), which must be sorted by key without duplicates. Predicted
+     * positions are off by at most epsilon [default: 16].
+     * Throws std::invalid_argument if the keys are not sorted or
+     * epsilon is negative.
+     */
+    template <typename InputIt>
+    [[nodiscard]] static LearnedIndex
+    fromSorted(InputIt first, InputIt last, int epsilon = DEFAULT_EPSILON)
+    {
+        LearnedIndex index(epsilon);
+        for (; first != last; ++first)
+        {
+            const auto& [key, value] = *first;
+            if (!index.keys.empty() && !(index.keys.back() < key))
+            {
+                // FAIL: Out of order
+                throw std::invalid_argument(
+                    "Keys must be sorted without duplicates");
+            }
+            index.keys.push_back(key);
+            index.values.push_back(value);
+        }
+
+        index.fit();
+        return index;
+    }
+
+    /*
+     * Builds an index holding a copy of every key and value of the given
+     * tree, such as a BinarySearchTree, which is walked in order.
+     * Predicted positions are off by at most epsilon [default: 16].
+     * Throws std::invalid_argument if epsilon is negative.
+     */
+    template <typename Tree>
+    [[nodiscard]] static LearnedIndex
+    fromTree(const Tree& source, int epsilon = DEFAULT_EPSILON)
+    {
+        LearnedIndex index(epsilon);
+        for (auto it = source.begin(); it != source.end(); ++it)
+        {
+            index.keys.push_back(it.key());
+            index.values.push_back(*it);
+        }
+
+        index.fit();
+        return index;
+    }
+
+    /*
+     * Finds the value with the smallest key in the index
+     */
+    [[nodiscard]] ValueHandle findMin() const override
+    {
+        return isEmpty() ? nullptr : Base::toHandle(this->values.front());
+    }
+
+    /*
+     * Finds the value with the largest key in the index
+     */
+    [[nodiscard]] ValueHandle findMax() const override
+    {
+        return isEmpty() ? nullptr : Base::toHandle(this->values.back());
+    }
+
+    /*
+     * Finds the node with the key
+     * returns a pointer to its value in the index if found
+     * returns nullptr if not
+     */
+    [[nodiscard]] const Value*
+    find(const KeyComparable& key) const override
+    {
+        int rank = findBound(key);
+        if (rank == getCount() || key < this->keys[rank])
+        {
+            return nullptr; // FAIL: key not found
+        }
+        return &this->values[rank];
+    }
+
+    // find(key, founditem) copies the value out
+    using Base::find;
+
+    /*
+     * Returns true if the key is found in the index
+     */
+    [[nodiscard]] bool contains(const KeyComparable& key) const override
+    {
+        return find(key) != nullptr;
+    }
+
+    /*
+     * Returns true if index has no keys
+     */
+    [[nodiscard]] bool isEmpty() const override
+    {
+        return this->keys.empty();
+    }
+
+    /*
+     * Prints the values in order of keys to the stream out
+     */
+    void printTree(std::ostream& out = std::cout) const override
+    {
+        for (const auto& value : this->values)
+        {
+            Base::printValue(out, value);
+            out << "\n";
+        }
+    }
+
+    /*
+     * Removes all keys from the index.
+     */
+    void makeEmpty() override
+    {
+        this->keys.clear();
+        this->values.clear();
+        this->segments.clear();
+    }
+
+    /*
+     * The index is read-only.
+     * Throws std::logic_error.
+     */
+    bool insert(Value /* item */, KeyComparable /* key */) override
+    {
+        throw std::logic_error("LearnedIndex is read-only");
+    }
+
+    /*
+     * The index is read-only.
+     * Throws std::logic_error.
+     */
+    void remove(const KeyComparable& /* key */) override
+    {
+        throw std::logic_error("LearnedIndex is read-only");
+    }
+
+    /*
+     * Returns an iterator to the value with the smallest key
+     */
+    [[nodiscard]] Iterator begin() const
+    {
+        return iteratorAt(0);
+    }
+
+    /*
+     * Returns an iterator past the value with the largest key
+     */
+    [[nodiscard]] Iterator end() const
+    {
+        return iteratorAt(getCount());
+    }
+
+    /*
+     * Returns an iterator to the first value whose key is not less than
+     * the given key, or end() if there is none.
+     */
+    [[nodiscard]] Iterator lowerBound(const KeyComparable& key) const
+    {
+        return iteratorAt(findBound(key));
+    }
+
+    [[nodiscard]] int getCount() const noexcept
+    {
+        return static_cast<int>(this->keys.size());
+    }
+
+    [[nodiscard]] int getSegmentCount() const noexcept
+    {
+        return static_cast<int>(this->segments.size());
+    }
+
+    [[nodiscard]] int getEpsilon() const noexcept
+    {
+        return this->epsilon;
+    }
+};
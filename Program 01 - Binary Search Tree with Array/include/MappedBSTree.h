@@ -0,0 +1,369 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: A read-only Binary Search Tree backed by a memory-mapped
+// file written by BinarySearchTree::saveTo().
+//
+// The file stores the tree array exactly as it is laid out in memory, so
+// the tree can be queried as soon as it is mapped, without rebuilding it.
+// The file is made of a header followed by four regions, each aligned to
+// a 64-byte cache line:
+//
+//   keys:     one key for every slot of the array
+//   occupied: a bitmap with one bit set for every slot holding a node
+//   live:     a bitmap with one bit set for every node not removed
+//   values:   one item (a tree value, or the object it points to) for
+//             every slot
+//
+// Removed (tombstone) nodes are saved so that searches can pass through
+// them, but they are never found.
+//
+// Only trivially copyable keys and items can be stored this way. The
+// mapping uses POSIX mmap().
+///
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Header at the start of a saved tree file.
+ */
+struct BSTFileHeader
+{
+    static constexpr char MAGIC[8] = {'B', 'S', 'T', 'A',
+                                      'R', 'R', 'A', 'Y'};
+    static constexpr std::uint32_t VERSION = 2;
+    static constexpr std::uint64_t ALIGNMENT = 64;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t keySize;
+    std::uint32_t itemSize;
+    std::int32_t capacity;
+    std::int32_t count;
+    std::int32_t minIndex;
+    std::int32_t maxIndex;
+    std::uint64_t keysOffset;
+    std::uint64_t occupiedOffset;
+    std::uint64_t liveOffset;
+    std::uint64_t valuesOffset;
+    std::uint64_t fileSize;
+
+    /*
+     * Rounds the given offset up to the next region boundary.
+     */
+    [[nodiscard]] static std::uint64_t
+    align(std::uint64_t offset) noexcept
+    {
+        return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    /*
+     * Returns the number of 64-bit words in the occupancy bitmap for an
+     * array of the given capacity.
+     */
+    [[nodiscard]] static std::uint64_t bitmapWords(std::int32_t capacity)
+    {
+        return (static_cast<std::uint64_t>(capacity) + 63) / 64;
+    }
+
+    /*
+     * Returns a header describing a tree of the given capacity and count,
+     * with the region offsets filled in.
+     */
+    [[nodiscard]] static BSTFileHeader create(std::uint32_t keySize,
+                                              std::uint32_t itemSize,
+                                              std::int32_t capacity,
+                                              std::int32_t count)
+    {
+        BSTFileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.keySize = keySize;
+        header.itemSize = itemSize;
+        header.capacity = capacity;
+        header.count = count;
+
+        header.keysOffset = align(sizeof(BSTFileHeader));
+        header.occupiedOffset =
+            align(header.keysOffset + std::uint64_t{keySize} * capacity);
+        header.liveOffset =
+            align(header.occupiedOffset + bitmapWords(capacity) * 8);
+        header.valuesOffset =
+            align(header.liveOffset + bitmapWords(capacity) * 8);
+        header.fileSize =
+            header.valuesOffset + std::uint64_t{itemSize} * capacity;
+        return header;
+    }
+};
+
+
+template <typename KeyComparable, typename Item>
+class MappedBinarySearchTree
+{
+    static_assert(std::is_trivially_copyable<KeyComparable>::value,
+                  "Expected a trivially copyable key");
+    static_assert(std::is_trivially_copyable<Item>::value,
+                  "Expected a trivially copyable item");
+
+  private:
+    // the mapped file
+    void* mapping = nullptr;
+    std::size_t mappingSize = 0;
+
+    // capacity of the mapped array and number of values stored in it
+    int size = 0;
+    int count = 0;
+
+    // indices of the smallest and largest keys, 0 if empty
+    int minIndex = 0;
+    int maxIndex = 0;
+
+    // regions of the mapped file
+    const KeyComparable* keys = nullptr;
+    const std::uint64_t* occupied = nullptr;
+    const std::uint64_t* live = nullptr;
+    const Item* values = nullptr;
+
+    /*
+     * Returns the index of the left child of a given index.
+     */
+    [[nodiscard]] static int getLeft(int index) noexcept
+    {
+        return 2 * index;
+    }
+
+    /*
+     * Returns the index of the right child of a given index.
+     */
+    [[nodiscard]] static int getRight(int index) noexcept
+    {
+        return 2 * index + 1;
+    }
+
+    /*
+     * Returns true if the bit for the given index is set in the bitmap.
+     */
+    [[nodiscard]] static bool isSet(const std::uint64_t* bitmap,
+                                    int index) noexcept
+    {
+        return (bitmap[index / 64] >> (index % 64)) & 1U;
+    }
+
+    /*
+     * Returns true if there is a node at the given index, false
+     * otherwise.
+     */
+    [[nodiscard]] bool hasNodeAt(int index) const noexcept
+    {
+        return index >= 1 && index < this->size &&
+               isSet(this->occupied, index);
+    }
+
+    /*
+     * Search for the given key.
+     * Returns the index of the node or 0 if not found.
+     */
+    [[nodiscard]] int findIndex(const KeyComparable& key) const noexcept
+    {
+        int index = 1;
+        while (hasNodeAt(index))
+        {
+            const KeyComparable& currentKey = this->keys[index];
+            if (currentKey == key)
+            {
+                // Found the key, unless it was removed
+                return isSet(this->live, index) ? index : 0;
+            }
+            index =
+                (key < currentKey) ? getLeft(index) : getRight(index);
+        }
+        return 0; // FAIL: Not found.
+    }
+
+    /*
+     * Unmap the file, if mapped.
+     */
+    void unmap() noexcept
+    {
+        if (this->mapping)
+        {
+            munmap(this->mapping, this->mappingSize);
+            this->mapping = nullptr;
+        }
+    }
+
+  public:
+    /*
+     * CONSTRUCTOR
+     * Maps the tree saved in the file at the given path.
+     * Throws std::runtime_error if the file cannot be mapped or was not
+     * written by a matching BinarySearchTree.
+     */
+    explicit MappedBinarySearchTree(const std::string& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Unable to open file: " + path);
+        }
+
+        struct stat info
+        {
+        };
+        auto minSize = static_cast<off_t>(sizeof(BSTFileHeader));
+        if (fstat(fd, &info) != 0 || info.st_size < minSize)
+        {
+            close(fd);
+            throw std::runtime_error("Not a tree file: " + path);
+        }
+
+        this->mappingSize = info.st_size;
+        this->mapping = mmap(nullptr, this->mappingSize, PROT_READ,
+                             MAP_SHARED, fd, 0);
+        close(fd); // The mapping stays valid after closing
+
+        if (this->mapping == MAP_FAILED)
+        {
+            this->mapping = nullptr;
+            throw std::runtime_error("Unable to map file: " + path);
+        }
+
+        // Check the header matches this tree before trusting the regions
+        const auto* bytes = static_cast<const char*>(this->mapping);
+        BSTFileHeader header{};
+        std::memcpy(&header, bytes, sizeof(header));
+
+        auto expected =
+            BSTFileHeader::create(sizeof(KeyComparable), sizeof(Item),
+                                  header.capacity, header.count);
+        if (std::memcmp(header.magic, BSTFileHeader::MAGIC,
+                        sizeof(header.magic)) != 0 ||
+            header.version != BSTFileHeader::VERSION ||
+            header.keySize != expected.keySize ||
+            header.itemSize != expected.itemSize ||
+            header.capacity < 0 || header.minIndex < 0 ||
+            header.minIndex >= std::max(header.capacity, 1) ||
+            header.maxIndex < 0 ||
+            header.maxIndex >= std::max(header.capacity, 1) ||
+            header.fileSize != expected.fileSize ||
+            header.fileSize > this->mappingSize)
+        {
+            unmap();
+            throw std::runtime_error("Incompatible tree file: " + path);
+        }
+
+        this->size = header.capacity;
+        this->count = header.count;
+        this->minIndex = header.minIndex;
+        this->maxIndex = header.maxIndex;
+        this->keys = reinterpret_cast<const KeyComparable*>(
+            bytes + header.keysOffset);
+        this->occupied = reinterpret_cast<const std::uint64_t*>(
+            bytes + header.occupiedOffset);
+        this->live = reinterpret_cast<const std::uint64_t*>(
+            bytes + header.liveOffset);
+        this->values =
+            reinterpret_cast<const Item*>(bytes + header.valuesOffset);
+    }
+
+    // The mapping is owned by exactly one object
+    MappedBinarySearchTree(const MappedBinarySearchTree&) = delete;
+    MappedBinarySearchTree&
+    operator=(const MappedBinarySearchTree&) = delete;
+
+    MappedBinarySearchTree(MappedBinarySearchTree&& rhs) noexcept
+        : mapping{rhs.mapping}, mappingSize{rhs.mappingSize},
+          size{rhs.size}, count{rhs.count}, minIndex{rhs.minIndex},
+          maxIndex{rhs.maxIndex}, keys{rhs.keys}, occupied{rhs.occupied},
+          live{rhs.live}, values{rhs.values}
+    {
+        rhs.mapping = nullptr;
+    }
+
+    MappedBinarySearchTree& operator=(MappedBinarySearchTree&&) = delete;
+
+    /*
+     * DESTRUCTOR
+     */
+    ~MappedBinarySearchTree()
+    {
+        unmap();
+    }
+
+    /*
+     * Finds the item with the smallest key in the tree, or nullptr if
+     * the tree is empty
+     */
+    [[nodiscard]] const Item* findMin() const noexcept
+    {
+        return this->minIndex ? &this->values[this->minIndex] : nullptr;
+    }
+
+    /*
+     * Finds the item with the largest key in the tree, or nullptr if
+     * the tree is empty
+     */
+    [[nodiscard]] const Item* findMax() const noexcept
+    {
+        return this->maxIndex ? &this->values[this->maxIndex] : nullptr;
+    }
+
+    /*
+     * Finds the node with the key
+     * updates the founditem reference to point into the mapping if found
+     * returns true if it was found
+     * returns false if it was not
+     */
+    bool find(const KeyComparable& key,
+              /* out */ const Item*& founditem) const noexcept
+    {
+        int index = findIndex(key);
+        if (index < 1)
+        {
+            return false; // FAIL: key not found
+        }
+
+        founditem = &this->values[index];
+        return true; // SUCCESS
+    }
+
+    /*
+     * Returns true if the key is found in the tree
+     */
+    [[nodiscard]] bool contains(const KeyComparable& key) const noexcept
+    {
+        return findIndex(key) > 0;
+    }
+
+    /*
+     * Returns true if tree has no nodes
+     */
+    [[nodiscard]] bool isEmpty() const noexcept
+    {
+        return this->count == 0;
+    }
+
+    [[nodiscard]] int getSize() const noexcept
+    {
+        return this->size;
+    }
+
+    [[nodiscard]] int getCount() const noexcept
+    {
+        return this->count;
+    }
+};
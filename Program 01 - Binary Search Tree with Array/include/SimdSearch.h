@@ -0,0 +1,66 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: Counts the keys in a small sorted block which are less
+// than a search key, without branching on the comparisons.
+//
+// Since the block is sorted, the count is also the position of the first
+// key not less than the search key. For 32-bit int keys built with AVX2
+// (-mavx2, or the BST_USE_AVX2 CMake option), each 16 keys take two
+// vector compares and a movemask.
+///
+
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/*
+ * Returns the number of the first N keys of the block which are less
+ * than key. N must be a multiple of 16.
+ */
+template <int N, typename KeyComparable>
+[[nodiscard]] int countLess(const KeyComparable* keys,
+                            const KeyComparable& key) noexcept
+{
+    static_assert(N % 16 == 0, "Expected a multiple of 16 keys");
+
+#ifdef __AVX2__
+    if constexpr (std::is_same<KeyComparable, std::int32_t>::value)
+    {
+        const auto* vectors = reinterpret_cast<const __m256i*>(keys);
+        __m256i x = _mm256_set1_epi32(key);
+
+        int count = 0;
+        for (int i = 0; i < N / 8; i += 2)
+        {
+            // Set each lane holding a key less than x
+            __m256i lo =
+                _mm256_cmpgt_epi32(x, _mm256_loadu_si256(vectors + i));
+            __m256i hi =
+                _mm256_cmpgt_epi32(x, _mm256_loadu_si256(vectors + i + 1));
+
+            // Narrow the lanes to 16 bits, so each sets two mask bits.
+            // Only the count matters, so the order they pack in does not.
+            auto mask = static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_packs_epi32(lo, hi)));
+            count += static_cast<int>(std::bitset<32>(mask).count() / 2);
+        }
+        return count;
+    }
+#endif
+
+    int count = 0;
+    for (int i = 0; i < N; i++)
+    {
+        count += keys[i] < key;
+    }
+    return count;
+}
@@ -0,0 +1,95 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: An iterator over parallel arrays of keys and values in
+// sorted order, as kept by the read-only trees (StaticSearchTree and
+// LearnedIndex).
+///
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+/*
+ * Bidirectional iterator over keys and values in order of keys.
+ * Dereferencing yields the value; the key is available from key().
+ */
+template <typename KeyComparable, typename Value> class SortedIterator
+{
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Value*;
+    using reference = const Value&;
+
+  private:
+    const KeyComparable* keys = nullptr;
+    const Value* values = nullptr;
+
+    // position in sorted order, the number of keys for end()
+    int rank = 0;
+
+  public:
+    SortedIterator() = default;
+
+    SortedIterator(const KeyComparable* keys, const Value* values,
+                   int rank)
+        : keys{keys}, values{values}, rank{rank}
+    {
+    }
+
+    [[nodiscard]] const KeyComparable& key() const
+    {
+        return this->keys[this->rank];
+    }
+
+    reference operator*() const
+    {
+        return this->values[this->rank];
+    }
+
+    pointer operator->() const
+    {
+        return &**this;
+    }
+
+    SortedIterator& operator++()
+    {
+        this->rank++;
+        return *this;
+    }
+
+    SortedIterator operator++(int)
+    {
+        SortedIterator prev = *this;
+        ++*this;
+        return prev;
+    }
+
+    SortedIterator& operator--()
+    {
+        this->rank--;
+        return *this;
+    }
+
+    SortedIterator operator--(int)
+    {
+        SortedIterator prev = *this;
+        --*this;
+        return prev;
+    }
+
+    bool operator==(const SortedIterator& rhs) const
+    {
+        return this->keys == rhs.keys && this->rank == rhs.rank;
+    }
+
+    bool operator!=(const SortedIterator& rhs) const
+    {
+        return !(*this == rhs);
+    }
+};
@@ -0,0 +1,365 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: A read-only search tree which packs 16 keys into every
+// node (an S-tree, or static B-tree).
+//
+// A binary tree uses one key from each cache line it reads. Here every
+// node is 16 keys aligned to a 64-byte cache line, so a search reads
+// log17(n) lines instead of log2(n). Within a node, the number of keys
+// less than the search key is both the position of the candidate key and
+// the child to descend into, so no comparison needs a branch (see
+// SimdSearch.h).
+//
+// Like the array tree, the nodes are stored implicitly: node k has
+// children k * 17 + 1 through k * 17 + 17. The tree is built once, from a
+// sorted range or from a BinarySearchTree, and cannot be changed after.
+///
+
+#pragma once
+
+#include "BSTInterface.h"
+#include "SimdSearch.h"
+#include "SortedIterator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/*
+ * Allocates memory aligned to a 64-byte cache line.
+ */
+template <typename T> struct CacheAlignedAllocator
+{
+    using value_type = T;
+
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    CacheAlignedAllocator() = default;
+
+    template <typename U>
+    explicit CacheAlignedAllocator(
+        const CacheAlignedAllocator<U>& /* rhs */) noexcept
+    {
+    }
+
+    [[nodiscard]] T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(
+            ::operator new(n * sizeof(T), std::align_val_t{ALIGNMENT}));
+    }
+
+    void deallocate(T* p, std::size_t /* n */) noexcept
+    {
+        ::operator delete(p, std::align_val_t{ALIGNMENT});
+    }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U>& /* rhs */) const
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const CacheAlignedAllocator<U>& /* rhs */) const
+    {
+        return false;
+    }
+};
+
+
+template <typename KeyComparable, typename Value>
+class StaticSearchTree : public BSTInterface<KeyComparable, Value>
+{
+    using Base = BSTInterface<KeyComparable, Value>;
+
+  public:
+    using typename Base::ValueHandle;
+
+    // Iterates over the values in order of keys
+    using Iterator = SortedIterator<KeyComparable, Value>;
+
+    // number of keys in each node
+    static constexpr int NODE_KEYS = 16;
+
+  private:
+    // keys in tree order, NODE_KEYS per node, with one spare node so
+    // a search may read one past the last node
+    std::vector<KeyComparable, CacheAlignedAllocator<KeyComparable>>
+        nodes;
+
+    // the position in sorted order of each key in nodes
+    std::vector<int> ranks;
+
+    // keys and values in sorted order
+    std::vector<KeyComparable> keys;
+    std::vector<Value> values;
+
+    // number of nodes in the tree
+    int nodeCount = 0;
+
+    /*
+     * Returns the index of the i-th child of node k.
+     */
+    [[nodiscard]] static int getChild(int k, int i) noexcept
+    {
+        return k * (NODE_KEYS + 1) + i + 1;
+    }
+
+    /*
+     * Returns the number of keys in the node which are less than key.
+     * Since the keys in a node are sorted, this is also the position of
+     * the first key which is not less than key.
+     */
+    [[nodiscard]] static int rankInNode(const KeyComparable* node,
+                                        const KeyComparable& key) noexcept
+    {
+        return countLess<NODE_KEYS>(node, key);
+    }
+
+    /*
+     * Fills the subtree at node k with keys in order, from position
+     * next in the sorted keys. Slots past the last key are filled with
+     * copies of the largest key, ranked past the end.
+     */
+    void build(int k, int& next)
+    {
+        if (k >= this->nodeCount)
+        {
+            return; // RETURN: No node here
+        }
+
+        int count = static_cast<int>(this->keys.size());
+        for (int i = 0; i < NODE_KEYS; i++)
+        {
+            build(getChild(k, i), next);
+
+            int slot = k * NODE_KEYS + i;
+            this->nodes[slot] = this->keys[std::min(next, count - 1)];
+            this->ranks[slot] = std::min(next, count);
+            next++;
+        }
+        build(getChild(k, NODE_KEYS), next);
+    }
+
+    /*
+     * Lays out the sorted keys as the tree.
+     */
+    void layout()
+    {
+        int count = static_cast<int>(this->keys.size());
+        this->nodeCount = (count + NODE_KEYS - 1) / NODE_KEYS;
+
+        auto slots = static_cast<std::size_t>(this->nodeCount + 1) *
+                     NODE_KEYS;
+        this->nodes.assign(slots, count ? this->keys.back()
+                                        : KeyComparable{});
+        this->ranks.assign(slots, count);
+
+        int next = 0;
+        build(0, next);
+    }
+
+    /*
+     * Returns the position in sorted order of the first key which is not
+     * less than the given key, or the number of keys if there is none.
+     */
+    [[nodiscard]] int findBound(const KeyComparable& key) const noexcept
+    {
+        int found = static_cast<int>(this->keys.size());
+        for (int k = 0; k < this->nodeCount;)
+        {
+            int i = rankInNode(&this->nodes[k * NODE_KEYS], key);
+
+            // When every key in the node is less, i reads the first rank
+            // of the next node, which must not be used
+            int candidate = this->ranks[k * NODE_KEYS + i];
+            found = (i < NODE_KEYS) ? candidate : found;
+            k = getChild(k, i);
+        }
+        return found;
+    }
+
+    StaticSearchTree() = default;
+
+    /*
+     * Returns an iterator to the key at the given position in sorted
+     * order.
+     */
+    [[nodiscard]] Iterator iteratorAt(int rank) const
+    {
+        return {this->keys.data(), this->values.data(), rank};
+    }
+
+  public:
+    /*
+     * Builds a tree from the (key, value) pairs in the range [first,
+     * last), which must be sorted by key without duplicates.
+     * Throws std::invalid_argument if they are not.
+     */
+    template <typename InputIt>
+    [[nodiscard]] static StaticSearchTree fromSorted(InputIt first,
+                                                     InputIt last)
+    {
+        StaticSearchTree tree;
+        for (; first != last; ++first)
+        {
+            const auto& [key, value] = *first;
+            if (!tree.keys.empty() && !(tree.keys.back() < key))
+            {
+                // FAIL: Out of order
+                throw std::invalid_argument(
+                    "Keys must be sorted without duplicates");
+            }
+            tree.keys.push_back(key);
+            tree.values.push_back(value);
+        }
+
+        tree.layout();
+        return tree;
+    }
+
+    /*
+     * Builds a tree holding a copy of every key and value of the given
+     * tree, such as a BinarySearchTree, which is walked in order.
+     */
+    template <typename Tree>
+    [[nodiscard]] static StaticSearchTree fromTree(const Tree& source)
+    {
+        StaticSearchTree tree;
+        for (auto it = source.begin(); it != source.end(); ++it)
+        {
+            tree.keys.push_back(it.key());
+            tree.values.push_back(*it);
+        }
+
+        tree.layout();
+        return tree;
+    }
+
+    /*
+     * Finds the value with the smallest key in the tree
+     */
+    [[nodiscard]] ValueHandle findMin() const override
+    {
+        return isEmpty() ? nullptr : Base::toHandle(this->values.front());
+    }
+
+    /*
+     * Finds the value with the largest key in the tree
+     */
+    [[nodiscard]] ValueHandle findMax() const override
+    {
+        return isEmpty() ? nullptr : Base::toHandle(this->values.back());
+    }
+
+    /*
+     * Finds the node with the key
+     * returns a pointer to its value in the tree if found
+     * returns nullptr if not
+     */
+    [[nodiscard]] const Value*
+    find(const KeyComparable& key) const override
+    {
+        int rank = findBound(key);
+        if (rank == getCount() || key < this->keys[rank])
+        {
+            return nullptr; // FAIL: key not found
+        }
+        return &this->values[rank];
+    }
+
+    // find(key, founditem) copies the value out
+    using Base::find;
+
+    /*
+     * Returns true if the key is found in the tree
+     */
+    [[nodiscard]] bool contains(const KeyComparable& key) const override
+    {
+        return find(key) != nullptr;
+    }
+
+    /*
+     * Returns true if tree has no nodes
+     */
+    [[nodiscard]] bool isEmpty() const override
+    {
+        return this->keys.empty();
+    }
+
+    /*
+     * Prints the values in order of keys to the stream out
+     */
+    void printTree(std::ostream& out = std::cout) const override
+    {
+        for (const auto& value : this->values)
+        {
+            Base::printValue(out, value);
+            out << "\n";
+        }
+    }
+
+    /*
+     * Removes all keys from the tree.
+     */
+    void makeEmpty() override
+    {
+        this->keys.clear();
+        this->values.clear();
+        layout();
+    }
+
+    /*
+     * The tree is read-only.
+     * Throws std::logic_error.
+     */
+    bool insert(Value /* item */, KeyComparable /* key */) override
+    {
+        throw std::logic_error("StaticSearchTree is read-only");
+    }
+
+    /*
+     * The tree is read-only.
+     * Throws std::logic_error.
+     */
+    void remove(const KeyComparable& /* key */) override
+    {
+        throw std::logic_error("StaticSearchTree is read-only");
+    }
+
+    /*
+     * Returns an iterator to the value with the smallest key
+     */
+    [[nodiscard]] Iterator begin() const
+    {
+        return iteratorAt(0);
+    }
+
+    /*
+     * Returns an iterator past the value with the largest key
+     */
+    [[nodiscard]] Iterator end() const
+    {
+        return iteratorAt(getCount());
+    }
+
+    /*
+     * Returns an iterator to the first value whose key is not less than
+     * the given key, or end() if there is none.
+     */
+    [[nodiscard]] Iterator lowerBound(const KeyComparable& key) const
+    {
+        return iteratorAt(findBound(key));
+    }
+
+    [[nodiscard]] int getCount() const noexcept
+    {
+        return static_cast<int>(this->keys.size());
+    }
+};
@@ -0,0 +1,221 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: Layouts which place the nodes of a complete binary tree in
+// an array, for ImplicitSearchTree.
+//
+// Nodes are numbered as in the array tree: the root is 1 and the
+// children of node i are 2i and 2i + 1. A layout maps each number to a
+// position in the array, and searches down the tree for a key.
+//
+//   EytzingerLayout:   positions in breadth-first order, like the array
+//                      tree. The path down is easy to predict, so the
+//                      nodes four levels ahead are prefetched, but every
+//                      level past the first few reads a new cache line
+//                      and, deep enough, a new page.
+//   VanEmdeBoasLayout: positions in van Emde Boas order. The tree is cut
+//                      at half its height into a top tree and the bottom
+//                      trees hanging from it, each laid out the same way
+//                      in its own contiguous block, recursively. A search
+//                      reads O(log_B n) blocks for every block size B at
+//                      once (cache lines, pages, ...), without knowing B.
+///
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+// the tallest tree whose node numbers fit in an int
+constexpr int MAX_TREE_HEIGHT = 30;
+
+/*
+ * The last node a search did not go right past, which holds the first
+ * key not less than the search key: its number and its position in the
+ * array, or 0 and -1 if the search went right at every node.
+ */
+struct LayoutBound
+{
+    int node = 0;
+    int position = -1;
+};
+
+/*
+ * Returns the node of the given number on the path to the (missing)
+ * node i, below the last level, where the path last went left, or 0.
+ */
+[[nodiscard]] inline int getLastLeftTurn(int i) noexcept
+{
+    // Drop the right turns at the end of the path, then the left turn
+    while (i & 1)
+    {
+        i >>= 1;
+    }
+    return i >> 1;
+}
+
+/*
+ * Returns the depth of node i, counting the root as depth 0.
+ */
+[[nodiscard]] inline int getDepth(int i) noexcept
+{
+    int depth = 0;
+    while (i >>= 1)
+    {
+        depth++;
+    }
+    return depth;
+}
+
+/*
+ * Breadth-first layout: node i is at position i - 1.
+ */
+class EytzingerLayout
+{
+  private:
+    // number of levels in the tree
+    int height = 0;
+
+    // number of positions in the array
+    std::size_t slots = 0;
+
+  public:
+    explicit EytzingerLayout(int height = 0)
+        : height{height}, slots{(std::size_t{1} << height) - 1}
+    {
+    }
+
+    [[nodiscard]] int positionOf(int i) const noexcept
+    {
+        return i - 1;
+    }
+
+    /*
+     * Walks from the root to below the last level, going right past any
+     * node whose key is less than the given key.
+     */
+    template <typename Key>
+    [[nodiscard]] LayoutBound descend(const Key* nodes,
+                                      const Key& key) const
+    {
+        int i = 1;
+        for (int depth = 0; depth < this->height; depth++)
+        {
+#if defined(__GNUC__)
+            // The 16 descendants four levels down are adjacent
+            __builtin_prefetch(
+                nodes + std::min(std::size_t{16} * i, this->slots - 1));
+#endif
+            i = 2 * i + (nodes[i - 1] < key);
+        }
+
+        // The (missing) node reached encodes every turn taken
+        int node = getLastLeftTurn(i);
+        return {node, node - 1};
+    }
+};
+
+/*
+ * Van Emde Boas layout, navigated in O(1) per level with tables computed
+ * once for the height of the tree (Brodal, Fagerberg and Jacob, "Cache
+ * Oblivious Search Trees via Binary Trees of Small Height").
+ */
+class VanEmdeBoasLayout
+{
+  private:
+    static constexpr int MAX_HEIGHT = MAX_TREE_HEIGHT;
+
+    // number of levels in the tree
+    int height = 0;
+
+    // Each depth d > 0 is where one recursive cut falls. For that cut:
+    //   bottomSize[d]: the number of nodes in each bottom tree
+    //   topSize[d]:    the number of nodes in the top tree
+    //   topDepth[d]:   the depth of the root of the top tree
+    std::array<int, MAX_HEIGHT + 1> bottomSize{};
+    std::array<int, MAX_HEIGHT + 1> topSize{};
+    std::array<int, MAX_HEIGHT + 1> topDepth{};
+
+    /*
+     * Fills the tables for the subtree with the given number of levels
+     * whose root is at the given depth.
+     */
+    void cut(int depth, int levels) noexcept
+    {
+        if (levels <= 1)
+        {
+            return; // RETURN: A single node
+        }
+
+        int top = levels / 2;
+        int bottom = levels - top;
+        int boundary = depth + top;
+
+        this->bottomSize[boundary] = (1 << bottom) - 1;
+        this->topSize[boundary] = (1 << top) - 1;
+        this->topDepth[boundary] = depth;
+
+        cut(depth, top);
+        cut(boundary, bottom);
+    }
+
+    /*
+     * Returns the position of the node at the given depth, whose
+     * ancestors are at the given positions. Its number i only matters
+     * through its lowest bits, which tell which bottom tree it roots.
+     */
+    [[nodiscard]] int step(const int* path, int depth, int i) const
+        noexcept
+    {
+        // Skip the top tree, then the bottom trees to the left
+        return path[this->topDepth[depth]] + this->topSize[depth] +
+               (i & this->topSize[depth]) * this->bottomSize[depth];
+    }
+
+  public:
+    explicit VanEmdeBoasLayout(int height = 0) : height{height}
+    {
+        cut(0, height);
+    }
+
+    [[nodiscard]] int positionOf(int i) const noexcept
+    {
+        int depth = getDepth(i);
+
+        std::array<int, MAX_HEIGHT + 1> path{};
+        for (int d = 1; d <= depth; d++)
+        {
+            path[d] = step(path.data(), d, i >> (depth - d));
+        }
+        return path[depth];
+    }
+
+    /*
+     * Walks from the root to below the last level, going right past any
+     * node whose key is less than the given key.
+     */
+    template <typename Key>
+    [[nodiscard]] LayoutBound descend(const Key* nodes,
+                                      const Key& key) const
+    {
+        // positions of the nodes on the path, by depth
+        std::array<int, MAX_HEIGHT + 1> path;
+        path[0] = 0;
+
+        int i = 1;
+        int found = -1;
+        for (int depth = 0; depth < this->height; depth++)
+        {
+            int position = path[depth];
+            bool right = nodes[position] < key;
+            found = right ? found : position;
+
+            i = 2 * i + right;
+            path[depth + 1] = step(path.data(), depth + 1, i);
+        }
+        return {getLastLeftTurn(i), found};
+    }
+};
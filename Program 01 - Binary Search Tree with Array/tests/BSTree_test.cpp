@@ -9,9 +9,12 @@
 #include <BSTree.h>
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <memory>
 #include <numeric>
 #include <random>
+#include <set>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -300,3 +303,850 @@ SCENARIO("BSTree: Delete a key")
         }
     }
 }
+
+
+SCENARIO("BSTree: Iterate over a tree in order")
+{
+    GIVEN("A tree with values 1-30")
+    {
+        const int numValues = 30;
+        auto tree = generateTree(numValues);
+
+        THEN("Iterating forward visits every key in ascending order")
+        {
+            std::vector<int> keys;
+            for (auto it = tree.begin(); it != tree.end(); ++it)
+            {
+                REQUIRE(std::to_string(it.key()) == **it);
+                keys.push_back(it.key());
+            }
+
+            std::vector<int> expected(numValues);
+            std::iota(expected.begin(), expected.end(), 1);
+            REQUIRE(keys == expected);
+        }
+
+        THEN("Iterating backward from the end visits every key in "
+             "descending order")
+        {
+            std::vector<int> keys;
+            auto it = tree.end();
+            while (it != tree.begin())
+            {
+                --it;
+                keys.push_back(it.key());
+            }
+
+            std::vector<int> expected(numValues);
+            std::iota(expected.rbegin(), expected.rend(), 1);
+            REQUIRE(keys == expected);
+        }
+    }
+
+    GIVEN("An empty tree")
+    {
+        NumTree tree;
+
+        THEN("begin() is end()")
+        {
+            REQUIRE(tree.begin() == tree.end());
+        }
+    }
+}
+
+
+SCENARIO("BSTree: Find bounds and scan ranges")
+{
+    GIVEN("A tree with the even values 2-40")
+    {
+        NumTree tree;
+        std::vector<int> nums;
+        for (int n = 2; n <= 40; n += 2)
+        {
+            nums.push_back(n);
+        }
+        std::shuffle(nums.begin(), nums.end(),
+                     std::mt19937{std::random_device{}()});
+        for (auto& [n, str] : generatePairs(nums))
+        {
+            tree.insert(str, n);
+        }
+
+        THEN("The lower bound of an existing key is that key")
+        {
+            REQUIRE(10 == tree.lowerBound(10).key());
+        }
+
+        THEN("The lower bound of a missing key is the next key")
+        {
+            REQUIRE(12 == tree.lowerBound(11).key());
+        }
+
+        THEN("The upper bound of an existing key is the next key")
+        {
+            REQUIRE(12 == tree.upperBound(10).key());
+        }
+
+        THEN("There are no bounds past the largest key")
+        {
+            REQUIRE(tree.end() == tree.lowerBound(41));
+            REQUIRE(tree.end() == tree.upperBound(40));
+        }
+
+        THEN("Scanning [11, 20] visits 12, 14, 16, 18, 20")
+        {
+            std::vector<int> keys;
+            int visited = tree.rangeScan(
+                11, 20, [&](const int& key, std::string* const& value) {
+                    REQUIRE(std::to_string(key) == *value);
+                    keys.push_back(key);
+                });
+
+            REQUIRE(5 == visited);
+            REQUIRE(keys == std::vector<int>{12, 14, 16, 18, 20});
+        }
+
+        THEN("Scanning an empty range visits nothing")
+        {
+            REQUIRE(0 == tree.rangeScan(41, 50, [](auto&, auto&) {}));
+        }
+    }
+}
+
+
+SCENARIO("BSTree: Rank, select and count ranges")
+{
+    GIVEN("A tree tracking subtree sizes with values 1-50")
+    {
+        const int numValues = 50;
+        NumTree tree(/* trackSizes */ true);
+        for (auto& [n, str] : generatePairs(generateNums(numValues)))
+        {
+            tree.insert(str, n);
+        }
+
+        THEN("Order statistics are available")
+        {
+            REQUIRE(tree.hasOrderStatistics());
+        }
+
+        THEN("The rank of each key is the number of smaller keys")
+        {
+            for (int n = 1; n <= numValues; n++)
+            {
+                REQUIRE(n - 1 == tree.rank(n));
+            }
+            REQUIRE(0 == tree.rank(0));
+            REQUIRE(numValues == tree.rank(numValues + 1));
+        }
+
+        THEN("Selecting the k-th key finds k + 1")
+        {
+            for (int k = 0; k < numValues; k++)
+            {
+                REQUIRE(k + 1 == tree.select(k).key());
+            }
+            REQUIRE(tree.end() == tree.select(numValues));
+            REQUIRE(tree.end() == tree.select(-1));
+        }
+
+        THEN("The range [10, 19] holds 10 keys")
+        {
+            REQUIRE(10 == tree.countRange(10, 19));
+            REQUIRE(0 == tree.countRange(19, 10));
+        }
+
+        WHEN("The keys 11-20 are removed")
+        {
+            for (int n = 11; n <= 20; n++)
+            {
+                tree.remove(n);
+            }
+
+            THEN("Ranks and selections skip the removed keys")
+            {
+                REQUIRE(10 == tree.rank(21));
+                REQUIRE(21 == tree.select(10).key());
+                REQUIRE(numValues == tree.select(39).key());
+            }
+
+            THEN("The range [10, 30] holds 11 keys")
+            {
+                REQUIRE(11 == tree.countRange(10, 30));
+            }
+        }
+
+        WHEN("The tree is emptied and refilled with 1-5")
+        {
+            tree.makeEmpty();
+            for (auto& [n, str] : generatePairs(generateNums(5)))
+            {
+                tree.insert(str, n);
+            }
+
+            THEN("Order statistics are still tracked")
+            {
+                REQUIRE(5 == tree.countRange(0, 100));
+                REQUIRE(3 == tree.select(2).key());
+            }
+        }
+    }
+
+    GIVEN("A tree which does not track subtree sizes")
+    {
+        auto tree = generateTree(5);
+
+        THEN("Order statistic queries throw")
+        {
+            REQUIRE_FALSE(tree.hasOrderStatistics());
+            REQUIRE_THROWS_AS(tree.rank(1), std::logic_error);
+        }
+    }
+}
+
+
+SCENARIO("BSTree: Save a tree and map it back into memory")
+{
+    using IntTree = BinarySearchTree<int, int*>;
+
+    GIVEN("A tree with integer values 1-30 saved to a file")
+    {
+        const int numValues = 30;
+        const std::string path = "BSTree_test_mapped.bin";
+
+        IntTree tree;
+        std::vector<std::unique_ptr<int>> values;
+        for (int n : generateNums(numValues))
+        {
+            values.emplace_back(std::make_unique<int>(n * 10));
+            tree.insert(values.back().get(), n);
+        }
+        tree.saveTo(path);
+
+        WHEN("The file is mapped")
+        {
+            auto mapped = IntTree::openMapped(path);
+
+            THEN("It has the same shape as the tree")
+            {
+                REQUIRE(tree.getCount() == mapped.getCount());
+                REQUIRE(tree.getSize() == mapped.getSize());
+            }
+
+            THEN("Every key is found with its value")
+            {
+                for (int n = 1; n <= numValues; n++)
+                {
+                    const int* found = nullptr;
+                    REQUIRE(mapped.find(n, found));
+                    REQUIRE(n * 10 == *found);
+                }
+            }
+
+            THEN("Missing keys are not found")
+            {
+                REQUIRE_FALSE(mapped.contains(0));
+                REQUIRE_FALSE(mapped.contains(numValues + 1));
+            }
+
+            THEN("The minimum and maximum values are found")
+            {
+                REQUIRE(10 == *mapped.findMin());
+                REQUIRE(numValues * 10 == *mapped.findMax());
+            }
+        }
+
+        std::remove(path.c_str());
+    }
+
+    GIVEN("A tree in tombstone mode with key 1 removed, saved to a file")
+    {
+        const std::string path = "BSTree_test_tombstones.bin";
+
+        IntTree tree;
+        tree.setDeletionMode(DeletionMode::Tombstone);
+        std::vector<std::unique_ptr<int>> values;
+        for (int n : {5, 1, 8, 3})
+        {
+            values.emplace_back(std::make_unique<int>(n * 10));
+            tree.insert(values.back().get(), n);
+        }
+        tree.remove(1);
+        tree.saveTo(path);
+
+        WHEN("The file is mapped")
+        {
+            auto mapped = IntTree::openMapped(path);
+
+            THEN("The removed key is not found, but the others are")
+            {
+                REQUIRE_FALSE(mapped.contains(1));
+                REQUIRE(mapped.contains(3));
+                REQUIRE(30 == *mapped.findMin());
+            }
+        }
+
+        std::remove(path.c_str());
+    }
+
+    GIVEN("A file which does not hold a tree")
+    {
+        const std::string path = "BSTree_test_invalid.bin";
+        std::ofstream(path) << "Not a tree, but long enough to hold a "
+                               "header of a saved tree file.........";
+
+        THEN("Mapping it throws")
+        {
+            REQUIRE_THROWS_AS(IntTree::openMapped(path),
+                              std::runtime_error);
+        }
+
+        std::remove(path.c_str());
+    }
+}
+
+
+SCENARIO("BSTree: Remove keys by leaving tombstones")
+{
+    GIVEN("A tree in tombstone mode tracking sizes with values 1-20")
+    {
+        const int numValues = 20;
+        NumTree tree(/* trackSizes */ true);
+        tree.setDeletionMode(DeletionMode::Tombstone);
+        for (auto& [n, str] : generatePairs(generateNums(numValues)))
+        {
+            tree.insert(str, n);
+        }
+        int size = tree.getSize();
+
+        WHEN("The keys 1 and 11-15 are removed")
+        {
+            tree.remove(1);
+            for (int n = 11; n <= 15; n++)
+            {
+                tree.remove(n);
+            }
+
+            THEN("The removed keys are kept as tombstones")
+            {
+                REQUIRE(numValues - 6 == tree.getCount());
+                REQUIRE(6 == tree.getTombstoneCount());
+                REQUIRE(size == tree.getSize());
+            }
+
+            THEN("The removed keys are not found")
+            {
+                REQUIRE_FALSE(tree.contains(1));
+                REQUIRE_FALSE(tree.contains(13));
+                REQUIRE(tree.contains(16));
+            }
+
+            THEN("Iteration, bounds and statistics skip the removed keys")
+            {
+                std::vector<int> keys;
+                for (auto it = tree.begin(); it != tree.end(); ++it)
+                {
+                    keys.push_back(it.key());
+                }
+                REQUIRE(keys == std::vector<int>{2, 3, 4, 5, 6, 7, 8, 9,
+                                                 10, 16, 17, 18, 19, 20});
+
+                REQUIRE("2" == *tree.findMin());
+                REQUIRE(16 == tree.lowerBound(11).key());
+                REQUIRE(9 == tree.rank(11));
+                REQUIRE(16 == tree.select(9).key());
+                REQUIRE(3 == tree.countRange(10, 17));
+            }
+
+            AND_WHEN("A removed key is inserted again")
+            {
+                tree.insert(new std::string("13"), 13);
+
+                THEN("It is found again")
+                {
+                    REQUIRE(tree.contains(13));
+                    REQUIRE(5 == tree.getTombstoneCount());
+                    REQUIRE(10 == tree.rank(14));
+                }
+            }
+
+            AND_WHEN("The tree is compacted")
+            {
+                tree.compact();
+
+                THEN("The tombstones are gone and the rest remains")
+                {
+                    REQUIRE(0 == tree.getTombstoneCount());
+                    REQUIRE(numValues - 6 == tree.getCount());
+                    REQUIRE(tree.contains(10));
+                    REQUIRE_FALSE(tree.contains(11));
+                    REQUIRE(16 == tree.select(9).key());
+                }
+            }
+        }
+
+        WHEN("More than half the keys are removed")
+        {
+            for (int n = 1; n <= 11; n++)
+            {
+                tree.remove(n);
+            }
+
+            THEN("The tree is rebuilt without tombstones")
+            {
+                REQUIRE(0 == tree.getTombstoneCount());
+                REQUIRE(numValues - 11 == tree.getCount());
+                REQUIRE(NumTree::DEFAULT_SIZE == tree.getSize());
+                REQUIRE("12" == *tree.findMin());
+                REQUIRE("20" == *tree.findMax());
+            }
+        }
+    }
+}
+
+
+SCENARIO("BSTree: Random insertions and removals match a sorted set")
+{
+    auto mode = GENERATE(DeletionMode::Shift, DeletionMode::Tombstone);
+
+    GIVEN("A tree tracking sizes and a set of the same keys")
+    {
+        NumTree tree(/* trackSizes */ true);
+        tree.setDeletionMode(mode);
+        std::set<int> expected;
+
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(1, 100);
+        for (int i = 0; i < 1000; i++)
+        {
+            int n = keyDist(rng);
+            if (rng() % 3 == 0)
+            {
+                tree.remove(n);
+                expected.erase(n);
+            }
+            else
+            {
+                tree.insert(new std::string(std::to_string(n)), n);
+                expected.insert(n);
+            }
+        }
+
+        THEN("They hold the same keys in the same order")
+        {
+            std::vector<int> keys;
+            for (auto it = tree.begin(); it != tree.end(); ++it)
+            {
+                keys.push_back(it.key());
+            }
+            REQUIRE(keys ==
+                    std::vector<int>(expected.begin(), expected.end()));
+            REQUIRE(static_cast<int>(expected.size()) == tree.getCount());
+        }
+
+        THEN("Every rank matches the set")
+        {
+            int k = 0;
+            for (int n : expected)
+            {
+                REQUIRE(k == tree.rank(n));
+                REQUIRE(n == tree.select(k).key());
+                k++;
+            }
+        }
+    }
+}
+
+
+SCENARIO("BSTree: Insert sorted runs from a hint")
+{
+    GIVEN("A rebalancing tree with the even keys 2-200 and a sorted set")
+    {
+        BinarySearchTree<int, int, CheckedAccess, RebalancingGrowth,
+                         InlineStorage>
+            tree(/* trackSizes */ true);
+        std::set<int> expected;
+        for (int n : generateNums(100))
+        {
+            tree.insert(n * 2, n * 2);
+            expected.insert(n * 2);
+        }
+
+        auto requireSameKeys = [&] {
+            std::vector<int> keys;
+            for (auto it = tree.begin(); it != tree.end(); ++it)
+            {
+                REQUIRE(*it == it.key());
+                keys.push_back(it.key());
+            }
+            REQUIRE(keys ==
+                    std::vector<int>(expected.begin(), expected.end()));
+            REQUIRE(static_cast<int>(expected.size()) == tree.getCount());
+        };
+
+        WHEN("A sorted run overlapping the keys is inserted")
+        {
+            std::vector<std::pair<int, int>> run;
+            int added = 0;
+            for (int n = 150; n <= 1000; n++)
+            {
+                run.emplace_back(n, n);
+                added += expected.insert(n).second;
+            }
+
+            THEN("Only the new keys are added, in order")
+            {
+                REQUIRE(tree.insertSortedRun(run) == added);
+                requireSameKeys();
+                // Below 500: the even keys 2-148 and all of 150-499
+                REQUIRE(tree.rank(500) == 74 + 350);
+            }
+        }
+
+        WHEN("Nearly sorted keys are inserted, each from the last")
+        {
+            std::mt19937 rng{std::random_device{}()};
+            std::uniform_int_distribution<int> jitter(-5, 5);
+            auto hint = tree.end();
+            for (int i = 0; i < 500; i++)
+            {
+                int n = 100 + i * 3 + jitter(rng);
+                hint = tree.insertHint(hint, n, n);
+                expected.insert(n);
+
+                REQUIRE(hint.key() == n);
+            }
+
+            THEN("Every key is found in order")
+            {
+                requireSameKeys();
+            }
+        }
+    }
+}
+
+
+SCENARIO("BSTree: Choose checking, growth and storage policies")
+{
+    GIVEN("An unchecked tree with geometric growth and inline storage")
+    {
+        BinarySearchTree<int, std::string*, UncheckedAccess,
+                         GeometricGrowth, InlineStorage>
+            tree(/* trackSizes */ true);
+        tree.setDeletionMode(DeletionMode::Tombstone);
+        std::set<int> expected;
+
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(1, 200);
+        for (int i = 0; i < 1000; i++)
+        {
+            int n = keyDist(rng);
+            if (rng() % 3 == 0)
+            {
+                tree.remove(n);
+                expected.erase(n);
+            }
+            else
+            {
+                tree.insert(new std::string(std::to_string(n)), n);
+                expected.insert(n);
+            }
+        }
+
+        THEN("It holds the same keys as a sorted set")
+        {
+            std::vector<int> keys;
+            for (auto it = tree.begin(); it != tree.end(); ++it)
+            {
+                keys.push_back(it.key());
+                REQUIRE(**it == std::to_string(it.key()));
+            }
+            REQUIRE(keys ==
+                    std::vector<int>(expected.begin(), expected.end()));
+            REQUIRE(static_cast<int>(expected.size()) == tree.getCount());
+
+            for (int n = 1; n <= 200; n++)
+            {
+                REQUIRE(tree.contains(n) == (expected.count(n) == 1));
+            }
+        }
+    }
+
+    GIVEN("A tree with geometric growth")
+    {
+        BinarySearchTree<int, std::string*, CheckedAccess,
+                         GeometricGrowth>
+            tree;
+
+        WHEN("Keys are inserted in order")
+        {
+            for (int n = 1; n <= 10; n++)
+            {
+                tree.insert(new std::string(std::to_string(n)), n);
+            }
+
+            THEN("The array doubles until it holds them")
+            {
+                // The right spine of 10 nodes ends at index 2^10 - 1
+                REQUIRE(tree.getSize() == 25 * 64);
+                REQUIRE(tree.getCount() == 10);
+            }
+        }
+    }
+
+    GIVEN("A tree with rebalancing growth")
+    {
+        BinarySearchTree<int, std::string*, DebugCheckedAccess,
+                         RebalancingGrowth>
+            tree;
+
+        WHEN("1000 keys are inserted in order")
+        {
+            for (int n = 1; n <= 1000; n++)
+            {
+                tree.insert(new std::string(std::to_string(n)), n);
+            }
+
+            THEN("The array stays within a few times the size of a "
+                 "balanced tree")
+            {
+                // The whole tree is kept at least a quarter full, so the
+                // array is at most twice the next power of two over that
+                REQUIRE(tree.getCount() == 1000);
+                REQUIRE(tree.getSize() <= 8 * 1024);
+            }
+
+            THEN("Every key is still found in order")
+            {
+                int expected = 1;
+                for (auto it = tree.begin(); it != tree.end(); ++it)
+                {
+                    REQUIRE(it.key() == expected);
+                    REQUIRE(**it == std::to_string(expected));
+                    expected++;
+                }
+                REQUIRE(expected == 1001);
+            }
+        }
+    }
+}
+
+
+SCENARIO("BSTree: Store values inline")
+{
+    GIVEN("A tree holding int values inline with values 1-30")
+    {
+        BinarySearchTree<int, int> tree(/* trackSizes */ true);
+        for (int n : generateNums(30))
+        {
+            tree.insert(n * 10, n);
+        }
+
+        THEN("find() points at the value in the tree")
+        {
+            const int* found = tree.find(7);
+            REQUIRE(found != nullptr);
+            REQUIRE(*found == 70);
+            REQUIRE(tree.find(31) == nullptr);
+
+            int copy = 0;
+            REQUIRE(tree.find(8, copy));
+            REQUIRE(copy == 80);
+        }
+
+        THEN("The minimum and maximum point at values in the tree")
+        {
+            REQUIRE(*tree.findMin() == 10);
+            REQUIRE(*tree.findMax() == 300);
+        }
+
+        THEN("Printing the tree prints the values in order")
+        {
+            std::ostringstream out;
+            tree.printTree(out);
+            REQUIRE(out.str().rfind("10\n20\n30\n", 0) == 0);
+        }
+
+        WHEN("Some keys are removed")
+        {
+            tree.remove(1);
+            tree.remove(30);
+
+            THEN("The rest are still found")
+            {
+                REQUIRE(*tree.findMin() == 20);
+                REQUIRE(*tree.findMax() == 290);
+                REQUIRE(tree.rank(15) == 13);
+            }
+        }
+
+        WHEN("The tree is made empty")
+        {
+            tree.makeEmpty();
+
+            THEN("There is no minimum or maximum")
+            {
+                REQUIRE(tree.findMin() == nullptr);
+                REQUIRE(tree.findMax() == nullptr);
+            }
+        }
+    }
+
+    GIVEN("A tree holding move-only values")
+    {
+        BinarySearchTree<int, std::unique_ptr<std::string>, CheckedAccess,
+                         ExactGrowth, InlineStorage>
+            tree;
+        tree.setDeletionMode(DeletionMode::Tombstone);
+
+        WHEN("Values are inserted and emplaced")
+        {
+            tree.insert(std::make_unique<std::string>("two"), 2);
+            tree.emplace(1, new std::string("one"));
+            tree.emplace(3, new std::string("three"));
+
+            THEN("They are found in the tree")
+            {
+                REQUIRE(tree.getCount() == 3);
+                REQUIRE(**tree.find(1) == "one");
+                REQUIRE(**tree.findMin() == "one");
+                REQUIRE(**tree.findMax() == "three");
+            }
+
+            THEN("An existing key is not replaced")
+            {
+                REQUIRE_FALSE(tree.emplace(2, new std::string("other")));
+                REQUIRE(**tree.find(2) == "two");
+            }
+
+            THEN("A removed key may be emplaced again")
+            {
+                tree.remove(2);
+                REQUIRE(tree.find(2) == nullptr);
+                REQUIRE(tree.emplace(2, new std::string("again")));
+                REQUIRE(**tree.find(2) == "again");
+            }
+        }
+    }
+
+    GIVEN("A tree holding values which cannot be printed")
+    {
+        struct Point
+        {
+            int x;
+            int y;
+            Point(int x, int y) : x{x}, y{y}
+            {
+            }
+        };
+
+        BinarySearchTree<int, Point> tree;
+        tree.emplace(2, 2, 4);
+        tree.emplace(1, 1, 2);
+
+        THEN("Values are constructed in place from the arguments")
+        {
+            REQUIRE(tree.find(2)->y == 4);
+            REQUIRE(tree.findMin()->x == 1);
+        }
+
+        THEN("Printing the tree shows each value as <value>")
+        {
+            std::ostringstream out;
+            tree.printTree(out);
+            REQUIRE(out.str() == "<value>\n<value>\n");
+        }
+    }
+}
+
+
+SCENARIO("BSTree: Filter searches for missing keys")
+{
+    GIVEN("A tree with the even keys 2-2000 and a filter")
+    {
+        BinarySearchTree<int, int, CheckedAccess, RebalancingGrowth> tree;
+        for (int n : generateNums(1000))
+        {
+            tree.insert(n * 20, n * 2);
+        }
+        tree.enableFilter();
+
+        THEN("Every key is still found")
+        {
+            REQUIRE(tree.hasFilter());
+            for (int n = 2; n <= 2000; n += 2)
+            {
+                REQUIRE(*tree.find(n) == n * 10);
+            }
+            REQUIRE(tree.getFilterStats().rejected == 0);
+        }
+
+        THEN("Most missing keys are rejected by the filter")
+        {
+            for (int n = 1; n <= 20001; n += 2)
+            {
+                REQUIRE_FALSE(tree.contains(n));
+            }
+
+            auto stats = tree.getFilterStats();
+            REQUIRE(stats.queries == 10001);
+            REQUIRE(stats.rejected + stats.falsePositives == 10001);
+            REQUIRE(stats.falsePositiveRate() < 0.05);
+        }
+
+        WHEN("Keys are inserted and removed")
+        {
+            for (int n : generateNums(2000))
+            {
+                tree.insert((n + 1000) * 20, (n + 1000) * 2);
+            }
+            for (int n : generateNums(2000))
+            {
+                tree.remove(n * 2);
+            }
+
+            THEN("The filter follows the tree")
+            {
+                for (int n = 1; n <= 6001; n++)
+                {
+                    bool expected = n > 4000 && n % 2 == 0;
+                    REQUIRE(tree.contains(n) == expected);
+                }
+            }
+
+            THEN("Most removed keys are rejected by the rebuilt filter")
+            {
+                for (int n = 2; n <= 4000; n += 2)
+                {
+                    REQUIRE_FALSE(tree.contains(n));
+                }
+                REQUIRE(tree.getFilterStats().falsePositives < 2000 / 4);
+            }
+        }
+
+        WHEN("The tree is made empty")
+        {
+            tree.makeEmpty();
+
+            THEN("Nothing is found, and the filter is still used")
+            {
+                REQUIRE_FALSE(tree.contains(2));
+                REQUIRE(tree.insert(7, 7));
+                REQUIRE(tree.contains(7));
+                REQUIRE(tree.getFilterStats().queries == 2);
+            }
+        }
+
+        WHEN("The filter is disabled")
+        {
+            tree.disableFilter();
+
+            THEN("Searches no longer go through it")
+            {
+                REQUIRE(tree.contains(2));
+                REQUIRE_FALSE(tree.contains(3));
+                REQUIRE(tree.getFilterStats().queries == 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+////
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: A blocked Bloom filter.
+////
+
+#include <BloomFilter.h>
+
+#include <string>
+
+#include <catch2/catch.hpp>
+
+SCENARIO("BloomFilter: Rule out keys which were never added")
+{
+    GIVEN("A filter sized for 10000 keys with 10000 keys added")
+    {
+        BloomFilter<int> filter(10000);
+        for (int n = 0; n < 10000; n++)
+        {
+            filter.add(n * 3);
+        }
+
+        THEN("Every added key may be present")
+        {
+            for (int n = 0; n < 10000; n++)
+            {
+                REQUIRE(filter.mayContain(n * 3));
+            }
+            REQUIRE(filter.getStats().rejected == 0);
+        }
+
+        THEN("Few other keys may be present")
+        {
+            int maybe = 0;
+            for (int n = 0; n < 100000; n++)
+            {
+                maybe += filter.mayContain(n * 3 + 1);
+            }
+            REQUIRE(maybe < 3000);
+            REQUIRE(filter.getStats().rejected == 100000 - maybe);
+        }
+
+        THEN("Each key costs about ten bits")
+        {
+            REQUIRE(filter.getBytes() >= 10000 * 10 / 8);
+            REQUIRE(filter.getBytes() < 10000 * 10 / 8 + 64);
+        }
+
+        WHEN("The filter is reset")
+        {
+            filter.reset(10000);
+
+            THEN("It is empty")
+            {
+                REQUIRE_FALSE(filter.mayContain(3));
+            }
+        }
+    }
+
+    GIVEN("A filter of strings")
+    {
+        BloomFilter<std::string> filter;
+        filter.add("Knuth");
+        filter.add("Hopper");
+
+        THEN("The added strings may be present")
+        {
+            REQUIRE(filter.mayContain("Knuth"));
+            REQUIRE(filter.mayContain("Hopper"));
+        }
+    }
+
+    GIVEN("A filter sized for 100 keys")
+    {
+        BloomFilter<int> filter(100);
+
+        THEN("It asks to be rebuilt once outgrown or too stale")
+        {
+            REQUIRE_FALSE(filter.needsRebuild(100));
+            REQUIRE(filter.needsRebuild(101));
+            for (int n = 0; n < 20; n++)
+            {
+                filter.recordRemoval();
+            }
+            REQUIRE_FALSE(filter.needsRebuild(80));
+            REQUIRE(filter.needsRebuild(79));
+        }
+    }
+}
@@ -0,0 +1,225 @@
+////
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: A search tree with sorted buckets of keys at the bottom.
+////
+
+#include <BucketTree.h>
+
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+using IntBucketTree = BucketTree<int, int>;
+
+SCENARIO("BucketTree: Create an empty tree")
+{
+    GIVEN("An empty tree")
+    {
+        IntBucketTree tree;
+
+        THEN("It has no keys")
+        {
+            REQUIRE(tree.isEmpty());
+            REQUIRE(tree.getCount() == 0);
+            REQUIRE(tree.getBucketCount() == 0);
+            REQUIRE(tree.findMin() == nullptr);
+            REQUIRE(tree.findMax() == nullptr);
+            REQUIRE_FALSE(tree.contains(1));
+        }
+
+        THEN("Removing a key does nothing")
+        {
+            tree.remove(1);
+            REQUIRE(tree.isEmpty());
+        }
+    }
+}
+
+SCENARIO("BucketTree: Insert keys in order")
+{
+    GIVEN("A tree with the keys 1-1000 inserted in order")
+    {
+        IntBucketTree tree;
+        for (int n = 1; n <= 1000; n++)
+        {
+            REQUIRE(tree.insert(n * 10, n));
+        }
+
+        THEN("Every key is found with its value, and no others")
+        {
+            REQUIRE(tree.getCount() == 1000);
+            for (int n = 1; n <= 1000; n++)
+            {
+                REQUIRE(*tree.find(n) == n * 10);
+            }
+            REQUIRE_FALSE(tree.contains(0));
+            REQUIRE_FALSE(tree.contains(1001));
+            REQUIRE(*tree.findMin() == 10);
+            REQUIRE(*tree.findMax() == 10000);
+        }
+
+        THEN("The keys are split into buckets at least half full")
+        {
+            int most = 1000 / (IntBucketTree::BUCKET_KEYS / 2);
+            REQUIRE(tree.getBucketCount() > 1);
+            REQUIRE(tree.getBucketCount() <= most);
+        }
+
+        THEN("An existing key is not replaced")
+        {
+            REQUIRE_FALSE(tree.insert(-1, 500));
+            REQUIRE(*tree.find(500) == 5000);
+            REQUIRE(tree.getCount() == 1000);
+        }
+
+        WHEN("Every key is removed")
+        {
+            for (int n = 1; n <= 1000; n++)
+            {
+                tree.remove(n);
+                REQUIRE_FALSE(tree.contains(n));
+            }
+
+            THEN("The buckets are merged back into one")
+            {
+                REQUIRE(tree.isEmpty());
+                REQUIRE(tree.getBucketCount() == 1);
+                REQUIRE(tree.findMin() == nullptr);
+            }
+        }
+
+        WHEN("The tree is made empty")
+        {
+            tree.makeEmpty();
+
+            THEN("It has no keys and may be filled again")
+            {
+                REQUIRE(tree.isEmpty());
+                REQUIRE_FALSE(tree.contains(1));
+                REQUIRE(tree.insert(1, 1));
+                REQUIRE(*tree.find(1) == 1);
+            }
+        }
+    }
+
+    GIVEN("A tree with the keys 1-5")
+    {
+        IntBucketTree tree;
+        for (int n = 1; n <= 5; n++)
+        {
+            tree.insert(n, n);
+        }
+
+        THEN("The values are printed in order")
+        {
+            std::ostringstream out;
+            tree.printTree(out);
+            REQUIRE(out.str() == "1\n2\n3\n4\n5\n");
+        }
+    }
+}
+
+SCENARIO("BucketTree: Random insertions and removals match a sorted set")
+{
+    GIVEN("A tree and a set of the same keys")
+    {
+        IntBucketTree tree;
+        std::set<int> expected;
+
+        std::mt19937 rng{std::random_device{}()};
+        int range = GENERATE(100, 2000, 100000);
+        std::uniform_int_distribution<int> keyDist(-range, range);
+        for (int i = 0; i < 20000; i++)
+        {
+            int n = keyDist(rng);
+            if (rng() % 3 == 0)
+            {
+                tree.remove(n);
+                expected.erase(n);
+            }
+            else
+            {
+                REQUIRE(tree.insert(-n, n) == expected.insert(n).second);
+            }
+        }
+
+        THEN("They hold the same keys")
+        {
+            REQUIRE(static_cast<int>(expected.size()) == tree.getCount());
+            for (int n = -range - 1; n <= range + 1; n++)
+            {
+                REQUIRE(tree.contains(n) == (expected.count(n) > 0));
+            }
+            REQUIRE(*tree.findMin() == -*expected.begin());
+            REQUIRE(*tree.findMax() == -*expected.rbegin());
+        }
+
+        WHEN("Most of the keys are removed")
+        {
+            int kept = 0;
+            for (auto it = expected.begin(); it != expected.end();)
+            {
+                if (kept++ % 10)
+                {
+                    tree.remove(*it);
+                    it = expected.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            THEN("The rest are still found")
+            {
+                REQUIRE(static_cast<int>(expected.size()) ==
+                        tree.getCount());
+                for (int n : expected)
+                {
+                    REQUIRE(*tree.find(n) == -n);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("BucketTree: Store move-only values")
+{
+    GIVEN("A tree of move-only values filling several buckets")
+    {
+        BucketTree<int, std::unique_ptr<std::string>> tree;
+        for (int n = 1; n <= 300; n++)
+        {
+            tree.emplace(n, new std::string(std::to_string(n)));
+        }
+
+        WHEN("Keys are removed so buckets merge")
+        {
+            for (int n = 1; n <= 300; n++)
+            {
+                if (n % 4)
+                {
+                    tree.remove(n);
+                }
+            }
+
+            THEN("The values moved with their keys")
+            {
+                REQUIRE(tree.getCount() == 75);
+                for (int n = 4; n <= 300; n += 4)
+                {
+                    REQUIRE(**tree.find(n) == std::to_string(n));
+                }
+                REQUIRE(**tree.findMin() == "4");
+                REQUIRE(**tree.findMax() == "300");
+            }
+        }
+    }
+}
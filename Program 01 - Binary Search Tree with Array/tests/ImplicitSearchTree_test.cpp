@@ -0,0 +1,152 @@
+////
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: A read-only complete tree in Eytzinger or van Emde Boas
+// layout.
+////
+
+#include <ImplicitSearchTree.h>
+#include <TreeLayouts.h>
+
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+SCENARIO("TreeLayouts: Place a complete tree in van Emde Boas order")
+{
+    GIVEN("A van Emde Boas layout of a tree with 4 levels")
+    {
+        VanEmdeBoasLayout layout(4);
+
+        THEN("The top 3 nodes come first, then each bottom tree")
+        {
+            std::vector<int> positions;
+            for (int i = 1; i < 16; i++)
+            {
+                positions.push_back(layout.positionOf(i));
+            }
+
+            // Nodes 1-3 are the top tree; nodes 4, 8 and 9 are the first
+            // bottom tree, and so on
+            REQUIRE(positions == std::vector<int>{0, 1, 2, 3, 6, 9, 12,
+                                                  4, 5, 7, 8, 10, 11, 13,
+                                                  14});
+        }
+    }
+
+    GIVEN("A van Emde Boas layout of each height up to 20")
+    {
+        int height = GENERATE(range(1, 21));
+        VanEmdeBoasLayout layout(height);
+
+        THEN("Every node has its own position in the array")
+        {
+            int slots = (1 << height) - 1;
+            std::vector<bool> used(slots);
+            for (int i = 1; i <= slots; i++)
+            {
+                int position = layout.positionOf(i);
+                REQUIRE(position >= 0);
+                REQUIRE(position < slots);
+                REQUIRE_FALSE(used[position]);
+                used[position] = true;
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("ImplicitSearchTree: Search a tree in each layout", "",
+                   EytzingerLayout, VanEmdeBoasLayout)
+{
+    using Tree = ImplicitSearchTree<int, int, TestType>;
+
+    GIVEN("Trees of random keys of sizes around powers of two")
+    {
+        int count = GENERATE(1, 2, 3, 7, 8, 100, 1023, 1024, 5000);
+
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(-100000, 100000);
+        std::set<int> keySet;
+        while (static_cast<int>(keySet.size()) < count)
+        {
+            keySet.insert(keyDist(rng));
+        }
+        std::vector<int> keys(keySet.begin(), keySet.end());
+
+        std::vector<std::pair<int, int>> pairs;
+        for (int key : keys)
+        {
+            pairs.emplace_back(key, key * 2);
+        }
+        auto tree = Tree::fromSorted(pairs.begin(), pairs.end());
+
+        THEN("Every lower bound matches a binary search")
+        {
+            REQUIRE(tree.getCount() == count);
+            for (int n = -100010; n <= 100010; n += 13)
+            {
+                auto expected =
+                    std::lower_bound(keys.begin(), keys.end(), n);
+                auto bound = tree.lowerBound(n);
+                if (expected == keys.end())
+                {
+                    REQUIRE(bound == tree.end());
+                }
+                else
+                {
+                    REQUIRE(bound.key() == *expected);
+                }
+            }
+        }
+
+        THEN("Every key is found with its value")
+        {
+            for (int key : keys)
+            {
+                REQUIRE(*tree.find(key) == key * 2);
+            }
+            REQUIRE_FALSE(tree.contains(keys.back() + 1));
+            REQUIRE_FALSE(tree.contains(INT_MAX));
+            REQUIRE(*tree.findMax() == keys.back() * 2);
+        }
+    }
+
+    GIVEN("An empty range")
+    {
+        std::vector<std::pair<int, int>> pairs;
+        auto tree = Tree::fromSorted(pairs.begin(), pairs.end());
+
+        THEN("The tree is empty")
+        {
+            REQUIRE(tree.isEmpty());
+            REQUIRE(tree.getHeight() == 0);
+            REQUIRE_FALSE(tree.contains(0));
+            REQUIRE(tree.findMin() == nullptr);
+            REQUIRE(tree.lowerBound(0) == tree.end());
+        }
+    }
+
+    GIVEN("Keys which are not sorted")
+    {
+        std::vector<std::pair<int, int>> pairs = {{2, 2}, {1, 1}};
+
+        THEN("The tree cannot be built, or changed once built")
+        {
+            REQUIRE_THROWS_AS(Tree::fromSorted(pairs.begin(), pairs.end()),
+                              std::invalid_argument);
+
+            std::reverse(pairs.begin(), pairs.end());
+            auto tree = Tree::fromSorted(pairs.begin(), pairs.end());
+            REQUIRE_THROWS_AS(tree.insert(3, 3), std::logic_error);
+            REQUIRE_THROWS_AS(tree.remove(1), std::logic_error);
+        }
+    }
+}
@@ -0,0 +1,209 @@
+////
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: A read-only learned index over sorted integer keys.
+////
+
+#include <BSTree.h>
+#include <LearnedIndex.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using IntIndex = LearnedIndex<int, int>;
+
+SCENARIO("LearnedIndex: Build from a sorted range")
+{
+    GIVEN("An index of the IDs 1-437 with values ten times larger")
+    {
+        std::vector<std::pair<int, int>> pairs;
+        for (int n = 1; n <= 437; n++)
+        {
+            pairs.emplace_back(n, n * 10);
+        }
+        auto index = IntIndex::fromSorted(pairs.begin(), pairs.end());
+
+        THEN("One line predicts every key")
+        {
+            REQUIRE(index.getCount() == 437);
+            REQUIRE(index.getSegmentCount() == 1);
+            REQUIRE(index.getEpsilon() == IntIndex::DEFAULT_EPSILON);
+        }
+
+        THEN("Every key is found with its value, and no others")
+        {
+            for (int n = 1; n <= 437; n++)
+            {
+                REQUIRE(*index.find(n) == n * 10);
+            }
+            REQUIRE_FALSE(index.contains(0));
+            REQUIRE_FALSE(index.contains(438));
+            REQUIRE(index.find(std::numeric_limits<int>::max()) ==
+                    nullptr);
+        }
+
+        THEN("The minimum, maximum and bounds match the keys")
+        {
+            REQUIRE(*index.findMin() == 10);
+            REQUIRE(*index.findMax() == 4370);
+            REQUIRE(index.lowerBound(-5).key() == 1);
+            REQUIRE(index.lowerBound(437).key() == 437);
+            REQUIRE(index.lowerBound(438) == index.end());
+        }
+
+        THEN("The index cannot be changed")
+        {
+            REQUIRE_THROWS_AS(index.insert(1, 1), std::logic_error);
+            REQUIRE_THROWS_AS(index.remove(1), std::logic_error);
+            REQUIRE(index.contains(1));
+        }
+    }
+
+    GIVEN("10000 random keys")
+    {
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(-1000000, 1000000);
+        std::vector<int> keys;
+        for (int i = 0; i < 10000; i++)
+        {
+            keys.push_back(keyDist(rng));
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        std::vector<std::pair<int, int>> pairs;
+        for (int key : keys)
+        {
+            pairs.emplace_back(key, -key);
+        }
+
+        WHEN("The index is built with each error bound")
+        {
+            int epsilon = GENERATE(0, 1, 4, 16, 64);
+            auto index =
+                IntIndex::fromSorted(pairs.begin(), pairs.end(), epsilon);
+
+            THEN("Every lower bound matches a binary search")
+            {
+                for (int n = -1000010; n <= 1000010; n += 37)
+                {
+                    auto expected =
+                        std::lower_bound(keys.begin(), keys.end(), n);
+                    auto bound = index.lowerBound(n);
+                    if (expected == keys.end())
+                    {
+                        REQUIRE(bound == index.end());
+                    }
+                    else
+                    {
+                        REQUIRE(bound.key() == *expected);
+                    }
+                }
+                for (int key : keys)
+                {
+                    REQUIRE(*index.find(key) == -key);
+                }
+            }
+        }
+
+        THEN("A smaller error bound needs more segments")
+        {
+            auto loose =
+                IntIndex::fromSorted(pairs.begin(), pairs.end(), 64);
+            auto tight =
+                IntIndex::fromSorted(pairs.begin(), pairs.end(), 2);
+            REQUIRE(loose.getSegmentCount() < tight.getSegmentCount());
+        }
+    }
+
+    GIVEN("64-bit keys at the limits of their range")
+    {
+        using Key = std::int64_t;
+        const Key lowest = std::numeric_limits<Key>::min();
+        const Key highest = std::numeric_limits<Key>::max();
+        std::vector<std::pair<Key, int>> pairs = {
+            {lowest, 1}, {lowest + 1, 2}, {-1, 3},
+            {0, 4},      {highest - 1, 5}, {highest, 6}};
+        auto index = LearnedIndex<Key, int>::fromSorted(
+            pairs.begin(), pairs.end(), 0);
+
+        THEN("Every key is found without overflow")
+        {
+            for (const auto& [key, value] : pairs)
+            {
+                REQUIRE(*index.find(key) == value);
+            }
+            REQUIRE_FALSE(index.contains(1));
+            REQUIRE(index.lowerBound(1).key() == highest - 1);
+        }
+    }
+
+    GIVEN("Keys which are not sorted, or a negative error bound")
+    {
+        std::vector<std::pair<int, int>> pairs = {{1, 1}, {3, 3}, {2, 2}};
+        std::vector<std::pair<int, int>> sorted = {{1, 1}, {2, 2}};
+
+        THEN("The index cannot be built")
+        {
+            REQUIRE_THROWS_AS(
+                IntIndex::fromSorted(pairs.begin(), pairs.end()),
+                std::invalid_argument);
+            REQUIRE_THROWS_AS(
+                IntIndex::fromSorted(sorted.begin(), sorted.end(), -1),
+                std::invalid_argument);
+        }
+    }
+
+    GIVEN("An empty range")
+    {
+        std::vector<std::pair<int, int>> pairs;
+        auto index = IntIndex::fromSorted(pairs.begin(), pairs.end());
+
+        THEN("The index is empty")
+        {
+            REQUIRE(index.isEmpty());
+            REQUIRE(index.getSegmentCount() == 0);
+            REQUIRE(index.findMin() == nullptr);
+            REQUIRE_FALSE(index.contains(0));
+            REQUIRE(index.lowerBound(0) == index.end());
+        }
+    }
+}
+
+SCENARIO("LearnedIndex: Build from a BinarySearchTree")
+{
+    GIVEN("A BinarySearchTree with 2000 keys in clusters")
+    {
+        BinarySearchTree<int, int, CheckedAccess, RebalancingGrowth>
+            source;
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> offsetDist(0, 500);
+        for (int i = 0; i < 2000; i++)
+        {
+            int key = (i % 4) * 1000000 + offsetDist(rng) * (i % 4 + 1);
+            source.insert(key, key);
+        }
+
+        auto index = IntIndex::fromTree(source, 8);
+
+        THEN("Both answer every search the same")
+        {
+            REQUIRE(index.getCount() == source.getCount());
+            for (int n = -10; n <= 3002010; n += 7)
+            {
+                REQUIRE(index.contains(n) == source.contains(n));
+            }
+            REQUIRE(*index.findMin() == *source.findMin());
+            REQUIRE(*index.findMax() == *source.findMax());
+        }
+    }
+}
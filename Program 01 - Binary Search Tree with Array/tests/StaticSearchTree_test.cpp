@@ -0,0 +1,219 @@
+////
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 1 - Binary Search Tree with Array
+//
+// Description: A read-only search tree with 16 keys per node.
+////
+
+#include <BSTree.h>
+#include <StaticSearchTree.h>
+
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using IntTree = StaticSearchTree<int, int>;
+
+SCENARIO("StaticSearchTree: Build from a sorted range")
+{
+    GIVEN("A tree of the even keys 2-2000 with values ten times larger")
+    {
+        std::vector<std::pair<int, int>> pairs;
+        for (int n = 2; n <= 2000; n += 2)
+        {
+            pairs.emplace_back(n, n * 10);
+        }
+        auto tree = IntTree::fromSorted(pairs.begin(), pairs.end());
+
+        THEN("Every key is found with its value")
+        {
+            REQUIRE(tree.getCount() == 1000);
+            for (int n = 2; n <= 2000; n += 2)
+            {
+                REQUIRE(tree.contains(n));
+                REQUIRE(*tree.find(n) == n * 10);
+            }
+        }
+
+        THEN("Missing keys are not found")
+        {
+            for (int n = -1; n <= 2001; n += 2)
+            {
+                REQUIRE_FALSE(tree.contains(n));
+                REQUIRE(tree.find(n) == nullptr);
+            }
+            REQUIRE_FALSE(tree.contains(INT_MIN));
+            REQUIRE_FALSE(tree.contains(INT_MAX));
+        }
+
+        THEN("The lower bound is the first key not less than the key")
+        {
+            REQUIRE(tree.lowerBound(INT_MIN).key() == 2);
+            REQUIRE(tree.lowerBound(2).key() == 2);
+            REQUIRE(tree.lowerBound(3).key() == 4);
+            REQUIRE(*tree.lowerBound(1001) == 10020);
+            REQUIRE(tree.lowerBound(2000).key() == 2000);
+            REQUIRE(tree.lowerBound(2001) == tree.end());
+        }
+
+        THEN("The minimum and maximum are the first and last values")
+        {
+            REQUIRE(*tree.findMin() == 20);
+            REQUIRE(*tree.findMax() == 20000);
+        }
+
+        THEN("Iterating visits every key in order")
+        {
+            int expected = 2;
+            for (auto it = tree.begin(); it != tree.end(); ++it)
+            {
+                REQUIRE(it.key() == expected);
+                expected += 2;
+            }
+            REQUIRE(expected == 2002);
+        }
+
+        THEN("The tree cannot be changed")
+        {
+            REQUIRE_THROWS_AS(tree.insert(1, 1), std::logic_error);
+            REQUIRE_THROWS_AS(tree.remove(2), std::logic_error);
+            REQUIRE(tree.contains(2));
+        }
+    }
+
+    GIVEN("Keys at the limits of int")
+    {
+        std::vector<std::pair<int, int>> pairs = {
+            {INT_MIN, 1}, {0, 2}, {INT_MAX, 3}};
+        auto tree = IntTree::fromSorted(pairs.begin(), pairs.end());
+
+        THEN("They are found, even though the last node is padded")
+        {
+            REQUIRE(*tree.find(INT_MIN) == 1);
+            REQUIRE(*tree.find(0) == 2);
+            REQUIRE(*tree.find(INT_MAX) == 3);
+            REQUIRE(tree.lowerBound(1).key() == INT_MAX);
+        }
+    }
+
+    GIVEN("Keys which are not sorted")
+    {
+        std::vector<std::pair<int, int>> pairs = {{1, 1}, {3, 3}, {2, 2}};
+
+        THEN("The tree cannot be built")
+        {
+            REQUIRE_THROWS_AS(
+                IntTree::fromSorted(pairs.begin(), pairs.end()),
+                std::invalid_argument);
+        }
+    }
+
+    GIVEN("An empty range")
+    {
+        std::vector<std::pair<int, int>> pairs;
+        auto tree = IntTree::fromSorted(pairs.begin(), pairs.end());
+
+        THEN("The tree is empty")
+        {
+            REQUIRE(tree.isEmpty());
+            REQUIRE(tree.findMin() == nullptr);
+            REQUIRE(tree.findMax() == nullptr);
+            REQUIRE_FALSE(tree.contains(0));
+            REQUIRE(tree.lowerBound(0) == tree.end());
+        }
+    }
+}
+
+SCENARIO("StaticSearchTree: Build from a BinarySearchTree")
+{
+    GIVEN("A BinarySearchTree with 5000 random keys")
+    {
+        BinarySearchTree<int, std::string*, CheckedAccess,
+                         RebalancingGrowth>
+            source;
+        std::vector<int> nums;
+
+        std::mt19937 rng{std::random_device{}()};
+        std::uniform_int_distribution<int> keyDist(-100000, 100000);
+        for (int i = 0; i < 5000; i++)
+        {
+            int n = keyDist(rng);
+            if (source.insert(new std::string(std::to_string(n)), n))
+            {
+                nums.push_back(n);
+            }
+        }
+        std::sort(nums.begin(), nums.end());
+
+        auto tree = StaticSearchTree<int, std::string*>::fromTree(source);
+
+        THEN("Both trees answer every search the same")
+        {
+            REQUIRE(tree.getCount() == source.getCount());
+            for (int n = -100005; n <= 100005; n += 7)
+            {
+                REQUIRE(tree.contains(n) == source.contains(n));
+
+                auto bound = tree.lowerBound(n);
+                auto expected = source.lowerBound(n);
+                REQUIRE((bound == tree.end()) ==
+                        (expected == source.end()));
+                if (bound != tree.end())
+                {
+                    REQUIRE(bound.key() == expected.key());
+                    REQUIRE(*bound == *expected);
+                }
+            }
+        }
+
+        THEN("The values are the same pointers")
+        {
+            for (int n : nums)
+            {
+                std::string* found = nullptr;
+                REQUIRE(tree.find(n, found));
+                REQUIRE(*found == std::to_string(n));
+            }
+            REQUIRE(tree.findMin() == source.findMin());
+            REQUIRE(tree.findMax() == source.findMax());
+        }
+
+        THEN("Printing the tree prints the values in order")
+        {
+            std::ostringstream expected;
+            source.printTree(expected);
+
+            std::ostringstream out;
+            tree.printTree(out);
+            REQUIRE(out.str() == expected.str());
+        }
+    }
+
+    GIVEN("A BinarySearchTree with string keys")
+    {
+        BinarySearchTree<std::string, int> source;
+        for (const char* word : {"pear", "apple", "fig", "kiwi", "date"})
+        {
+            source.insert(static_cast<int>(std::string(word).size()),
+                          word);
+        }
+
+        auto tree = StaticSearchTree<std::string, int>::fromTree(source);
+
+        THEN("Searches compare the strings")
+        {
+            REQUIRE(*tree.find("kiwi") == 4);
+            REQUIRE(tree.find("plum") == nullptr);
+            REQUIRE(tree.lowerBound("e").key() == "fig");
+            REQUIRE(*tree.findMax() == 4);
+        }
+    }
+}
@@ -73,11 +73,10 @@ int main()
     std::cout << "\n\nRemove Multiples of 10\n\n";
 
 
-    // NOLINTNEXTLINE
-    for (int i = 10; i < length; i += 10)
-    {
-        list.remove(i);
-    }
+    // One pass along the list, rather than one search per key
+    list.removeIf([](int id, const ComputerScientist&) {
+        return id % 10 == 0;
+    });
 
     std::cout << "Number of Items: " << list.getLength() << "\n";
     list.displayList();
@@ -0,0 +1,316 @@
+///
+// Name: Tamara Roberson
+// Section: A
+// Program Name: Program 03 - SkipList
+//
+// Description: A blocked Bloom filter, which answers "definitely not
+// present" or "maybe present" for a key.
+//
+// A search for a missing key walks all the way down a list, missing the
+// cache at nearly every level. The filter can rule most of those out
+// first. Every key sets a few bits in one 512-bit block, the size of a
+// cache line, so a query reads a single line no matter how many bits
+// it checks.
+//
+// Keys cannot be taken out of a Bloom filter, so a filter in front of a
+// container goes stale as keys are removed, and its owner should rebuild
+// it from time to time (see needsRebuild()).
+///
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * True if std::hash can hash values of type T.
+ */
+template <typename T, typename = void> struct IsHashable : std::false_type
+{
+};
+
+template <typename T>
+struct IsHashable<T, std::void_t<decltype(std::declval<std::hash<T>>()(
+                         std::declval<const T&>()))>> : std::true_type
+{
+};
+
+/*
+ * The hash a BloomFilter uses by default: std::hash, except that strings
+ * are hashed as a std::string_view of their characters, so that a
+ * std::string_view or const char* can be looked up without copying it
+ * into a std::string.
+ */
+template <typename Key> struct FilterHash : std::hash<Key>
+{
+};
+
+template <> struct FilterHash<std::string>
+{
+    // other types are hashed alike when equal to the key
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view key) const noexcept
+    {
+        return std::hash<std::string_view>{}(key);
+    }
+};
+
+/*
+ * True if the hash has an is_transparent member type, meaning it hashes
+ * keys of other types just as the equal keys of its own type.
+ */
+template <typename Hash, typename = void>
+struct IsTransparent : std::false_type
+{
+};
+
+template <typename Hash>
+struct IsTransparent<Hash, std::void_t<typename Hash::is_transparent>>
+    : std::true_type
+{
+};
+
+/*
+ * Counts of how the filter answered queries.
+ */
+struct BloomFilterStats
+{
+    // number of keys queried
+    long queries = 0;
+
+    // number of queries answered "definitely not present"
+    long rejected = 0;
+
+    // number of "maybe present" answers for keys which were missing
+    long falsePositives = 0;
+
+    /*
+     * Returns the fraction of missing keys the filter let through, or 0
+     * if no missing keys have been queried.
+     */
+    [[nodiscard]] double falsePositiveRate() const noexcept
+    {
+        long negatives = this->rejected + this->falsePositives;
+        return negatives ? static_cast<double>(this->falsePositives) /
+                               static_cast<double>(negatives)
+                         : 0.0;
+    }
+};
+
+template <typename Key, typename Hash = FilterHash<Key>> class BloomFilter
+{
+  public:
+    static constexpr double DEFAULT_BITS_PER_KEY = 10.0;
+
+    // the filter is never sized for fewer keys than this
+    static constexpr int MIN_CAPACITY = 64;
+
+  private:
+    static constexpr int BLOCK_BITS = 512;
+    static constexpr int WORD_BITS = 64;
+
+    /*
+     * 512 bits, aligned to a cache line
+     */
+    struct alignas(64) Block
+    {
+        std::uint64_t words[BLOCK_BITS / WORD_BITS] = {};
+    };
+
+    std::vector<Block> blocks;
+
+    // number of bits set for each key
+    int probes = 1;
+
+    // bits of filter for each key it is sized for
+    double bitsPerKey = DEFAULT_BITS_PER_KEY;
+
+    // number of keys the filter was sized for
+    int capacity = 0;
+
+    // number of keys removed from the owner since the filter was built
+    int stale = 0;
+
+    mutable BloomFilterStats stats;
+
+    /*
+     * Returns a well-mixed 64-bit hash of the key. std::hash of an
+     * integer is often the integer itself, so its bits are scrambled
+     * (with the splitmix64 finalizer).
+     */
+    template <typename K>
+    [[nodiscard]] static std::uint64_t hashKey(const K& key)
+    {
+        auto h = static_cast<std::uint64_t>(Hash{}(key));
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    /*
+     * Returns the index of the block the hash selects, using the upper
+     * 32 bits to scale into the number of blocks without a division.
+     */
+    [[nodiscard]] std::size_t blockIndex(std::uint64_t h) const noexcept
+    {
+        return static_cast<std::size_t>(
+            ((h >> 32) * this->blocks.size()) >> 32);
+    }
+
+    /*
+     * Calls visit(word, bit) for each bit the hash sets in its block.
+     * The bits are spread by double hashing on the lower 32 bits.
+     */
+    template <typename Visitor>
+    bool forEachBit(std::uint64_t h, Visitor visit) const
+    {
+        auto lo = static_cast<std::uint32_t>(h);
+        std::uint32_t step = (lo >> 16) | 1;
+        for (int i = 0; i < this->probes; i++)
+        {
+            std::uint32_t bit = (lo + i * step) % BLOCK_BITS;
+            if (!visit(bit / WORD_BITS,
+                       std::uint64_t{1} << (bit % WORD_BITS)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  public:
+    /*
+     * CONSTRUCTOR
+     * Sizes the filter for the given number of keys with about
+     * bitsPerKey bits each [default: 10, about a 1% false positive rate].
+     */
+    explicit BloomFilter(int expectedKeys = MIN_CAPACITY,
+                         double bitsPerKey = DEFAULT_BITS_PER_KEY)
+        : bitsPerKey{std::max(bitsPerKey, 1.0)}
+    {
+        reset(expectedKeys);
+    }
+
+    /*
+     * Empties the filter and sizes it for the given number of keys.
+     * The statistics are kept.
+     */
+    void reset(int expectedKeys)
+    {
+        this->capacity = std::max(expectedKeys, MIN_CAPACITY);
+
+        double bits = this->capacity * this->bitsPerKey;
+        this->blocks.assign(
+            static_cast<std::size_t>(std::ceil(bits / BLOCK_BITS)),
+            Block{});
+
+        // Setting bitsPerKey * ln 2 bits for each key minimizes the false
+        // positive rate
+        auto best = std::lround(this->bitsPerKey * std::log(2.0));
+        this->probes = std::clamp(static_cast<int>(best), 1, 16);
+        this->stale = 0;
+    }
+
+    /*
+     * Adds a key to the filter.
+     */
+    void add(const Key& key)
+    {
+        std::uint64_t h = hashKey(key);
+        Block& block = this->blocks[blockIndex(h)];
+        forEachBit(h, [&](std::uint32_t word, std::uint64_t mask) {
+            block.words[word] |= mask;
+            return true;
+        });
+    }
+
+    /*
+     * Returns false if the key was never added, true if it may have
+     * been. The key may be of another type if the hash is transparent
+     * (see canQuery()).
+     */
+    template <typename K>
+    [[nodiscard]] bool mayContain(const K& key) const
+    {
+        this->stats.queries++;
+
+        std::uint64_t h = hashKey(key);
+        const Block& block = this->blocks[blockIndex(h)];
+        bool maybe =
+            forEachBit(h, [&](std::uint32_t word, std::uint64_t mask) {
+                return (block.words[word] & mask) != 0;
+            });
+
+        this->stats.rejected += !maybe;
+        return maybe;
+    }
+
+    /*
+     * Returns true if keys of type K can be asked about: those of type
+     * Key, or any type if the hash is transparent.
+     */
+    template <typename K>
+    [[nodiscard]] static constexpr bool canQuery() noexcept
+    {
+        return std::is_same<K, Key>::value || IsTransparent<Hash>::value;
+    }
+
+    /*
+     * Records that a key the filter let through was not found.
+     */
+    void recordFalsePositive() const noexcept
+    {
+        this->stats.falsePositives++;
+    }
+
+    /*
+     * Records that count keys [default: 1] were removed from the owner.
+     * Their bits stay set.
+     */
+    void recordRemoval(int count = 1) noexcept
+    {
+        this->stale += count;
+    }
+
+    /*
+     * Returns true if the owner, now holding count keys, should rebuild
+     * the filter: either it has outgrown the filter, or the keys removed
+     * since it was built outnumber a quarter of the keys left (every
+     * search for a removed key gets past the filter).
+     */
+    [[nodiscard]] bool needsRebuild(int count) const noexcept
+    {
+        return count > this->capacity ||
+               this->stale > std::max(count, MIN_CAPACITY) / 4;
+    }
+
+    [[nodiscard]] const BloomFilterStats& getStats() const noexcept
+    {
+        return this->stats;
+    }
+
+    [[nodiscard]] int getCapacity() const noexcept
+    {
+        return this->capacity;
+    }
+
+    /*
+     * Returns the size of the filter in bytes.
+     */
+    [[nodiscard]] std::size_t getBytes() const noexcept
+    {
+        return this->blocks.size() * sizeof(Block);
+    }
+};
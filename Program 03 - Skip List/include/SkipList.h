@@ -10,105 +10,155 @@
 // key, which can be any comparable type.
 //
 // Like all linked lists, skip lists have poor cache hit performance. This
-// implementation is traditional, with downward links but an alternative is
-// described here: http://ticki.github.io/blog/skip-lists-done-right/
+// implementation keeps each element in one allocation, following
+// http://ticki.github.io/blog/skip-lists-done-right/ rather than the
+// traditional layout of one node per level with downward links: the key
+// and value are stored once, followed by a tower of raw next pointers,
+// one for each level the element is on.
+//
+// Optionally, a Bloom filter sits in front of contains() (see
+// enableFilter()), so most searches for missing keys return after reading
+// one cache line instead of walking the list.
+//
+// A list keyed by strings can be searched with a std::string_view or a
+// const char* (see contains()), without copying it into a std::string
+// first.
+//
+// Keys which arrive in order can be inserted from where the last one
+// went (see insertHint() and insertSortedRun()) instead of from the top
+// of the list, so a sorted batch of k keys takes O(k) steps plus one
+// search. Likewise many keys can be removed at once (see removeIf() and
+// removeRange()) in one pass along the bottom row.
 ///
 
 #pragma once
 
+#include "BloomFilter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <iostream>
 #include <memory>
-#include <optional>
+#include <new>
 #include <random>
 #include <string>
-#include <vector>
+#include <type_traits>
+#include <utility>
+
+/*
+ * True if keys of type K can be compared with keys of type Key, so a
+ * list of Key can be searched for a K without making a Key of it: a
+ * std::string_view or a const char* for std::string keys.
+ */
+template <typename K, typename Key, typename = void>
+struct IsComparableKey : std::false_type
+{
+};
+
+template <typename K, typename Key>
+struct IsComparableKey<
+    K, Key,
+    std::void_t<
+        decltype(std::declval<const Key&>() <= std::declval<const K&>()),
+        decltype(std::declval<const Key&>() == std::declval<const K&>())>>
+    : std::true_type
+{
+};
 
 template <typename Key, typename Value> class SkipList
 {
+  public:
+    // no tower is taller than this, which with even odds for each level
+    // is enough for about four billion nodes
+    static constexpr int MAX_HEIGHT = 32;
+
   private:
     /*
      * Private Node Class
+     * A node is a single allocation: its key and value, then the next
+     * pointers of its tower, the bottom level first, allocated right
+     * after it (see create()).
      */
-    class Node
+    class alignas(void*) Node
     {
-      private:
-        std::optional<Key> key;
-        std::optional<Value> value;
-
-        std::shared_ptr<Node> next;
-        std::shared_ptr<Node> below;
-
       public:
-        explicit Node(std::optional<Key> key = std::nullopt,
-                      std::optional<Value> value = std::nullopt,
-                      std::shared_ptr<Node> next = nullptr,
-                      std::shared_ptr<Node> below = nullptr)
-            : key{std::move(key)}, value{std::move(value)},
-              next{std::move(next)}, below{std::move(below)}
-        {
-        }
-
-        Node(Key key, Value value, std::shared_ptr<Node> next = nullptr,
-             std::shared_ptr<Node> below = nullptr)
-            : next{std::move(next)}, below{std::move(below)}
-        {
-            this->key = std::make_optional<Key>(key);
-            this->value = std::make_optional<Value>(value);
-        }
-
+        Key key;
+        Value value;
 
-        bool isRoot()
-        {
-            return !key.has_value();
-        }
+        // the number of levels the node is on
+        int height;
 
-        std::optional<Key> getKey()
+        Node(Key key, Value value, int height)
+            : key{std::move(key)}, value{std::move(value)}, height{height}
         {
-            return key;
         }
 
-        std::optional<Value> getValue()
+        /*
+         * Allocates a node with a tower of the given height, with every
+         * next pointer null
+         */
+        static Node* create(Key key, Value value, int height)
         {
-            return value;
-        }
+            std::size_t bytes = sizeof(Node) + height * sizeof(Node*);
+            void* memory =
+                ::operator new(bytes, std::align_val_t{alignof(Node)});
 
-        std::shared_ptr<Node> getNext()
-        {
-            return next;
-        }
+            Node* node = nullptr;
+            try
+            {
+                node = ::new (memory)
+                    Node(std::move(key), std::move(value), height);
+            }
+            catch (...)
+            {
+                // FAIL: The key or value could not be moved in
+                ::operator delete(memory, std::align_val_t{alignof(Node)});
+                throw;
+            }
 
-        void setNext(std::shared_ptr<Node> node)
-        {
-            next = node;
+            Node** tower = node->getTower();
+            for (int level = 0; level < height; level++)
+            {
+                ::new (&tower[level]) Node*(nullptr);
+            }
+            return node;
         }
 
-        std::shared_ptr<Node> getBelow()
+        /*
+         * Destroys a node made by create() and frees its memory
+         */
+        static void destroy(Node* node) noexcept
         {
-            return below;
+            node->~Node();
+            ::operator delete(node, std::align_val_t{alignof(Node)});
         }
 
-        void setBelow(std::shared_ptr<Node> node)
+        Node** getTower() noexcept
         {
-            below = node;
+            return reinterpret_cast<Node**>(this + 1);
         }
 
-        bool isBottom()
+        Node* const* getTower() const noexcept
         {
-            return this->below == nullptr;
+            return reinterpret_cast<Node* const*>(this + 1);
         }
     };
 
-    // Ergonomics
-    using NodePtr = std::shared_ptr<Node>;
-    using NodeList = std::vector<NodePtr>;
+    // the last node before a key on each level, the bottom level first,
+    // or nullptr for the head
+    using Path = std::array<Node*, MAX_HEIGHT>;
 
-    // the root node of the list
-    NodePtr root = std::make_shared<Node>();
+    // the head's next pointers: the first node on each level
+    Node* head[MAX_HEIGHT] = {};
 
     // the number of nodes in the bottom row
     int listLength = 0;
 
-    // height of the tallest node
+    // the number of changes so far, which invalidate fingers
+    long changes = 0;
+
+    // the number of levels in use, the height of the tallest node
     int listHeight = 0;
 
     // random number generator
@@ -116,170 +166,220 @@ template <typename Key, typename Value> class SkipList
     std::mt19937 rndGen;
     std::bernoulli_distribution rndDist;
 
+    // a filter of the keys in the list, asked before searching for a key,
+    // or nullptr if there is none
+    std::unique_ptr<BloomFilter<Key>> filter;
+
     /*
-     * Increase list height by one.
-     * Grows root's tower to the new height.
+     * Refills the filter with the keys in the list, sized for twice as
+     * many, if it is stale or too small (or if force is true).
      */
-    void increaseHeight()
+    void refreshFilter(bool force = false)
     {
-        auto newRoot = std::make_shared<Node>();
-        newRoot->setBelow(this->root);
-        this->root = newRoot;
-        this->listHeight++;
+        if constexpr (IsHashable<Key>::value)
+        {
+            if (!this->filter ||
+                !(force || this->filter->needsRebuild(this->listLength)))
+            {
+                return; // RETURN: Nothing to refresh
+            }
+
+            this->filter->reset(2 * this->listLength);
+            for (Node* curNode = this->head[0]; curNode;
+                 curNode = curNode->getTower()[0])
+            {
+                this->filter->add(curNode->key);
+            }
+        }
     }
 
     /*
-     * Returns a list of nodes representing a tower
+     * Returns the next pointers of the node, or of the head for nullptr
      */
-    NodeList getTower(NodePtr startNode)
+    Node** linksOf(Node* node) noexcept
     {
-        NodeList tower;
-        auto curNode = startNode;
-        tower.push_back(curNode);
-        while (!curNode->isBottom())
-        {
-            curNode = curNode->getBelow();
-            tower.push_back(curNode);
-        }
-        return tower;
+        return node ? node->getTower() : this->head;
     }
 
+    Node* const* linksOf(const Node* node) const noexcept
+    {
+        return node ? node->getTower() : this->head;
+    }
 
     /*
-     * Return the bottom node of the current tower
+     * Returns a random height for a new node: one level, and one more
+     * for each coin toss won. The first node is given only one level, so
+     * a list of one is a single row.
      */
-    NodePtr findBottom(NodePtr startNode)
+    int randomHeight()
     {
-        return getTower(startNode).back();
+        int height = 1;
+        while (this->listLength > 0 && height < MAX_HEIGHT &&
+               this->rndDist(this->rndGen))
+        {
+            height++;
+        }
+        return height;
     }
 
-
     /*
      * Find the node with the given key.
      *
-     * Returns the path taken to find the node.
-     *
-     * If findInsert is true, return the path to the node prior to where
-     * the new node should be inserted.
+     * Walks forward on each level while the next key is not past the
+     * one searched for, then drops a level, from the top level down.
+     * Returns the node, or nullptr if the key is not in the list.
      *
-     * If findInsert is true and key already exists, path is empty.
-     * If findInsert is false and key does not exist, path is empty.
+     * The key may be of any type comparable with the keys.
      */
-    [[nodiscard]] NodeList find(const Key& findKey,
-                                bool findInsert = false) const
+    template <typename K>
+    [[nodiscard]] const Node* find(const K& findKey) const
     {
-        NodeList path;
-        NodePtr curNode = this->root;
-
-        while (curNode)
+        const Node* curNode = nullptr;
+        for (int level = this->listHeight - 1; level >= 0; level--)
         {
             // Walk forward until we reach a greater key
-            while (curNode->getNext() != nullptr &&
-                   curNode->getNext()->getKey().value() <= findKey)
+            const Node* next = linksOf(curNode)[level];
+            while (next && next->key <= findKey)
             {
-                curNode = curNode->getNext();
-                if (!findInsert)
-                {
-                    path.push_back(curNode);
-                }
+                curNode = next;
+                next = curNode->getTower()[level];
             }
 
-            // Check the current node
-            if (!curNode->isRoot())
-            {
-                if (findInsert)
-                {
-                    if (curNode->getKey().value() == findKey)
-                    {
-                        return {}; // FAIL: Key already present
-                    }
-
-                    if (curNode->isBottom())
-                    {
-                        path.push_back(curNode);
-                        return path; // SUCCESS: Found a place to insert
-                    }
-                }
-                else
-                {
-                    if (curNode->getKey().value() == findKey)
-                    {
-                        return path; // SUCCESS: Found key
-                    }
-
-                    if (curNode->isBottom())
-                    {
-                        return {}; // FAIL: Did not find key
-                    }
-                }
-            }
-            // Add to path for findInsert
-            if (findInsert)
+            if (curNode && curNode->key == findKey)
             {
-                path.push_back(curNode);
+                return curNode; // SUCCESS: Found key
             }
-
-            curNode = curNode->getBelow();
         }
 
-        return {}; // FAIL: Did not find key
+        return nullptr; // FAIL: Did not find key
     }
 
-
     /*
-     * Insert a new node with the given find path.
-     * Returns true if inserted, false otherwise.
+     * Creates a node with a random height and links it in after the
+     * path on each level of its tower, moving the path to the new node.
      */
-    void insert(Key key, Value value, NodeList& path)
+    void link(Path& path, Key key, Value value)
     {
+        int height = randomHeight();
+        Node* node =
+            Node::create(std::move(key), std::move(value), height);
+
+        Node** tower = node->getTower();
+        for (int level = 0; level < height; level++)
+        {
+            Node** prevLinks = linksOf(path[level]);
+            tower[level] = prevLinks[level];
+            prevLinks[level] = node;
+            path[level] = node;
+        }
+
+        this->listHeight = std::max(this->listHeight, height);
         this->listLength++;
-        NodePtr node = std::make_shared<Node>(key, value);
+        this->changes++;
+        addToFilter(node->key);
+    }
 
-        // First element added
-        if (this->listLength == 1)
+    /*
+     * Fills the path with the last node before the key on each level,
+     * searching from the top level down, and returns the node after it
+     * on the bottom level: the node with the key, if there is one.
+     */
+    Node* findPath(const Key& key, Path& path)
+    {
+        Node* curNode = nullptr;
+        for (int level = this->listHeight - 1; level >= 0; level--)
         {
-            this->root->setNext(node);
-            return;
+            // Walk forward until the next key is not less than the key
+            Node* next = linksOf(curNode)[level];
+            while (next && next->key < key)
+            {
+                curNode = next;
+                next = curNode->getTower()[level];
+            }
+            path[level] = curNode;
         }
+        return linksOf(curNode)[0];
+    }
 
-        // If there is no other path, set the path to root tower
-        if (path.empty())
+    /*
+     * Unlinks the node, which must come right after the path on every
+     * level of its tower, and destroys it
+     */
+    void unlink(Path& path, Node* node) noexcept
+    {
+        Node** tower = node->getTower();
+        for (int level = 0; level < node->height; level++)
         {
-            path = getTower(this->root);
+            linksOf(path[level])[level] = tower[level];
         }
 
-        // Link to the previous node in the path
-        NodePtr prev = path.back();
-        path.pop_back();
-        node->setNext(prev->getNext());
-        prev->setNext(node);
+        Node::destroy(node);
+        this->listLength--;
+        this->changes++;
+    }
 
-        // Randomly increase the height of the tree
-        int height = 0;
-        while (this->rndDist(this->rndGen))
+    /*
+     * Drops the levels left empty by removing count nodes, and tells the
+     * filter about them
+     */
+    void finishRemoval(int count)
+    {
+        while (this->listHeight > 0 && !this->head[this->listHeight - 1])
         {
-            // If we're taller than the root tower, grow the root
-            height++;
-            if (height > this->listHeight)
-            {
-                increaseHeight();
-            }
+            this->listHeight--;
+        }
 
-            // If we have no other path, link to the top of the root tower
-            if (path.empty())
+        // The keys' bits stay set in the filter until it is rebuilt
+        if constexpr (IsHashable<Key>::value)
+        {
+            if (this->filter && count > 0)
             {
-                path.push_back(this->root);
+                this->filter->recordRemoval(count);
+                refreshFilter();
             }
+        }
+    }
 
-            // Create and link a new level to the path
-            NodePtr prev = path.back();
-            path.pop_back();
+    /*
+     * Returns true if the key, which may be of any type comparable with
+     * the keys, is found in the list
+     */
+    template <typename K>
+    [[nodiscard]] bool containsKey(const K& key) const
+    {
+        if constexpr (IsHashable<Key>::value &&
+                      BloomFilter<Key>::template canQuery<K>())
+        {
+            if (this->filter)
+            {
+                if (!this->filter->mayContain(key))
+                {
+                    return false; // FAIL: Ruled out by the filter
+                }
 
-            NodePtr newNode =
-                std::make_shared<Node>(key, value, prev->getNext(), node);
+                bool found = find(key) != nullptr;
+                if (!found)
+                {
+                    this->filter->recordFalsePositive();
+                }
+                return found;
+            }
+        }
+        return find(key) != nullptr;
+    }
 
-            prev->setNext(newNode);
-            node = newNode;
+    /*
+     * Adds a key to the filter, if there is one.
+     */
+    void addToFilter(const Key& key)
+    {
+        if constexpr (IsHashable<Key>::value)
+        {
+            if (this->filter)
+            {
+                this->filter->add(key);
+                refreshFilter();
+            }
         }
     }
 
@@ -288,6 +388,23 @@ template <typename Key, typename Value> class SkipList
      * ***/
 
   public:
+    /*
+     * Where an insert left off, to start the next one from (see
+     * insertHint()). A default Finger starts from the top of the list.
+     */
+    class Finger
+    {
+      private:
+        friend class SkipList;
+
+        // the list it was left in, and its number of changes then
+        const SkipList* list = nullptr;
+        long changes = 0;
+
+        // the last node at or before the inserted key on each level
+        Path path = {};
+    };
+
     /*
      * Constructor
      */
@@ -297,6 +414,81 @@ template <typename Key, typename Value> class SkipList
         rndDist = std::bernoulli_distribution(0.5);
     }
 
+    // The list owns its nodes, so it cannot be copied
+    SkipList(const SkipList&) = delete;
+    SkipList& operator=(const SkipList&) = delete;
+
+    ~SkipList()
+    {
+        Node* curNode = this->head[0];
+        while (curNode)
+        {
+            Node* next = curNode->getTower()[0];
+            Node::destroy(curNode);
+            curNode = next;
+        }
+    }
+
+    /*
+     * Returns true if the key is found in the list
+     */
+    [[nodiscard]] bool contains(const Key& key) const
+    {
+        return containsKey(key);
+    }
+
+    /*
+     * Returns true if a key equal to one of another type, such as a
+     * std::string_view for std::string keys, is found in the list,
+     * without making a Key of it. The filter, if there is one, is only
+     * asked if it hashes the other type as it would the equal Key.
+     */
+    template <typename K,
+              typename = std::enable_if_t<IsComparableKey<K, Key>::value>>
+    [[nodiscard]] bool contains(const K& key) const
+    {
+        return containsKey(key);
+    }
+
+    /*
+     * Puts a Bloom filter of about bitsPerKey bits per key [default: 10]
+     * in front of contains(), so that most searches for missing keys
+     * return without walking the list. The filter follows insertions,
+     * and is rebuilt from the list once it is outgrown or many of its
+     * keys have been removed.
+     */
+    void enableFilter(
+        double bitsPerKey = BloomFilter<Key>::DEFAULT_BITS_PER_KEY)
+    {
+        static_assert(IsHashable<Key>::value,
+                      "Expected a key which std::hash can hash");
+
+        this->filter = std::make_unique<BloomFilter<Key>>(
+            2 * this->listLength, bitsPerKey);
+        refreshFilter(/* force */ true);
+    }
+
+    /*
+     * Removes the filter, if there is one.
+     */
+    void disableFilter() noexcept
+    {
+        this->filter.reset();
+    }
+
+    /*
+     * Returns how the filter has answered searches since it was enabled,
+     * or all zeros if there is no filter.
+     */
+    [[nodiscard]] BloomFilterStats getFilterStats() const
+    {
+        if (!this->filter)
+        {
+            return {}; // RETURN: No filter
+        }
+        return this->filter->getStats();
+    }
+
     /*
      * Returns the length of the list
      */
@@ -311,23 +503,20 @@ template <typename Key, typename Value> class SkipList
      */
     void displayList(std::ostream& out = std::cout) const
     {
-        NodePtr rootNode = this->root;
-        for (int level = this->listHeight; level >= 0; level--)
+        for (int level = this->listHeight - 1; level >= 0; level--)
         {
-            NodePtr curNode = rootNode->getNext();
+            const Node* curNode = this->head[level];
             if (curNode)
             {
                 out << "L" << level << ": ";
 
                 while (curNode)
                 {
-                    out << curNode->getKey().value() << " ";
-                    curNode = curNode->getNext();
+                    out << curNode->key << " ";
+                    curNode = curNode->getTower()[level];
                 }
                 out << "\n\n";
             }
-
-            rootNode = rootNode->getBelow();
         }
     }
 
@@ -339,62 +528,160 @@ template <typename Key, typename Value> class SkipList
      */
     bool insert(Key key, Value value)
     {
-        NodeList path;
-        NodePtr node = std::make_shared<Node>(key, value);
+        // A new finger starts from the top of the list
+        Finger finger;
+        return insertHint(finger, std::move(key), std::move(value));
+    }
+
+    /*
+     * Inserts a node into the list, searching from the finger (where the
+     * last insert through it left off) instead of from the top, and moves
+     * the finger to the new key. The search climbs from the bottom of the
+     * finger only as high as it must to pass the key, so a key just after
+     * the last one is placed in a step or two. A finger past the key, or
+     * left before another change to the list, is no help, and the search
+     * starts from the top.
+     * returns true if item inserted
+     * returns false if item not inserted (Key already in list)
+     */
+    bool insertHint(Finger& hint, Key key, Value value)
+    {
+        Path& path = hint.path;
+        if (hint.list != this || hint.changes != this->changes ||
+            (path[0] && key < path[0]->key))
+        {
+            path.fill(nullptr);
+            hint.list = this;
+        }
 
-        // Check if should go at the beginning
-        if (this->listLength == 0 ||
-            key < findBottom(this->root)->getNext()->getKey().value())
+        // Climb while the next node on the level is not past the key.
+        // Above that, the finger's nodes are still the last before it.
+        auto isBefore = [&](Node* node, int level) {
+            Node* next = linksOf(node)[level];
+            return next && next->key <= key;
+        };
+        int level = 0;
+        while (level + 1 < this->listHeight &&
+               isBefore(path[level], level))
         {
-            insert(key, value, path);
-            return true;
+            level++;
         }
 
-        // Find where the new node should go
-        path = find(key, true);
+        // Walk forward and down from there, as find() does
+        Node* curNode = path[level];
+        for (; level >= 0; level--)
+        {
+            while (isBefore(curNode, level))
+            {
+                curNode = curNode ? curNode->getTower()[level]
+                                  : this->head[level];
+            }
+            path[level] = curNode;
+        }
 
-        if (path.empty())
+        if (curNode && curNode->key == key)
         {
+            hint.changes = this->changes;
             return false; // FAIL: key already exists
         }
 
-        // Insert node
-        insert(key, value, path);
-        return true;
+        link(path, std::move(key), std::move(value));
+        hint.changes = this->changes;
+        return true; // SUCCESS: node added
     }
 
     /*
-     * Removes the nodes if it contains the given item
+     * Inserts every (key, value) pair of the run, in order, each one
+     * searched for from the last (see insertHint()). The run should be
+     * sorted by key, or nearly so.
+     * returns the number of items inserted
+     */
+    template <typename Range> int insertSortedRun(const Range& run)
+    {
+        int inserted = 0;
+        Finger finger;
+        for (const auto& [key, value] : run)
+        {
+            inserted += insertHint(finger, key, value);
+        }
+        return inserted;
+    }
+
+    /*
+     * Removes the nodes if it contains the given item. The search for the
+     * node from the top level down leaves the last node before it on
+     * every level, so the node is unlinked from its whole tower without
+     * walking any level again.
      */
     void remove(const Key& key)
     {
-        // For every level, look for the key and remove it
-        for (const auto& level : getTower(this->root))
+        Path path;
+        Node* node = findPath(key, path);
+        if (!node || !(node->key == key))
         {
-            NodePtr prev = level;
-            NodePtr curNode = level->getNext();
+            return; // FAIL: key not found
+        }
 
-            // Walk through the level until we reach a key equal or larger
-            // than the one we are looking for
-            while (curNode && curNode->getKey().value() <= key)
+        unlink(path, node);
+        finishRemoval(1);
+    }
+
+    /*
+     * Removes every node for which pred(key, value) is true, in one pass
+     * along the bottom row, keeping the last node kept on each level to
+     * unlink the removed nodes' towers from
+     * returns the number of items removed
+     */
+    template <typename Predicate> int removeIf(Predicate pred)
+    {
+        Path path = {};
+        int removed = 0;
+        Node* curNode = this->head[0];
+        while (curNode)
+        {
+            Node* next = curNode->getTower()[0];
+            if (pred(std::as_const(curNode->key),
+                     std::as_const(curNode->value)))
+            {
+                unlink(path, curNode);
+                removed++;
+            }
+            else
             {
-                // If we found the key, unlink it
-                if (curNode->getKey().value() == key)
+                for (int level = 0; level < curNode->height; level++)
                 {
-                    prev->setNext(curNode->getNext());
-
-                    // The list length only counts bottom level nodes
-                    if (curNode->isBottom())
-                    {
-                        this->listLength--;
-                    }
-                    break;
+                    path[level] = curNode;
                 }
-
-                // Keep walking
-                prev = curNode;
-                curNode = curNode->getNext();
             }
+            curNode = next;
         }
+
+        finishRemoval(removed);
+        return removed;
+    }
+
+    /*
+     * Removes every node with a key from lo to hi, inclusive: one search
+     * for lo, then a walk along the bottom row to past hi
+     * returns the number of items removed
+     */
+    int removeRange(const Key& lo, const Key& hi)
+    {
+        Path path;
+        Node* curNode = findPath(lo, path);
+        int removed = 0;
+
+        // Each node in the range comes right after the path on every
+        // level, since those before it are already gone
+        while (curNode && !(hi < curNode->key))
+        {
+            Node* next = curNode->getTower()[0];
+            unlink(path, curNode);
+            removed++;
+            curNode = next;
+        }
+
+        finishRemoval(removed);
+        return removed;
     }
 };
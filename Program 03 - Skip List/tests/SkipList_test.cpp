@@ -12,9 +12,15 @@
 
 #include "SkipList.h"
 
+#include <algorithm>
+#include <iterator>
 #include <iostream>
+#include <numeric>
+#include <random>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
@@ -61,4 +67,298 @@ SCENARIO("Create an single-item Skip List")
             }
         }
     }
-}
\ No newline at end of file
+}
+
+SCENARIO("Filter searches for missing keys")
+{
+    GIVEN("A Skip List with the even keys 2-2000 and a filter")
+    {
+        std::vector<int> keys(1000);
+        std::iota(keys.begin(), keys.end(), 1);
+        std::shuffle(keys.begin(), keys.end(),
+                     std::mt19937{std::random_device{}()});
+
+        SkipList<int, int> list;
+        for (int n : keys)
+        {
+            list.insert(n * 2, n);
+        }
+        list.enableFilter();
+
+        THEN("Every key is found, and most missing keys are rejected")
+        {
+            for (int n = 1; n <= 2000; n++)
+            {
+                REQUIRE(list.contains(n) == (n % 2 == 0));
+            }
+
+            auto stats = list.getFilterStats();
+            REQUIRE(stats.queries == 2000);
+            REQUIRE(stats.rejected + stats.falsePositives == 1000);
+            REQUIRE(stats.falsePositiveRate() < 0.05);
+        }
+
+        WHEN("Keys are inserted and removed")
+        {
+            for (int n = 2001; n <= 4000; n += 2)
+            {
+                list.insert(n, n);
+            }
+            for (int n = 2; n <= 2000; n += 2)
+            {
+                list.remove(n);
+            }
+
+            THEN("The filter follows the list")
+            {
+                for (int n = 1; n <= 4000; n++)
+                {
+                    REQUIRE(list.contains(n) == (n > 2000 && n % 2 == 1));
+                }
+                REQUIRE(list.getFilterStats().falsePositives < 1000 / 4);
+            }
+        }
+
+        WHEN("The filter is disabled")
+        {
+            list.disableFilter();
+
+            THEN("Searches no longer go through it")
+            {
+                REQUIRE(list.contains(2));
+                REQUIRE_FALSE(list.contains(3));
+                REQUIRE(list.getFilterStats().queries == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("Insert sorted runs from a finger")
+{
+    GIVEN("A Skip List holding the keys 1000-1099")
+    {
+        SkipList<int, int> list;
+        for (int n = 1000; n < 1100; n++)
+        {
+            list.insert(n, n);
+        }
+
+        WHEN("A sorted run with some keys already present is inserted")
+        {
+            std::vector<std::pair<int, int>> run;
+            for (int n = 1; n <= 3000; n += 2)
+            {
+                run.emplace_back(n, n);
+            }
+            int inserted = list.insertSortedRun(run);
+
+            THEN("Only the new keys are inserted, in order")
+            {
+                REQUIRE(inserted == 1500 - 50);
+                REQUIRE(list.getLength() == 100 + 1450);
+                for (int n = 1; n <= 3000; n++)
+                {
+                    bool inList = (n % 2 == 1) || (n >= 1000 && n < 1100);
+                    REQUIRE(list.contains(n) == inList);
+                }
+
+                std::stringstream result;
+                list.displayList(result);
+                std::string bottom = result.str();
+                bottom = bottom.substr(bottom.rfind("L0: ") + 4);
+                std::istringstream keys(bottom);
+                std::vector<int> listed{std::istream_iterator<int>(keys),
+                                        std::istream_iterator<int>()};
+                REQUIRE(listed.size() == 1550);
+                REQUIRE(std::is_sorted(listed.begin(), listed.end()));
+            }
+        }
+
+        WHEN("Keys are inserted through one finger out of order, and "
+             "around a removal")
+        {
+            SkipList<int, int>::Finger finger;
+            REQUIRE(list.insertHint(finger, 2000, 0));
+            REQUIRE(list.insertHint(finger, 2001, 0));
+            REQUIRE(list.insertHint(finger, 5, 0));
+            REQUIRE_FALSE(list.insertHint(finger, 1050, 0));
+            list.remove(1051);
+            REQUIRE(list.insertHint(finger, 1051, 0));
+            REQUIRE(list.insertHint(finger, 1200, 0));
+
+            THEN("Each key lands in its place")
+            {
+                REQUIRE(list.getLength() == 100 + 4);
+                for (int n : {5, 1050, 1051, 1200, 2000, 2001})
+                {
+                    REQUIRE(list.contains(n));
+                }
+                REQUIRE_FALSE(list.contains(6));
+            }
+        }
+    }
+}
+
+SCENARIO("Search a string-keyed Skip List without making strings")
+{
+    GIVEN("A Skip List keyed by names, with a filter")
+    {
+        SkipList<std::string, int> list;
+        for (int n = 0; n < 200; n++)
+        {
+            list.insert("computer scientist " + std::to_string(n), n);
+        }
+        list.enableFilter();
+
+        THEN("Names are found by std::string_view and const char*")
+        {
+            std::string text = "computer scientist 42 computer scientist";
+            REQUIRE(list.contains(std::string_view(text).substr(0, 21)));
+            REQUIRE_FALSE(list.contains(std::string_view(text)));
+            REQUIRE(list.contains("computer scientist 199"));
+            REQUIRE_FALSE(list.contains("computer scientist 200"));
+
+            // Every query went through the filter
+            REQUIRE(list.getFilterStats().queries == 4);
+        }
+    }
+}
+
+SCENARIO("Remove many keys at once")
+{
+    GIVEN("A Skip List holding the keys 1-1000 and a filter")
+    {
+        std::vector<int> keys(1000);
+        std::iota(keys.begin(), keys.end(), 1);
+        std::shuffle(keys.begin(), keys.end(),
+                     std::mt19937{std::random_device{}()});
+
+        SkipList<int, int> list;
+        for (int n : keys)
+        {
+            list.insert(n, -n);
+        }
+        list.enableFilter();
+
+        WHEN("The multiples of 10 are removed")
+        {
+            int removed = list.removeIf([](int key, int value) {
+                return key % 10 == 0 && value == -key;
+            });
+
+            THEN("Only they are gone")
+            {
+                REQUIRE(removed == 100);
+                REQUIRE(list.getLength() == 900);
+                for (int n = 1; n <= 1000; n++)
+                {
+                    REQUIRE(list.contains(n) == (n % 10 != 0));
+                }
+            }
+        }
+
+        WHEN("A range of keys is removed")
+        {
+            REQUIRE(list.removeRange(250, 749) == 500);
+            REQUIRE(list.removeRange(2000, 3000) == 0);
+
+            THEN("Only the keys in the range are gone")
+            {
+                REQUIRE(list.getLength() == 500);
+                for (int n = 1; n <= 1000; n++)
+                {
+                    REQUIRE(list.contains(n) == (n < 250 || n > 749));
+                }
+            }
+
+            AND_WHEN("The keys are inserted again")
+            {
+                for (int n = 250; n <= 749; n++)
+                {
+                    list.insert(n, -n);
+                }
+
+                THEN("Every key is found")
+                {
+                    REQUIRE(list.getLength() == 1000);
+                    for (int n = 1; n <= 1000; n++)
+                    {
+                        REQUIRE(list.contains(n));
+                    }
+                }
+            }
+        }
+
+        WHEN("Every key is removed, one at a time")
+        {
+            for (int n : keys)
+            {
+                list.remove(n);
+            }
+            list.remove(1);
+
+            THEN("The list is empty")
+            {
+                REQUIRE(list.getLength() == 0);
+                REQUIRE_FALSE(list.contains(1));
+
+                std::stringstream result;
+                list.displayList(result);
+                REQUIRE(result.str().empty());
+            }
+        }
+    }
+}
+
+// A key which can be ordered and compared, but which std::hash cannot hash
+struct UnhashableKey
+{
+    int n = 0;
+
+    bool operator<(const UnhashableKey& rhs) const
+    {
+        return n < rhs.n;
+    }
+
+    bool operator<=(const UnhashableKey& rhs) const
+    {
+        return n <= rhs.n;
+    }
+
+    bool operator==(const UnhashableKey& rhs) const
+    {
+        return n == rhs.n;
+    }
+};
+
+SCENARIO("Keep a Skip List whose keys cannot be hashed")
+{
+    GIVEN("A Skip List keyed by a type without std::hash")
+    {
+        SkipList<UnhashableKey, int> list;
+        for (int n = 1; n <= 100; n++)
+        {
+            list.insert(UnhashableKey{n}, -n);
+        }
+
+        WHEN("Keys are removed one at a time, by a test and by range")
+        {
+            list.remove(UnhashableKey{1});
+            int removedOdd = list.removeIf(
+                [](const UnhashableKey& key, int) { return key.n % 2; });
+            int removedRange =
+                list.removeRange(UnhashableKey{10}, UnhashableKey{19});
+
+            THEN("Only those keys are gone, with no filter asked")
+            {
+                REQUIRE(removedOdd == 49);
+                REQUIRE(removedRange == 5);
+                REQUIRE(list.getLength() == 45);
+                REQUIRE_FALSE(list.contains(UnhashableKey{1}));
+                REQUIRE_FALSE(list.contains(UnhashableKey{12}));
+                REQUIRE(list.contains(UnhashableKey{20}));
+                REQUIRE(list.getFilterStats().queries == 0);
+            }
+        }
+    }
+}